@@ -57,6 +57,7 @@ HEADERS += \
  include/midi_control_helpers.hpp \
  include/midi_control_unit_test.hpp \
  include/optionsfile.hpp \
+ include/playback_unit_test.hpp \
  include/qtcore_task.hpp \
  include/qtestframe.hpp \
  include/unit_tests.hpp \
@@ -69,6 +70,7 @@ SOURCES += \
  src/midi_control_helpers.cpp \
  src/midi_control_unit_test.cpp \
  src/optionsfile.cpp \
+ src/playback_unit_test.cpp \
  src/qtcore_task.cpp \
  src/qtestframe.cpp \
  src/seqtool.cpp \
@@ -0,0 +1,73 @@
+#if ! defined SEQ66_PLAYBACK_BENCH_HPP
+#define SEQ66_PLAYBACK_BENCH_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playback_bench.hpp
+ * \library       Seqtool (from the Seq66 project)
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \version       $Revision$
+ * \license       $XPC_SUITE_GPL_LICENSE$
+ *
+ *    This module provides a synthetic benchmark of the playback engine for
+ *    the seqbench application.
+ */
+
+#include <string>
+
+namespace seq66
+{
+
+/**
+ *  The shape of the synthetic song played by the benchmark.  Parsed from
+ *  the "sets:patterns:notes[:measures[:length]]" argument of seqbench.
+ */
+
+struct benchspec
+{
+    int bs_sets;                /**< Number of screensets to fill.          */
+    int bs_patterns;            /**< Number of patterns in each set.        */
+    int bs_notes;               /**< Notes in each pattern, evenly spaced.  */
+    int bs_measures;            /**< Length of each pattern in measures.    */
+    int bs_length;              /**< Measures played for each set.          */
+    long bs_cycle_us;           /**< Virtual time advanced per play().      */
+};
+
+extern bool parse_bench_spec (const std::string & spec, benchspec & bs);
+extern bool playback_benchmark (const benchspec & bs);
+
+/**
+ *  Provided by the program that links the benchmark.  It returns the number
+ *  of calls made to the global operator new so far.
+ */
+
+extern long allocation_count ();
+
+}           // namespace seq66
+
+#endif      // SEQ66_PLAYBACK_BENCH_HPP
+
+/*
+ * playback_bench.hpp
+ *
+ * vim: ts=4 sw=4 et ft=cpp
+ */
@@ -0,0 +1,283 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playback_bench.cpp
+ * \library       Seqtool (from the Seq66 project)
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \version       $Revision$
+ * \license       $XPC_SUITE_GPL_LICENSE$
+ *
+ *    This module measures the playback engine.  It builds a performer
+ *    holding a synthetic song, then calls performer::play() over a virtual
+ *    timeline, as fast as it can, with a midicapture object attached to
+ *    the master buss in place of real output ports (the "null buss").  The
+ *    events are counted and thrown away.  Each set is played in turn, once
+ *    to warm up the containers, and once for the measurement.
+ *
+ *    The result is one line of JSON on standard output, so that a script
+ *    can compare the numbers between releases:
+ *
+\verbatim
+    {"benchmark":"playback","version":"0.91.0","sets":4,"patterns":32,
+     "notes":64,"measures":1,"length":16,"ppqn":192,"cycle_us":1000,
+     "ticks":49152,"cycles":128000,"events":262144,"seconds":0.141290,
+     "events_per_sec":1855361.8,"ns_per_tick":2874.6,
+     "allocs_per_tick":0.000}
+\endverbatim
+ *
+ *    (Shown on several lines here; the real output is a single line.)
+ *
+ *    This module is linked only into the seqbench program, which replaces
+ *    the global operator new in order to count allocations; see
+ *    seqbench.cpp.  The seqtool program is left with the default
+ *    allocator.  Any allocation during the measured passes is a
+ *    regression, since the output thread must not allocate.
+ */
+
+#include <chrono>                       /* std::chrono::steady_clock        */
+#include <cstdio>                       /* std::snprintf()                  */
+#include <iostream>                     /* std::cout                        */
+
+#include "cfg/settings.hpp"             /* seq66::rc() configuration object */
+#include "midi/mastermidibus.hpp"       /* seq66::mastermidibus             */
+#include "midi/midicapture.hpp"         /* seq66::midicapture null buss     */
+#include "play/performer.hpp"           /* seq66::performer                 */
+#include "playback_bench.hpp"           /* seq66::benchspec, etc.           */
+#include "seq66_features.hpp"           /* seq66::seq_version()             */
+#include "util/calculations.hpp"        /* seq66::delta_time_us_to_ticks()  */
+#include "util/strfunctions.hpp"        /* seq66::tokenize(), etc.          */
+
+namespace seq66
+{
+
+/**
+ *  Parses the benchmark option.
+ *
+ * \param spec
+ *      Provides "sets:patterns:notes", optionally followed by ":measures"
+ *      (the pattern length, default 1) and ":length" (the measures played
+ *      for each set, default 16).
+ *
+ * \param [out] bs
+ *      Receives the values.
+ *
+ * \return
+ *      Returns false if a value is missing or not positive.
+ */
+
+bool
+parse_bench_spec (const std::string & spec, benchspec & bs)
+{
+    std::vector<std::string> tokens = tokenize(spec, ":");
+    int count = int(tokens.size());
+    bool result = count >= 3 && count <= 5;
+    if (result)
+    {
+        bs.bs_sets = string_to_int(tokens[0]);
+        bs.bs_patterns = string_to_int(tokens[1]);
+        bs.bs_notes = string_to_int(tokens[2]);
+        bs.bs_measures = count > 3 ? string_to_int(tokens[3]) : 1 ;
+        bs.bs_length = count > 4 ? string_to_int(tokens[4]) : 16 ;
+        bs.bs_cycle_us = 1000;
+        result =
+            bs.bs_sets > 0 && bs.bs_patterns > 0 && bs.bs_notes > 0 &&
+            bs.bs_measures > 0 && bs.bs_length > 0;
+    }
+    return result;
+}
+
+/**
+ *  Fills the sets with patterns of evenly-spaced notes.  Each pattern plays
+ *  on its own channel and on one of 16 busses.
+ */
+
+static bool
+build_song (performer & p, const benchspec & bs, int patterns)
+{
+    int setsize = p.screenset_size();
+    midipulse patlen = midipulse(bs.bs_measures) * p.ppqn() * 4;
+    midipulse spacing = patlen / bs.bs_notes;
+    if (spacing < 1)
+        spacing = 1;
+
+    midipulse notelen = spacing > 1 ? spacing / 2 : 1 ;
+    for (int s = 0; s < bs.bs_sets; ++s)
+    {
+        for (int pat = 0; pat < patterns; ++pat)
+        {
+            seq::number seqno = s * setsize + pat;
+            if (! p.new_sequence(seqno))
+                return false;
+
+            seq::pointer sp = p.get_sequence(seqno);
+            if (! sp)
+                return false;
+
+            (void) sp->set_length(patlen);
+            sp->set_midi_bus(char(pat % 16));
+            sp->set_midi_channel(midibyte(pat % 16));
+            for (int n = 0; n < bs.bs_notes; ++n)
+            {
+                midipulse tick = (n * spacing) % patlen;
+                int note = 36 + (n + pat) % 48;
+                (void) sp->add_note(tick, notelen, note);
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ *  Makes a set the playing set and arms all of its patterns.  Changing the
+ *  playing set applies the saved mute state, so the arming must be done
+ *  afterward.
+ */
+
+static void
+play_set (performer & p, int setno, int patterns)
+{
+    int setsize = p.screenset_size();
+    (void) p.set_playing_screenset(setno);
+    for (int pat = 0; pat < patterns; ++pat)
+    {
+        seq::pointer sp = p.get_sequence(setno * setsize + pat);
+        if (sp)
+            (void) sp->set_playing(true);
+    }
+    p.fill_play_set();
+    p.set_orig_ticks(0);
+}
+
+/**
+ *  Runs the benchmark and writes the results.
+ *
+ * \param bs
+ *      Provides the shape of the song.
+ *
+ * \return
+ *      Returns false if the performer could not be set up.
+ */
+
+bool
+playback_benchmark (const benchspec & bs)
+{
+    rc().loopback_ports(0, 1);          /* no ALSA or JACK server needed    */
+
+    performer p;
+    if (! p.create_master_bus())
+    {
+        errprint("benchmark: cannot create the master buss");
+        return false;
+    }
+
+    int patterns = bs.bs_patterns;
+    if (patterns > p.screenset_size())
+    {
+        patterns = p.screenset_size();
+        warnprintf("benchmark: patterns limited to %d per set", patterns);
+    }
+    if (! build_song(p, bs, patterns))
+    {
+        errprint("benchmark: cannot create the patterns");
+        return false;
+    }
+
+    int ppqn = p.ppqn();
+    double step = delta_time_us_to_ticks(bs.bs_cycle_us, p.bpm(), ppqn);
+    midipulse endtick = midipulse(bs.bs_length) * ppqn * 4;
+    mastermidibus * mmb = p.master_bus();
+    midicapture cap;
+    long events = 0;
+    long cycles = 0;
+    long allocations = 0;
+    long long nanoseconds = 0;
+    midipulse ticks = 0;
+    mmb->capture(&cap);
+    for (int pass = 0; pass < 2; ++pass)        /* pass 0 is the warm-up    */
+    {
+        bool measure = pass > 0;
+        for (int s = 0; s < bs.bs_sets; ++s)
+        {
+            play_set(p, s, patterns);
+
+            long passevents = 0;
+            long passcycles = 0;
+            long allocs = allocation_count();
+            auto start = std::chrono::steady_clock::now();
+            for (double tick = 0.0; tick < double(endtick); tick += step)
+            {
+                midipulse t = midipulse(tick);
+                mmb->capture_tick(t);
+                p.play(t);
+                passevents += cap.count();
+                cap.clear();
+                ++passcycles;
+            }
+            auto finish = std::chrono::steady_clock::now();
+            allocs = allocation_count() - allocs;
+            p.all_notes_off();
+            cap.clear();
+            if (measure)
+            {
+                nanoseconds += std::chrono::duration_cast
+                <
+                    std::chrono::nanoseconds
+                >(finish - start).count();
+                events += passevents;
+                cycles += passcycles;
+                allocations += allocs;
+                ticks += endtick;
+            }
+        }
+    }
+    mmb->capture(nullptr);
+
+    double seconds = double(nanoseconds) / 1.0e9;
+    double eventrate = seconds > 0.0 ? double(events) / seconds : 0.0 ;
+    double nspertick = ticks > 0 ? double(nanoseconds) / double(ticks) : 0.0 ;
+    double allocspertick = ticks > 0 ?
+        double(allocations) / double(ticks) : 0.0 ;
+
+    char temp[512];
+    (void) std::snprintf
+    (
+        temp, sizeof temp,
+        "{\"benchmark\":\"playback\",\"version\":\"%s\","
+        "\"sets\":%d,\"patterns\":%d,\"notes\":%d,\"measures\":%d,"
+        "\"length\":%d,\"ppqn\":%d,\"cycle_us\":%ld,\"ticks\":%ld,"
+        "\"cycles\":%ld,\"events\":%ld,\"seconds\":%.6f,"
+        "\"events_per_sec\":%.1f,\"ns_per_tick\":%.1f,"
+        "\"allocs_per_tick\":%.3f}",
+        seq_version().c_str(), bs.bs_sets, patterns, bs.bs_notes,
+        bs.bs_measures, bs.bs_length, ppqn, bs.bs_cycle_us, long(ticks),
+        cycles, events, seconds, eventrate, nspertick, allocspertick
+    );
+    std::cout << temp << std::endl;
+    return true;
+}
+
+}           // namespace seq66
+
+/*
+ * playback_bench.cpp
+ *
+ * vim: ts=4 sw=4 et ft=cpp
+ */
@@ -0,0 +1,906 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playback_unit_test.cpp
+ * \library       Seqtool (from the Seq66 project)
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \version       $Revision$
+ * \license       $XPC_SUITE_GPL_LICENSE$
+ *
+ *    This application provides unit tests for the playback modules of the
+ *    libseq66 and seq_rtmidi libraries.  None of them needs a MIDI port.
+ *
+ * Unit Test Groups:
+ *
+ *       1.  seq66::eventscheduler
+ *           1.  Ordering
+ *           2.  Cancellation
+ *       2.  seq66::tempomap
+ *           1.  Tick/time conversion
+ *       3.  seq66::activenotes
+ *           1.  Set, clear, and all-off
+ *       4.  seq66::outqueue
+ *           1.  Full, empty, and wrap
+ *       5.  seq66::playsnapshot
+ *           1.  Hazard swap
+ *       6.  seq66::midi_queue
+ *           1.  Single-producer, single-consumer ring
+ *       7.  seq66::rtthread
+ *           1.  parse_cpu_list()
+ */
+
+#include <cmath>                        /* std::fabs()                      */
+#include <iostream>
+
+#include "seq66-config.h"               /* SEQ66_SEQTOOL_TESTING_SUPPORT    */
+#include "midi/activenotes.hpp"         /* seq66::activenotes               */
+#include "midi/event.hpp"               /* seq66::event                     */
+#include "midi/eventscheduler.hpp"      /* seq66::eventscheduler            */
+#include "midi/outqueue.hpp"            /* seq66::outqueue                  */
+#include "midi/tempomap.hpp"            /* seq66::tempomap                  */
+#include "os/rtthread.hpp"              /* seq66::parse_cpu_list()          */
+#include "play/playsnapshot.hpp"        /* seq66::playsnapshot              */
+
+#if defined SEQ66_RTMIDI_SUPPORT
+#include "rtmidi_types.hpp"             /* seq66::midi_queue                */
+#endif
+
+#if defined SEQ66_SEQTOOL_TESTING_SUPPORT
+
+#include "playback_unit_test.hpp"
+
+/**
+ *  Compares two floating values, such as microseconds or pulses, allowing
+ *  for rounding.
+ */
+
+static bool
+near_value (double a, double b, double tolerance = 0.01)
+{
+    return std::fabs(a - b) <= tolerance;
+}
+
+/**
+ *  Makes a Note On or Note Off for the scheduler and queue tests.
+ */
+
+static seq66::event
+note_event (seq66::midibyte status, seq66::midibyte note)
+{
+    return seq66::event(0, status, note, 100);
+}
+
+/**
+ *
+ * \group 1. seq66::eventscheduler
+ *
+ * \case
+ *    1. Ordering
+ *
+ * \tests
+ *    -  eventscheduler::push()
+ *    -  eventscheduler::pop_due()
+ *    -  eventscheduler::next_deadline()
+ *
+ * \param options
+ *    Provides the command-line options for the unit-test application.
+ *
+ * \return
+ *    Returns the unit-test status object needed by the protocol.
+ */
+
+xpc::cut_status
+playback_unit_test_01_01 (const xpc::cut_options & options)
+{
+    xpc::cut_status status
+    (
+        options, 1, 1, "seq66::eventscheduler", T_("Ordering")
+    );
+    bool ok = status.valid();                   /* invalidity not an error  */
+    if (ok)
+    {
+        if (! status.can_proceed())             /* is test allowed to run?  */
+        {
+            status.pass();                      /* no, force it to pass     */
+        }
+        else
+        {
+            if (status.next_subtest("Deadline order"))
+            {
+                seq66::eventscheduler sched;
+                seq66::schedslot slot;
+                sched.push(300, 0, 0, note_event(seq66::EVENT_NOTE_ON, 60));
+                sched.push(100, 0, 0, note_event(seq66::EVENT_NOTE_ON, 61));
+                sched.push(200, 0, 0, note_event(seq66::EVENT_NOTE_ON, 62));
+                sched.push(100, 0, 0, note_event(seq66::EVENT_NOTE_ON, 63));
+                ok = sched.count() == 4 && sched.next_deadline() == 100;
+                if (ok && status.next_subtest("Nothing due yet"))
+                    ok = ! sched.pop_due(50, slot);
+
+                if (ok && status.next_subtest("Equal deadlines in order"))
+                {
+                    ok = sched.pop_due(150, slot) && slot.ss_d0 == 61;
+                    if (ok)
+                        ok = sched.pop_due(150, slot) && slot.ss_d0 == 63;
+
+                    if (ok)
+                        ok = ! sched.pop_due(150, slot);
+                }
+                if (ok && status.next_subtest("Remaining events"))
+                {
+                    ok = sched.pop_due(1000, slot) && slot.ss_d0 == 62;
+                    if (ok)
+                        ok = sched.pop_due(1000, slot) && slot.ss_d0 == 60;
+
+                    if (ok)
+                        ok = sched.empty() && sched.next_deadline() == 0;
+                }
+                if (ok && status.next_subtest("Deadline of a pulse"))
+                {
+                    sched.set_origin(96.0, 1000000, 120.0, 192);
+                    ok = sched.deadline(96) == 1000000;
+                    if (ok)
+                        ok = near_value(sched.deadline(288), 1500000.0, 1.0);
+                }
+                if (! ok)
+                    errprint("eventscheduler ordering failed");
+
+                status.pass(ok);
+            }
+        }
+    }
+    return status;
+}
+
+/**
+ *
+ * \group 1. seq66::eventscheduler
+ *
+ * \case
+ *    2. Cancellation
+ *
+ * \tests
+ *    -  eventscheduler::cancel_note_on()
+ *    -  eventscheduler::cancel_note_ons()
+ *
+ * \param options
+ *    Provides the command-line options for the unit-test application.
+ *
+ * \return
+ *    Returns the unit-test status object needed by the protocol.
+ */
+
+xpc::cut_status
+playback_unit_test_01_02 (const xpc::cut_options & options)
+{
+    xpc::cut_status status
+    (
+        options, 1, 2, "seq66::eventscheduler", T_("Cancellation")
+    );
+    bool ok = status.valid();                   /* invalidity not an error  */
+    if (ok)
+    {
+        if (! status.can_proceed())             /* is test allowed to run?  */
+        {
+            status.pass();                      /* no, force it to pass     */
+        }
+        else
+        {
+            if (status.next_subtest("Cancel one note"))
+            {
+                seq66::eventscheduler sched;
+                seq66::schedslot slot;
+                sched.push(100, 0, 0, note_event(seq66::EVENT_NOTE_ON, 60));
+                sched.push(100, 1, 0, note_event(seq66::EVENT_NOTE_ON, 60));
+                sched.push(100, 0, 1, note_event(seq66::EVENT_NOTE_ON, 60));
+                sched.push(150, 0, 0, note_event(seq66::EVENT_NOTE_ON, 61));
+                sched.push(200, 0, 0, note_event(seq66::EVENT_NOTE_OFF, 60));
+                ok = sched.cancel_note_on(0, 0, 60) == 1;
+                if (ok)
+                    ok = sched.count() == 4;
+
+                if (ok && status.next_subtest("Heap order kept"))
+                {
+                    ok = sched.next_deadline() == 100;
+                    if (ok)
+                        ok = sched.cancel_note_on(0, 0, 60) == 0;
+                }
+                if (ok && status.next_subtest("Cancel all Note Ons"))
+                {
+                    ok = sched.cancel_note_ons() == 3;
+                    if (ok)
+                        ok = sched.count() == 1 && sched.pop(slot);
+
+                    if (ok)
+                        ok = slot.ss_status == seq66::EVENT_NOTE_OFF;
+                }
+                if (ok && status.next_subtest("Clear"))
+                {
+                    sched.push(100, 0, 0, note_event(seq66::EVENT_NOTE_ON, 60));
+                    sched.clear();
+                    ok = sched.empty() && ! sched.pop(slot);
+                }
+                if (! ok)
+                    errprint("eventscheduler cancellation failed");
+
+                status.pass(ok);
+            }
+        }
+    }
+    return status;
+}
+
+/**
+ *
+ * \group 1. seq66::eventscheduler
+ *
+ * \case
+ *    3. Fixed capacity
+ *
+ *    In engine mode the scheduler must not allocate, so a full scheduler
+ *    drops the new events and counts them.
+ *
+ * \tests
+ *    -  eventscheduler::fixed_capacity()
+ *    -  eventscheduler::take_dropped()
+ *
+ * \param options
+ *    Provides the command-line options for the unit-test application.
+ *
+ * \return
+ *    Returns the unit-test status object needed by the protocol.
+ */
+
+xpc::cut_status
+playback_unit_test_01_03 (const xpc::cut_options & options)
+{
+    xpc::cut_status status
+    (
+        options, 1, 3, "seq66::eventscheduler", T_("Fixed capacity")
+    );
+    bool ok = status.valid();                   /* invalidity not an error  */
+    if (ok)
+    {
+        if (! status.can_proceed())             /* is test allowed to run?  */
+        {
+            status.pass();                      /* no, force it to pass     */
+        }
+        else
+        {
+            if (status.next_subtest("Drop when full"))
+            {
+                seq66::eventscheduler sched;
+                seq66::event e = note_event(seq66::EVENT_NOTE_ON, 60);
+                int extra = 10;
+                int reserved = 0;
+                sched.fixed_capacity(true);
+                for (long d = 0; sched.take_dropped() == 0; ++d)
+                {
+                    reserved = sched.count();
+                    sched.push(d, 0, 0, e);
+                }
+                for (int i = 0; i < extra; ++i)
+                    sched.push(0, 0, 0, e);
+
+                ok = reserved > 0 && sched.count() == reserved;
+                if (ok)
+                    ok = sched.take_dropped() == extra;
+
+                if (ok && status.next_subtest("Count restarts"))
+                    ok = sched.take_dropped() == 0;
+
+                if (ok && status.next_subtest("Grow when not fixed"))
+                {
+                    sched.fixed_capacity(false);
+                    sched.push(0, 0, 0, e);
+                    ok = sched.count() == reserved + 1;
+                    if (ok)
+                        ok = sched.take_dropped() == 0;
+                }
+                if (! ok)
+                    errprint("eventscheduler fixed capacity failed");
+
+                status.pass(ok);
+            }
+        }
+    }
+    return status;
+}
+
+/**
+ *
+ * \group 2. seq66::tempomap
+ *
+ * \case
+ *    1. Tick/time conversion
+ *
+ *    The map starts at 120 BPM, drops to 60 BPM at pulse 768 (4 beats at
+ *    192 PPQN, or 2 seconds), and rises to 240 BPM at pulse 1152 (4
+ *    seconds).
+ *
+ * \tests
+ *    -  tempomap::rebuild()
+ *    -  tempomap::tick_to_us()
+ *    -  tempomap::us_to_tick()
+ *    -  tempomap::advance()
+ *
+ * \param options
+ *    Provides the command-line options for the unit-test application.
+ *
+ * \return
+ *    Returns the unit-test status object needed by the protocol.
+ */
+
+xpc::cut_status
+playback_unit_test_02_01 (const xpc::cut_options & options)
+{
+    xpc::cut_status status
+    (
+        options, 2, 1, "seq66::tempomap", T_("Tick/time conversion")
+    );
+    bool ok = status.valid();                   /* invalidity not an error  */
+    if (ok)
+    {
+        if (! status.can_proceed())             /* is test allowed to run?  */
+        {
+            status.pass();                      /* no, force it to pass     */
+        }
+        else
+        {
+            if (status.next_subtest("Constant tempo"))
+            {
+                seq66::tempomap tm;
+                tm.clear(120.0, 192);
+                ok = ! tm.active() && tm.count() == 1;
+                if (ok)
+                    ok = near_value(tm.tick_to_us(192.0), 500000.0);
+
+                if (ok && status.next_subtest("Segments"))
+                {
+                    seq66::tempomap::changes list;
+                    seq66::tempochange tc;
+                    tc.tc_tick = 1152;                  /* out of order     */
+                    tc.tc_bpm = 240.0;
+                    list.push_back(tc);
+                    tc.tc_tick = 768;
+                    tc.tc_bpm = 60.0;
+                    list.push_back(tc);
+                    tm.rebuild(120.0, 192, list);
+                    ok = tm.active() && tm.count() == 3;
+                    if (ok)
+                        ok = tm.bpm_at(700.0) == 120.0 &&
+                            tm.bpm_at(1000.0) == 60.0 &&
+                            tm.bpm_at(2000.0) == 240.0;
+                }
+                if (ok && status.next_subtest("Tick to time"))
+                {
+                    ok = near_value(tm.tick_to_us(768.0), 2000000.0) &&
+                        near_value(tm.tick_to_us(960.0), 3000000.0) &&
+                        near_value(tm.tick_to_us(1152.0), 4000000.0) &&
+                        near_value(tm.tick_to_us(1344.0), 4250000.0);
+                }
+                if (ok && status.next_subtest("Time to tick"))
+                {
+                    ok = near_value(tm.us_to_tick(1000000.0), 384.0) &&
+                        near_value(tm.us_to_tick(3000000.0), 960.0) &&
+                        near_value(tm.us_to_tick(4250000.0), 1344.0);
+                }
+                if (ok && status.next_subtest("Advance across a change"))
+                {
+                    double tick = tm.advance(576.0, 1000000);   /* 1.5 s    */
+                    ok = near_value(tick, 864.0);
+                    if (ok)
+                    {
+                        for (double t = 0.0; t < 2000.0; t += 37.0)
+                        {
+                            double rt = tm.us_to_tick(tm.tick_to_us(t));
+                            if (! near_value(rt, t))
+                            {
+                                ok = false;
+                                break;
+                            }
+                        }
+                    }
+                }
+                if (! ok)
+                    errprint("tempomap conversion failed");
+
+                status.pass(ok);
+            }
+        }
+    }
+    return status;
+}
+
+/**
+ *
+ * \group 3. seq66::activenotes
+ *
+ * \case
+ *    1. Set, clear, and all-off
+ *
+ *    The all-off case drains the set with pop(), as the panic and stop code
+ *    of mastermidibase does.
+ *
+ * \tests
+ *    -  activenotes::note_on()
+ *    -  activenotes::note_off()
+ *    -  activenotes::pop()
+ *    -  activenotes::clear()
+ *
+ * \param options
+ *    Provides the command-line options for the unit-test application.
+ *
+ * \return
+ *    Returns the unit-test status object needed by the protocol.
+ */
+
+xpc::cut_status
+playback_unit_test_03_01 (const xpc::cut_options & options)
+{
+    xpc::cut_status status
+    (
+        options, 3, 1, "seq66::activenotes", T_("Set, clear, all-off")
+    );
+    bool ok = status.valid();                   /* invalidity not an error  */
+    if (ok)
+    {
+        if (! status.can_proceed())             /* is test allowed to run?  */
+        {
+            status.pass();                      /* no, force it to pass     */
+        }
+        else
+        {
+            if (status.next_subtest("Set"))
+            {
+                seq66::activenotes notes;
+                int lastbus = seq66::c_busscount_max - 1;
+                seq66::bussbyte last = seq66::bussbyte(lastbus);
+                ok = notes.empty();
+                notes.note_on(0, 0, 60);
+                notes.note_on(0, 0, 60);                /* counted once     */
+                notes.note_on(3, 9, 127);
+                notes.note_on(last, 15, 0);
+                notes.note_on(0, 0x91, 64);             /* channel masked   */
+                if (ok)
+                    ok = notes.count() == 4;
+
+                if (ok)
+                    ok = notes.active(0, 0, 60) && notes.active(3, 9, 127) &&
+                        notes.active(last, 15, 0) && notes.active(0, 1, 64);
+
+                if (ok)
+                    ok = ! notes.active(0, 0, 61) && ! notes.active(1, 0, 60);
+
+                if (ok && status.next_subtest("Note Off"))
+                {
+                    notes.note_off(0, 0, 60);
+                    notes.note_off(0, 0, 60);           /* no effect        */
+                    ok = notes.count() == 3 && ! notes.active(0, 0, 60);
+                }
+                if (ok && status.next_subtest("All off"))
+                {
+                    seq66::bussbyte bus;
+                    seq66::midibyte channel, note;
+                    int popped = 0;
+                    while (notes.pop(bus, channel, note))
+                    {
+                        if (options.is_verbose())
+                        {
+                            std::cout
+                                << "buss " << int(bus)
+                                << " channel " << int(channel)
+                                << " note " << int(note) << std::endl;
+                        }
+                        ++popped;
+                    }
+                    ok = popped == 3 && notes.empty();
+                }
+                if (ok && status.next_subtest("Clear"))
+                {
+                    notes.note_on(5, 5, 5);
+                    notes.note_on(6, 6, 6);
+                    notes.clear();
+                    ok = notes.empty() && ! notes.active(5, 5, 5);
+                }
+                if (! ok)
+                    errprint("activenotes failed");
+
+                status.pass(ok);
+            }
+        }
+    }
+    return status;
+}
+
+/**
+ *
+ * \group 4. seq66::outqueue
+ *
+ * \case
+ *    1. Full, empty, and wrap
+ *
+ * \tests
+ *    -  outqueue::allocate()
+ *    -  outqueue::push()
+ *    -  outqueue::pop()
+ *    -  outqueue::clear()
+ *
+ * \param options
+ *    Provides the command-line options for the unit-test application.
+ *
+ * \return
+ *    Returns the unit-test status object needed by the protocol.
+ */
+
+xpc::cut_status
+playback_unit_test_04_01 (const xpc::cut_options & options)
+{
+    xpc::cut_status status
+    (
+        options, 4, 1, "seq66::outqueue", T_("Full, empty, wrap")
+    );
+    bool ok = status.valid();                   /* invalidity not an error  */
+    if (ok)
+    {
+        if (! status.can_proceed())             /* is test allowed to run?  */
+        {
+            status.pass();                      /* no, force it to pass     */
+        }
+        else
+        {
+            if (status.next_subtest("Unallocated"))
+            {
+                seq66::outqueue q;
+                seq66::outslot slot;
+                seq66::event e = note_event(seq66::EVENT_NOTE_ON, 60);
+                ok = q.empty() && ! q.push(0, e, 0) && ! q.pop(slot);
+                if (ok && status.next_subtest("Full"))
+                {
+                    q.allocate(3);                      /* rounded up to 4  */
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        if (! q.push(0, e, i))
+                            ok = false;
+                    }
+                    if (ok)
+                        ok = ! q.push(0, e, 4) && ! q.empty();
+                }
+                if (ok && status.next_subtest("Wrap"))
+                {
+                    ok = q.pop(slot) && slot.os_tick == 0;
+                    if (ok)
+                        ok = q.pop(slot) && slot.os_tick == 1;
+
+                    if (ok)
+                        ok = q.push(2, e, 4) && q.push(3, e, 5);
+
+                    for (int i = 2; ok && i < 6; ++i)
+                        ok = q.pop(slot) && slot.os_tick == i;
+
+                    if (ok)
+                        ok = slot.os_channel == 3 && slot.os_d0 == 60;
+                }
+                if (ok && status.next_subtest("Empty"))
+                {
+                    ok = q.empty() && ! q.pop(slot);
+                    if (ok)
+                    {
+                        (void) q.push(0, e, 6);
+                        q.clear();
+                        ok = q.empty() && ! q.pop(slot);
+                    }
+                }
+                if (! ok)
+                    errprint("outqueue failed");
+
+                status.pass(ok);
+            }
+        }
+    }
+    return status;
+}
+
+/**
+ *
+ * \group 5. seq66::playsnapshot
+ *
+ * \case
+ *    1. Hazard swap
+ *
+ *    A snapshot held by the reader must survive a publication, and the
+ *    reader must see the new one only at its next outermost acquire().
+ *
+ * \tests
+ *    -  playsnapshot::publish()
+ *    -  playsnapshot::acquire()
+ *    -  playsnapshot::release()
+ *
+ * \param options
+ *    Provides the command-line options for the unit-test application.
+ *
+ * \return
+ *    Returns the unit-test status object needed by the protocol.
+ */
+
+xpc::cut_status
+playback_unit_test_05_01 (const xpc::cut_options & options)
+{
+    xpc::cut_status status
+    (
+        options, 5, 1, "seq66::playsnapshot", T_("Hazard swap")
+    );
+    bool ok = status.valid();                   /* invalidity not an error  */
+    if (ok)
+    {
+        if (! status.can_proceed())             /* is test allowed to run?  */
+        {
+            status.pass();                      /* no, force it to pass     */
+        }
+        else
+        {
+            if (status.next_subtest("Initial snapshot"))
+            {
+                seq66::playsnapshot ps;
+                const seq66::playsnapshot::snapshot & held = ps.acquire();
+                ok = held.generation() == 0 && held.sequences().empty();
+                if (ok)
+                    ok = ! held.tempo_map().active();
+
+                if (ok && status.next_subtest("Publish while held"))
+                {
+                    seq66::tempomap tm;
+                    seq66::tempomap::changes list;
+                    seq66::tempochange tc;
+                    tc.tc_tick = 768;
+                    tc.tc_bpm = 60.0;
+                    list.push_back(tc);
+                    tm.rebuild(120.0, 192, list);
+                    ps.publish(tm);
+                    ps.publish(tm);                     /* retire another   */
+                    ok = ps.generation() == 2;
+                    if (ok)
+                        ok = held.generation() == 0 &&
+                            ! held.tempo_map().active();
+                }
+                if (ok && status.next_subtest("Nested acquire"))
+                {
+                    const seq66::playsnapshot::snapshot & inner = ps.acquire();
+                    ok = &inner == &held;
+                    ps.release();
+                }
+                if (ok && status.next_subtest("Swap at next acquire"))
+                {
+                    ps.release();
+                    const seq66::playsnapshot::snapshot & fresh = ps.acquire();
+                    ok = fresh.generation() == 2;
+                    if (ok)
+                        ok = fresh.tempo_map().active() &&
+                            fresh.tempo_map().count() == 2;
+
+                    ps.release();
+                }
+                if (! ok)
+                    errprint("playsnapshot swap failed");
+
+                status.pass(ok);
+            }
+        }
+    }
+    return status;
+}
+
+/**
+ *
+ * \group 6. seq66::midi_queue
+ *
+ * \case
+ *    1. Single-producer, single-consumer ring
+ *
+ *    Available only in the RtMidi build, where the input ports use it.
+ *
+ * \tests
+ *    -  midi_queue::add()
+ *    -  midi_queue::front()
+ *    -  midi_queue::bytes()
+ *    -  midi_queue::pop()
+ *
+ * \param options
+ *    Provides the command-line options for the unit-test application.
+ *
+ * \return
+ *    Returns the unit-test status object needed by the protocol.
+ */
+
+xpc::cut_status
+playback_unit_test_06_01 (const xpc::cut_options & options)
+{
+    xpc::cut_status status
+    (
+        options, 6, 1, "seq66::midi_queue", T_("SPSC ring")
+    );
+    bool ok = status.valid();                   /* invalidity not an error  */
+    if (ok)
+    {
+        if (! status.can_proceed())             /* is test allowed to run?  */
+        {
+            status.pass();                      /* no, force it to pass     */
+        }
+        else
+        {
+#if defined SEQ66_RTMIDI_SUPPORT
+            if (status.next_subtest("Full"))
+            {
+                seq66::midi_queue q;
+                seq66::midibyte msg[3] = { 0x90, 60, 100 };
+                q.allocate(4, 16);
+                for (int i = 0; i < 4; ++i)
+                {
+                    if (! q.add(msg, 3, double(i)))
+                        ok = false;
+                }
+                if (ok)
+                    ok = q.full() && ! q.add(msg, 3, 4.0);
+
+                if (ok)
+                    ok = q.take_dropped() == 1 && q.take_dropped() == 0;
+
+                if (ok && status.next_subtest("Order"))
+                {
+                    for (int i = 0; ok && i < 4; ++i)
+                    {
+                        const seq66::midi_record & mr = q.front();
+                        const seq66::midibyte * bytes = q.bytes(mr);
+                        ok = mr.mr_count == 3 && bytes[1] == 60 &&
+                            mr.mr_timestamp == double(i);
+
+                        q.pop();
+                    }
+                    if (ok)
+                        ok = q.empty();
+                }
+                if (ok && status.next_subtest("Spill wrap"))
+                {
+                    seq66::midibyte sysex[10] =
+                    {
+                        0xF0, 1, 2, 3, 4, 5, 6, 7, 8, 0xF7
+                    };
+                    ok = q.add(sysex, 10, 0.0);
+                    if (ok)
+                        ok = ! q.add(sysex, 10, 1.0);   /* spill area full  */
+
+                    if (ok)
+                    {
+                        q.pop();
+                        ok = q.add(sysex, 10, 2.0);     /* wraps to start   */
+                    }
+                    if (ok)
+                    {
+                        const seq66::midi_record & mr = q.front();
+                        const seq66::midibyte * bytes = q.bytes(mr);
+                        ok = mr.mr_count == 10 && mr.mr_spill == 0 &&
+                            bytes[0] == 0xF0 && bytes[9] == 0xF7;
+
+                        q.pop();
+                    }
+                    if (ok)
+                        ok = q.empty() && q.take_dropped() == 1;
+                }
+                if (! ok)
+                    errprint("midi_queue failed");
+
+                status.pass(ok);
+            }
+#else
+            if (options.is_verbose())
+                std::cout << "midi_queue is used only by RtMidi" << std::endl;
+
+            status.pass();
+#endif
+        }
+    }
+    return status;
+}
+
+/**
+ *
+ * \group 7. seq66::rtthread
+ *
+ * \case
+ *    1. parse_cpu_list()
+ *
+ * \tests
+ *    -  seq66::parse_cpu_list()
+ *
+ * \param options
+ *    Provides the command-line options for the unit-test application.
+ *
+ * \return
+ *    Returns the unit-test status object needed by the protocol.
+ */
+
+xpc::cut_status
+playback_unit_test_07_01 (const xpc::cut_options & options)
+{
+    xpc::cut_status status
+    (
+        options, 7, 1, "seq66::rtthread", T_("parse_cpu_list()")
+    );
+    bool ok = status.valid();                   /* invalidity not an error  */
+    if (ok)
+    {
+        if (! status.can_proceed())             /* is test allowed to run?  */
+        {
+            status.pass();                      /* no, force it to pass     */
+        }
+        else
+        {
+            if (status.next_subtest("Single CPU"))
+            {
+                std::vector<int> cpus;
+                ok = seq66::parse_cpu_list("2", cpus);
+                if (ok)
+                    ok = cpus.size() == 1 && cpus[0] == 2;
+
+                if (ok && status.next_subtest("Ranges"))
+                {
+                    ok = seq66::parse_cpu_list("0-1,6", cpus);
+                    if (ok)
+                        ok = cpus == std::vector<int>{ 0, 1, 6 };
+                }
+                if (ok && status.next_subtest("No restriction"))
+                {
+                    ok = seq66::parse_cpu_list("", cpus) && cpus.empty();
+                    if (ok)
+                        ok = seq66::parse_cpu_list("all", cpus) && cpus.empty();
+                }
+                if (ok && status.next_subtest("Malformed"))
+                {
+                    ok = ! seq66::parse_cpu_list("3-1", cpus) && cpus.empty();
+                    if (ok)
+                        ok = ! seq66::parse_cpu_list("x", cpus);
+
+                    if (ok)
+                        ok = ! seq66::parse_cpu_list("-1", cpus);
+
+                    if (ok)
+                        ok = ! seq66::parse_cpu_list("1-2-3", cpus);
+
+                    if (ok)
+                        ok = ! seq66::parse_cpu_list("0,1-", cpus);
+                }
+                if (! ok)
+                    errprint("parse_cpu_list failed");
+
+                status.pass(ok);
+            }
+        }
+    }
+    return status;
+}
+
+#endif          // SEQ66_SEQTOOL_TESTING_SUPPORT
+
+/*
+ * playback_unit_test.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
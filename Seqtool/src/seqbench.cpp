@@ -0,0 +1,155 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          seqbench.cpp
+ * \library       Seqtool (from the Seq66 project)
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \version       $Revision$
+ * \license       $XPC_SUITE_GPL_LICENSE$
+ *
+ *    This application runs the playback benchmark of playback_bench.cpp.
+ *    It is a separate program from seqtool because it replaces the global
+ *    operator new in order to count allocations, and that replacement
+ *    should not change the allocator used by the other seqtool modes.
+ *
+ *    Usage: seqbench sets:patterns:notes[:measures[:length]]
+ */
+
+#include <atomic>                       /* std::atomic<> counter            */
+#include <cstdlib>                      /* std::malloc(), std::free()       */
+#include <cstring>                      /* std::strcmp()                    */
+#include <iostream>                     /* std::cout                        */
+#include <new>                          /* std::bad_alloc                   */
+
+#include "playback_bench.hpp"           /* seq66::playback_benchmark()      */
+#include "seq66_features.hpp"           /* seq66::set_app_name()            */
+#include "util/basic_macros.hpp"        /* errprint() macro                 */
+
+/**
+ *  Counts every call to the global operator new in this program.
+ */
+
+static std::atomic<long> sg_allocations(0);
+
+void *
+operator new (std::size_t size)
+{
+    sg_allocations.fetch_add(1, std::memory_order_relaxed);
+    void * result = std::malloc(size > 0 ? size : 1);
+    if (result == nullptr)
+        throw std::bad_alloc();
+
+    return result;
+}
+
+void *
+operator new [] (std::size_t size)
+{
+    return operator new(size);
+}
+
+void
+operator delete (void * p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete [] (void * p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete (void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete [] (void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace seq66
+{
+
+/**
+ *  The hook used by playback_benchmark() to count allocations.
+ */
+
+long
+allocation_count ()
+{
+    return sg_allocations.load(std::memory_order_relaxed);
+}
+
+}           // namespace seq66
+
+/**
+ *  Help!
+ */
+
+static void
+s_help ()
+{
+    std::cout <<
+"Usage: seqbench sets:patterns:notes[:measures[:length]]\n\n"
+"  Run the playback benchmark and write the results as one line of JSON.\n"
+"  The optional ':measures' is the length of each pattern (default 1) and\n"
+"  ':length' is the measures played per set (default 16). Example: 4:32:64.\n"
+"\n"
+    ;
+}
+
+/**
+ *  Main!
+ */
+
+int
+main
+(
+    int argc,           /**< Number of command-line arguments.              */
+    char * argv []      /**< The actual array of command-line arguments.    */
+)
+{
+    bool ok = false;
+    seq66::set_app_name("seqbench");
+    if (argc == 2 && std::strcmp(argv[1], "--help") != 0)
+    {
+        seq66::benchspec bs;
+        if (seq66::parse_bench_spec(std::string(argv[1]), bs))
+            ok = seq66::playback_benchmark(bs);
+        else
+            errprint("seqbench requires sets:patterns:notes");
+    }
+    else
+        s_help();
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*
+ * seqbench.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
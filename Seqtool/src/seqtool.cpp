@@ -21,7 +21,7 @@
  * \library       Seqtool (from the Seq66 project)
  * \author        Chris Ahlstrom
  * \date          2018-11-11
- * \updates       2020-07-04
+ * \updates       2020-11-24
  * \version       $Revision$
  * \license       $XPC_SUITE_GPL_LICENSE$
  *
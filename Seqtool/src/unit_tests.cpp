@@ -21,7 +21,7 @@
  * \library       Seqtool (from the Seq66 project)
  * \author        Chris Ahlstrom
  * \date          2018-11-11
- * \updates       2018-12-25
+ * \updates       2020-11-24
  * \version       $Revision$
  * \license       $XPC_SUITE_GPL_LICENSE$
  *
@@ -33,6 +33,7 @@
 
 #include "seq66-config.h"
 #include "midi_control_unit_test.hpp"
+#include "playback_unit_test.hpp"
 #include "unit_tests.hpp"
 #include "util_unit_test.hpp"
 
@@ -107,6 +108,16 @@ unit_tests
          if (ok) ok = testbattery.load(util_unit_test_01_01);
          if (ok) ok = testbattery.load(util_unit_test_01_02);
          if (ok) ok = testbattery.load(util_unit_test_01_03);
+
+         if (ok) ok = testbattery.load(playback_unit_test_01_01);
+         if (ok) ok = testbattery.load(playback_unit_test_01_02);
+         if (ok) ok = testbattery.load(playback_unit_test_01_03);
+         if (ok) ok = testbattery.load(playback_unit_test_02_01);
+         if (ok) ok = testbattery.load(playback_unit_test_03_01);
+         if (ok) ok = testbattery.load(playback_unit_test_04_01);
+         if (ok) ok = testbattery.load(playback_unit_test_05_01);
+         if (ok) ok = testbattery.load(playback_unit_test_06_01);
+         if (ok) ok = testbattery.load(playback_unit_test_07_01);
       }
       if (ok)
       {
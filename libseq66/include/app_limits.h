@@ -28,7 +28,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-11-08
- * \updates       2020-08-11
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This collection of macros describes some facets of the
@@ -162,9 +162,11 @@
 #define SEQ66_SEQKEY_HEIGHT               10
 
 /**
- *  The number of ALSA busses supported.  See mastermidibus::init().  Currently,
- *  this is also the default number of "manual" (virtual) output ports created
- *  in the manual-ports mode.
+ *  The default number of "manual" (virtual) output ports created in the
+ *  manual-ports mode, and of loopback output ports.  See
+ *  mastermidibus::init().  Despite the name, it is not a limit; the most
+ *  busses supported is c_busscount_max (64) in midibytes.hpp, and the
+ *  "rc" file can ask for up to that many manual ports.
  */
 
 #define SEQ66_OUTPUT_BUSS_MAX             16
@@ -510,6 +512,59 @@
  *  #define SEQ66_DEFAULT_TRIGLOOK_MS         2
  */
 
+/**
+ *  Default size of the output lookahead window, in milliseconds.  The output
+ *  thread renders events this far ahead of the current time, and sends each
+ *  one at its exact deadline.  A value of 0 disables the lookahead scheduler,
+ *  keeping the older send-as-rendered behavior.  It is the default, because
+ *  the lookahead delays live mutes, queueing, and one-shots by up to its
+ *  size; users opt in through the 'rc' file.  The minimum and maximum apply
+ *  to non-zero values.
+ */
+
+#define SEQ66_DEFAULT_LOOKAHEAD_MS           0
+#define SEQ66_LOOKAHEAD_MS_MIN               2
+#define SEQ66_LOOKAHEAD_MS_MAX              50
+
+/**
+ *  Limits of the ALSA client output pool, in events, that can be set in the
+ *  'rc' file.  A value of 0 keeps the ALSA default (500 events).  The
+ *  maximum is the kernel's limit.
+ */
+
+#define SEQ66_ALSA_POOL_MIN                 32
+#define SEQ66_ALSA_POOL_MAX               2000
+
+/**
+ *  The largest PortMidi output latency, in milliseconds, that can be set in
+ *  the 'rc' file.  A value of 0 disables the timestamps.
+ */
+
+#define SEQ66_PORTMIDI_LATENCY_MAX         500
+
+/**
+ *  The default and largest spin of the output timer, in microseconds.  The
+ *  output thread's kernel sleep ends this much early at most, and the rest
+ *  of the wait is spent yielding, which uses the processor.  The timer only
+ *  spins as long as the wakeup latency it measures, up to this limit.  A
+ *  value of 0 leaves the wait entirely to the kernel.
+ */
+
+#define SEQ66_DEFAULT_WAKE_SPIN_US         100
+#define SEQ66_WAKE_SPIN_US_MAX            1000
+
+/**
+ *  Real-time priorities for the output and input threads, used when the
+ *  'rc' file or the command line selects the "fifo" or "rr" policy without
+ *  giving a priority.  The output thread is placed a notch above the input
+ *  thread.  Both stay below the usual JACK priorities (70 and up).
+ */
+
+#define SEQ66_DEFAULT_OUTPUT_PRIORITY       20
+#define SEQ66_DEFAULT_INPUT_PRIORITY        19
+#define SEQ66_THREAD_PRIORITY_MIN            1
+#define SEQ66_THREAD_PRIORITY_MAX           99
+
 /**
  *  Defines the minimum Note On velocity.
  */
@@ -28,7 +28,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-09-22
- * \updates       2020-11-15
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This collection of variables describes the options of the application,
@@ -246,10 +246,91 @@ private:
     bool m_show_midi;               /**< Show MIDI events to console.       */
     bool m_priority;                /**< Run at high priority (Linux only). */
     bool m_pass_sysex;              /**< Pass SysEx to outputs, not ready.  */
+    int m_lookahead_ms;             /**< [output-scheduling] window, 0=off. */
+
+    /**
+     *  If true, and ALSA is in use with the lookahead scheduler, the events
+     *  are handed to an ALSA queue with real-time timestamps, shortly ahead
+     *  of their deadlines, and the kernel delivers them.  Set by the "-o
+     *  alsa-queue" option or the [output-scheduling] section.
+     */
+
+    bool m_alsa_queue;
+
+    /**
+     *  The size of the ALSA client output pool, in events.  The output of a
+     *  whole cycle is batched in this pool before the single drain.  A value
+     *  of 0 keeps the ALSA default.
+     */
+
+    int m_alsa_pool;
+
+    /**
+     *  The PortMidi output latency, in milliseconds.  If greater than 0, the
+     *  output ports are opened with this latency, and each event is stamped
+     *  with the PortTime of its deadline, so that PortMidi sends it on time.
+     *  A value of 0 sends each event as soon as it is written.
+     */
+
+    int m_portmidi_latency;
+
+    /**
+     *  The longest time the output thread spends yielding before a deadline,
+     *  in microseconds, after its kernel sleep.  See cycletimer.  A value of
+     *  0 disables the spin.
+     */
+
+    int m_wake_spin_us;
+
+    /**
+     *  If true, ALSA stamps each input event with its arrival time, and a
+     *  recorded event is placed at the pulse of that time, instead of the
+     *  pulse current when the input thread reads it.  Set by the "-o
+     *  alsa-input-time" option or the [input-timing] section.
+     */
+
+    bool m_alsa_input_time;
+
+    /**
+     *  The [thread-scheduling] settings.  The policy is "normal", "fifo", or
+     *  "rr".  The CPU list is in the style of taskset(1), e.g. "2,3" or
+     *  "0-1"; "all" means no restriction.  The legacy m_priority flag
+     *  (--priority) promotes a "normal" output or input thread to "fifo"
+     *  at priority 1.
+     */
+
+    std::string m_output_thread_policy;
+    int m_output_thread_priority;
+    std::string m_output_thread_cpus;
+    std::string m_input_thread_policy;
+    int m_input_thread_priority;
+    std::string m_input_thread_cpus;
+    bool m_lock_memory;             /**< Call mlockall() at launch.         */
+
     bool m_with_jack_transport;     /**< Enable synchrony with JACK.        */
     bool m_with_jack_master;        /**< Serve as a JACK transport Master.  */
     bool m_with_jack_master_cond;   /**< Serve as JACK Master if possible.  */
     bool m_with_jack_midi;          /**< Use JACK MIDI.                     */
+
+    /**
+     *  If true, and JACK MIDI is in use, the JACK process callback drives the
+     *  sequencer, advancing it by exactly one period of frames per call,
+     *  instead of the output thread of the performer.  Set by the "-o
+     *  jack-engine" option or the [jack-transport] section of the "rc" file.
+     */
+
+    bool m_jack_engine;
+
+    /**
+     *  The number of input and output ports of the in-memory loopback MIDI
+     *  API.  If the output count is 0 (the default), the loopback API is not
+     *  used.  Set by the "-o loopback=i:o" option, for testing and
+     *  benchmarking on machines with no ALSA sequencer or JACK server.  Not
+     *  saved to the "rc" file.
+     */
+
+    int m_loopback_inputs;
+    int m_loopback_outputs;
     bool m_song_start_mode;         /**< Use song mode versus live mode.    */
     bool m_filter_by_channel;       /**< Record only sequence channel data. */
     bool m_manual_ports;            /**< [manual-ports] setting.            */
@@ -629,6 +710,26 @@ public:
         return m_with_jack_midi;
     }
 
+    bool jack_engine () const
+    {
+        return m_jack_engine;
+    }
+
+    bool with_loopback_midi () const
+    {
+        return m_loopback_outputs > 0;
+    }
+
+    int loopback_inputs () const
+    {
+        return m_loopback_inputs;
+    }
+
+    int loopback_outputs () const
+    {
+        return m_loopback_outputs;
+    }
+
     bool song_start_mode () const
     {
         return m_song_start_mode;
@@ -654,6 +755,13 @@ public:
         m_with_jack_midi = flag;
     }
 
+    void jack_engine (bool flag)
+    {
+        m_jack_engine = flag;
+    }
+
+    void loopback_ports (int inputs, int outputs);
+
     /**
      * \getter m_with_jack_transport m_with_jack_master, and
      * m_with_jack_master_cond, to save client code some trouble.  Do not
@@ -683,6 +791,71 @@ public:
         return m_manual_port_count;
     }
 
+    int lookahead_ms () const
+    {
+        return m_lookahead_ms;
+    }
+
+    bool alsa_queue () const
+    {
+        return m_alsa_queue;
+    }
+
+    int alsa_pool () const
+    {
+        return m_alsa_pool;
+    }
+
+    int portmidi_latency () const
+    {
+        return m_portmidi_latency;
+    }
+
+    int wake_spin_us () const
+    {
+        return m_wake_spin_us;
+    }
+
+    bool alsa_input_time () const
+    {
+        return m_alsa_input_time;
+    }
+
+    const std::string & output_thread_policy () const
+    {
+        return m_output_thread_policy;
+    }
+
+    int output_thread_priority () const
+    {
+        return m_output_thread_priority;
+    }
+
+    const std::string & output_thread_cpus () const
+    {
+        return m_output_thread_cpus;
+    }
+
+    const std::string & input_thread_policy () const
+    {
+        return m_input_thread_policy;
+    }
+
+    int input_thread_priority () const
+    {
+        return m_input_thread_priority;
+    }
+
+    const std::string & input_thread_cpus () const
+    {
+        return m_input_thread_cpus;
+    }
+
+    bool lock_memory () const
+    {
+        return m_lock_memory;
+    }
+
     bool reveal_ports () const
     {
         return m_reveal_ports;
@@ -1011,10 +1184,139 @@ protected:
     {
         if (count <= 0)
             count = SEQ66_OUTPUT_BUSS_MAX;
+        else if (count > c_busscount_max)
+            count = c_busscount_max;
 
         m_manual_port_count = count;
     }
 
+    /**
+     * \setter m_lookahead_ms
+     *      A value of 0 disables the lookahead scheduler.  Other values are
+     *      clamped to the range allowed by app_limits.h.
+     */
+
+    void lookahead_ms (int ms)
+    {
+        if (ms <= 0)
+            ms = 0;
+        else if (ms < SEQ66_LOOKAHEAD_MS_MIN)
+            ms = SEQ66_LOOKAHEAD_MS_MIN;
+        else if (ms > SEQ66_LOOKAHEAD_MS_MAX)
+            ms = SEQ66_LOOKAHEAD_MS_MAX;
+
+        m_lookahead_ms = ms;
+    }
+
+    void alsa_queue (bool flag)
+    {
+        m_alsa_queue = flag;
+    }
+
+    /**
+     * \setter m_alsa_pool
+     *      A value of 0 keeps the ALSA default.  Other values are clamped to
+     *      the range allowed by app_limits.h.
+     */
+
+    void alsa_pool (int events)
+    {
+        if (events <= 0)
+            events = 0;
+        else if (events < SEQ66_ALSA_POOL_MIN)
+            events = SEQ66_ALSA_POOL_MIN;
+        else if (events > SEQ66_ALSA_POOL_MAX)
+            events = SEQ66_ALSA_POOL_MAX;
+
+        m_alsa_pool = events;
+    }
+
+    /**
+     * \setter m_portmidi_latency
+     *      A value of 0 disables the timestamps.  Other values are clamped
+     *      to the maximum allowed by app_limits.h.
+     */
+
+    void portmidi_latency (int ms)
+    {
+        if (ms <= 0)
+            ms = 0;
+        else if (ms > SEQ66_PORTMIDI_LATENCY_MAX)
+            ms = SEQ66_PORTMIDI_LATENCY_MAX;
+
+        m_portmidi_latency = ms;
+    }
+
+    /**
+     * \setter m_wake_spin_us
+     *      Clamped to the range allowed by app_limits.h.
+     */
+
+    void wake_spin_us (int us)
+    {
+        if (us <= 0)
+            us = 0;
+        else if (us > SEQ66_WAKE_SPIN_US_MAX)
+            us = SEQ66_WAKE_SPIN_US_MAX;
+
+        m_wake_spin_us = us;
+    }
+
+    void alsa_input_time (bool flag)
+    {
+        m_alsa_input_time = flag;
+    }
+
+    void output_thread_policy (const std::string & p)
+    {
+        m_output_thread_policy = thread_policy_check(p);
+    }
+
+    void output_thread_priority (int p)
+    {
+        m_output_thread_priority = thread_priority_check(p);
+    }
+
+    void output_thread_cpus (const std::string & cpus)
+    {
+        m_output_thread_cpus = cpus.empty() ? std::string("all") : cpus ;
+    }
+
+    void input_thread_policy (const std::string & p)
+    {
+        m_input_thread_policy = thread_policy_check(p);
+    }
+
+    void input_thread_priority (int p)
+    {
+        m_input_thread_priority = thread_priority_check(p);
+    }
+
+    void input_thread_cpus (const std::string & cpus)
+    {
+        m_input_thread_cpus = cpus.empty() ? std::string("all") : cpus ;
+    }
+
+    void lock_memory (bool flag)
+    {
+        m_lock_memory = flag;
+    }
+
+    static std::string thread_policy_check (const std::string & p)
+    {
+        return (p == "fifo" || p == "rr") ? p : std::string("normal") ;
+    }
+
+    static int thread_priority_check (int p)
+    {
+        if (p < SEQ66_THREAD_PRIORITY_MIN)
+            p = SEQ66_THREAD_PRIORITY_MIN;
+        else if (p > SEQ66_THREAD_PRIORITY_MAX)
+            p = SEQ66_THREAD_PRIORITY_MAX;
+
+        return p;
+    }
+
     void reveal_ports (bool flag)
     {
         m_reveal_ports = flag;
@@ -28,7 +28,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-09-22
- * \updates       2020-09-03
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This module defines the following categories of "global" variables that
@@ -843,6 +843,29 @@ private:
 
     std::string m_user_option_logfile;
 
+    /**
+     *  If not empty, the command-line application renders the song offline
+     *  to this MIDI file and exits, instead of playing.  Set by the
+     *  "-o bounce=filename" (SMF 1) or "-o bounce0=filename" (SMF 0) option.
+     *  Not saved to the "usr" file.
+     */
+
+    std::string m_user_option_bounce;
+
+    /**
+     *  The SMF format of the rendered file, 0 or 1.
+     */
+
+    int m_user_option_bounce_format;
+
+    /**
+     *  If not empty, the playback statistics of the output thread are
+     *  written to this file at exit, and by seq66cli upon a SIGUSR2 signal.
+     *  Set by the "-o stats=filename" option.  Not saved to the "usr" file.
+     */
+
+    std::string m_user_option_stats;
+
     /*
      *  [user-work-arounds]
      */
@@ -1555,6 +1578,21 @@ public:
 
     std::string option_logfile () const;
 
+    const std::string & option_bounce () const
+    {
+        return m_user_option_bounce;
+    }
+
+    int option_bounce_format () const
+    {
+        return m_user_option_bounce_format;
+    }
+
+    const std::string & option_stats () const
+    {
+        return m_user_option_stats;
+    }
+
     bool work_around_play_image () const
     {
         return m_work_around_play_image;
@@ -1705,6 +1743,17 @@ public:         // used in main application module and the usrfile class
         m_user_option_logfile = logfile;
     }
 
+    void option_bounce (const std::string & midifile, int format = 1)
+    {
+        m_user_option_bounce = midifile;
+        m_user_option_bounce_format = format == 0 ? 0 : 1 ;
+    }
+
+    void option_stats (const std::string & statsfile)
+    {
+        m_user_option_stats = statsfile;
+    }
+
     void work_around_play_image (bool flag)
     {
         m_work_around_play_image = flag;
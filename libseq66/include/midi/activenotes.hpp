@@ -0,0 +1,126 @@
+#if ! defined SEQ66_ACTIVENOTES_HPP
+#define SEQ66_ACTIVENOTES_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          activenotes.hpp
+ *
+ *  This module declares a table of the notes sounding on the output busses.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  The master buss marks each Note On it sends, and unmarks each Note Off
+ *  (or Note On with a velocity of 0).  Panic, stop, and the other "all
+ *  notes off" actions then send a Note Off for each marked note only,
+ *  instead of one for every note of every channel of every buss.  Since
+ *  the table sees what actually went out, it also catches notes left
+ *  hanging by a pattern that was cut off in the middle of a note.
+ *
+ *  A note is either sounding or not; two Note Ons of the same note on the
+ *  same channel are released by one Note Off, as most synthesizers do.
+ *
+ *  This class does no locking; the owner (seq66::mastermidibase) does that.
+ */
+
+#include <cstdint>                      /* std::uint64_t, std::uint16_t     */
+
+#include "midi/midibytes.hpp"           /* seq66::c_busscount_max, etc.     */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  A bitset of sounding notes, 128 bits for each channel of each buss.  The
+ *  masks of channels and busses with sounding notes keep the sweeps short.
+ */
+
+class activenotes
+{
+
+private:
+
+    /**
+     *  One bit per note, in two 64-bit words per channel.
+     */
+
+    std::uint64_t m_notes[c_busscount_max][c_midichannel_max][2];
+
+    /**
+     *  One bit per channel that has a sounding note, for each buss.
+     */
+
+    std::uint16_t m_channels[c_busscount_max];
+
+    /**
+     *  One bit per buss that has a sounding note.
+     */
+
+    std::uint64_t m_busses;
+
+    static_assert
+    (
+        c_busscount_max <= 64, "m_busses needs a bit for each buss"
+    );
+
+    /**
+     *  The number of sounding notes.
+     */
+
+    int m_count;
+
+public:
+
+    activenotes ();
+
+    void note_on (bussbyte bus, midibyte channel, midibyte note);
+    void note_off (bussbyte bus, midibyte channel, midibyte note);
+    bool active (bussbyte bus, midibyte channel, midibyte note) const;
+    bool pop (bussbyte & bus, midibyte & channel, midibyte & note);
+    void clear ();
+
+    bool empty () const
+    {
+        return m_count == 0;
+    }
+
+    int count () const
+    {
+        return m_count;
+    }
+
+};          // class activenotes
+
+}           // namespace seq66
+
+#endif      // SEQ66_ACTIVENOTES_HPP
+
+/*
+ * activenotes.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
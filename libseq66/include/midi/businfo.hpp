@@ -27,7 +27,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2016-12-31
- * \updates       2020-07-14
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  The businfo module defines the businfo and busarray classes so that we can
@@ -210,6 +210,16 @@ private:
         bus()->clock(tick);
     }
 
+    midipulse next_clock (midipulse tick)
+    {
+        return bus()->next_clock(tick);
+    }
+
+    void send_clock (midipulse tick)
+    {
+        bus()->send_clock(tick);
+    }
+
     void sysex (event * ev)
     {
         bus()->sysex(ev);
@@ -320,6 +330,9 @@ public:
             bi.clock(tick);
     }
 
+    midipulse next_clock (bussbyte bus, midipulse tick);
+    void send_clock (bussbyte bus, midipulse tick);
+
     /**
      *  Handles SysEx events; used for output busses.
      *
@@ -28,7 +28,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2020-08-03
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This module also declares/defines the various constants, status-byte
@@ -751,7 +751,30 @@ public:
     }
 
     void set_status (midibyte status);
-    void set_channel_status (midibyte eventcode, midibyte channel);
+
+    /**
+     *  This overload is useful when synthesizing events, such as converting
+     *  a Note On event with a velocity of zero to a Note Off event.  See its
+     *  usage around line 681 of midifile.cpp.  It is inline because playback
+     *  calls it for every event sent; see playevents::fill().
+     *
+     * \param eventcode
+     *      The status byte, perhaps read from a MIDI file.  This byte is
+     *      assumed to have already had its low nybble cleared by masking
+     *      against EVENT_CLEAR_CHAN_MASK.
+     *
+     * \param channel
+     *      The channel byte.  Combined with the event-code, this makes a
+     *      valid MIDI "status" byte.  This byte is assumed to have already
+     *      had its high nybble cleared by masking against EVENT_GET_CHAN_MASK.
+     */
+
+    void set_channel_status (midibyte eventcode, midibyte channel)
+    {
+        m_status = eventcode;           /* already masked against 0xF0      */
+        m_channel = channel;            /* already masked against 0x0F      */
+    }
+
     void set_meta_status (midibyte metatype);
     void set_status_keep_channel (midibyte eventcode);
     bool set_midi_event
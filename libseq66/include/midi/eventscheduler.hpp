@@ -0,0 +1,210 @@
+#if ! defined SEQ66_EVENTSCHEDULER_HPP
+#define SEQ66_EVENTSCHEDULER_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          eventscheduler.hpp
+ *
+ *  This module declares a small timestamped queue of outgoing MIDI events.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-22
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  The output thread renders the events of the play set a short window
+ *  (the "lookahead") ahead of the current time.  Each rendered event is
+ *  converted from its pulse to a wall-clock deadline (in microseconds of
+ *  seq66::microtime()) and stored here.  The output thread then sleeps until
+ *  the earliest deadline and sends the events that are due.  The cost of
+ *  sleeping and of rendering thus no longer shows up as timing error.
+ *
+ *  This class does no locking; the owner (seq66::mastermidibase) does that.
+ */
+
+#include <vector>                       /* std::vector                      */
+
+#include "midi/midibytes.hpp"           /* seq66::midipulse, midibyte, etc. */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+    class event;
+
+/**
+ *  Holds a channel event waiting for its deadline.  Only the bytes needed to
+ *  rebuild the event are kept.  SysEx and Meta events are never scheduled;
+ *  MIDI clocks are, with a status of EVENT_MIDI_CLOCK.
+ */
+
+struct schedslot
+{
+    long ss_deadline;           /**< Wall-clock deadline, microseconds.     */
+    unsigned ss_order;          /**< Insertion order, keeps sorting stable. */
+    bussbyte ss_bus;            /**< Output buss for the event.             */
+    midibyte ss_channel;        /**< Channel to be applied to the status.   */
+    midibyte ss_status;         /**< Status byte, channel nybble cleared.   */
+    midibyte ss_d0;             /**< First data byte.                       */
+    midibyte ss_d1;             /**< Second data byte.                      */
+};
+
+/**
+ *  A min-heap of schedslot objects, ordered by deadline.
+ */
+
+class eventscheduler
+{
+
+private:
+
+    /**
+     *  The heap of events.  Reserved at construction so that the output
+     *  thread normally does not allocate.
+     */
+
+    std::vector<schedslot> m_slots;
+
+    /**
+     *  If true, the heap never grows past its reserved size; push() drops
+     *  the events that do not fit.  Set in engine mode, where the JACK
+     *  process callback must not allocate.
+     */
+
+    bool m_fixed_capacity;
+
+    /**
+     *  The number of events dropped by push() since the last call to
+     *  take_dropped().
+     */
+
+    int m_dropped;
+
+    /**
+     *  The size of the lookahead window in microseconds.  If 0, scheduling
+     *  is disabled and events are sent as soon as they are rendered.
+     */
+
+    long m_lookahead_us;
+
+    /**
+     *  The pulse and the microtime() value that correspond to each other at
+     *  the start of the current output cycle.  Set by set_origin().
+     */
+
+    double m_origin_tick;
+    long m_origin_us;
+
+    /**
+     *  The length of a pulse in microseconds, based on the tempo and PPQN
+     *  given to set_origin().
+     */
+
+    double m_pulse_us;
+
+    /**
+     *  Increments for every scheduled event, to keep events with the same
+     *  deadline in rendering order.
+     */
+
+    unsigned m_order;
+
+public:
+
+    eventscheduler ();
+
+    bool active () const
+    {
+        return m_lookahead_us > 0;
+    }
+
+    long lookahead_us () const
+    {
+        return m_lookahead_us;
+    }
+
+    void lookahead_us (long us)
+    {
+        m_lookahead_us = us > 0 ? us : 0 ;
+    }
+
+    void fixed_capacity (bool flag)
+    {
+        m_fixed_capacity = flag;
+    }
+
+    /**
+     * \return
+     *      Returns the number of events dropped since the last call, and
+     *      resets the count.
+     */
+
+    int take_dropped ()
+    {
+        int result = m_dropped;
+        m_dropped = 0;
+        return result;
+    }
+
+    bool empty () const
+    {
+        return m_slots.empty();
+    }
+
+    int count () const
+    {
+        return int(m_slots.size());
+    }
+
+    /**
+     * \return
+     *      Returns the earliest deadline in the queue, or 0 if the queue is
+     *      empty.
+     */
+
+    long next_deadline () const
+    {
+        return m_slots.empty() ? 0 : m_slots.front().ss_deadline ;
+    }
+
+    void set_origin (double tick, long us, midibpm bpm, int ppqn);
+    long deadline (midipulse tick) const;
+    long deadline_after (double pulses) const;
+    void push (long deadline, bussbyte bus, midibyte channel, const event & e);
+    bool pop_due (long now, schedslot & slot);
+    bool pop (schedslot & slot);
+    int cancel_note_on (bussbyte bus, midibyte channel, midibyte note);
+    int cancel_note_ons ();
+    void clear ();
+
+};          // class eventscheduler
+
+}           // namespace seq66
+
+#endif      // SEQ66_EVENTSCHEDULER_HPP
+
+/*
+ * eventscheduler.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -28,7 +28,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-07-23
- * \updates       2019-01-27
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This class contains a number of functions that used to reside in the
@@ -60,6 +60,7 @@
 namespace seq66
 {
     class performer;                      /* forward reference                */
+    class tempomap;
 
 /**
  *  Provide a temporary structure for passing data and results between a
@@ -86,6 +87,7 @@ public:
     double js_ticks_delta;              /**< Minor difference in tick.      */
     double js_ticks_converted_last;     /**< Keeps track of position?       */
     long js_delta_tick_frac;            /**< More precision for seq66 0.9.3 */
+    const tempomap * js_tempo_map;      /**< Published map, if in use.      */
 
 };
 
@@ -420,7 +422,10 @@ public:
     void start ();
     void stop ();
 
-    void position (bool state, midipulse tick = 0);
+    void position
+    (
+        bool state, midipulse tick = 0, const tempomap * tmap = nullptr
+    );
     bool output (jack_scratchpad & pad);
 
     /**
@@ -549,6 +554,10 @@ private:
         return double(m_ppqn) / denom;
     }
 
+    double frame_to_map_tick
+    (
+        jack_nframes_t frame, const tempomap & tmap
+    ) const;
     jack_client_t * client_open (const std::string & clientname);
     void get_jack_client_info ();
     int sync (jack_transport_state_t state = (jack_transport_state_t)(-1));
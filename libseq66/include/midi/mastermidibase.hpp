@@ -27,7 +27,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2016-11-23
- * \updates       2020-08-02
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  The mastermidibase module is the base-class version of the mastermidibus
@@ -36,10 +36,16 @@
  *  PortMidi.
  */
 
+#include <atomic>                       /* std::atomic<> capture pointer    */
 #include <vector>                       /* for channel-filtered recording   */
 
+#include "midi/activenotes.hpp"         /* seq66::activenotes note table    */
 #include "midi/businfo.hpp"             /* seq66::businfo & busarray        */
+#include "midi/eventscheduler.hpp"      /* seq66::eventscheduler            */
+#include "midi/midicapture.hpp"         /* seq66::midicapture               */
 #include "midi/midibus_common.hpp"      /* enum class e_clock, etc.         */
+#include "midi/outqueue.hpp"            /* seq66::outqueue lock-free queue  */
+#include "midi/outtransform.hpp"        /* seq66::outtransform              */
 #include "play/clockslist.hpp"          /* list of seq66::e_clock settings  */
 #include "play/inputslist.hpp"          /* list of boolean input settings   */
 #include "util/automutex.hpp"           /* seq66::recmutex recursive mutex  */
@@ -65,11 +71,25 @@ class mastermidibase
     friend class performer;
     friend class midi_alsa_info;
 
+public:
+
+    /**
+     *  The function called by the MIDI API in its own real-time thread, once
+     *  per period, when the API drives the sequencer (see engine()).  The
+     *  nframes parameter is the length of the period, and rate is the frame
+     *  rate.
+     */
+
+    using engine_callback = void (*)
+    (
+        void * arg, unsigned nframes, unsigned rate
+    );
+
 protected:
 
     /**
      *  The maximum number of busses supported.  Set to c_max_busses
-     *  (c_busscount_max = 32) for now.
+     *  (c_busscount_max = 64) for now.
      */
 
     int m_max_busses;
@@ -158,6 +178,100 @@ protected:
 
     sequence * m_seq;
 
+    /**
+     *  Holds the events rendered ahead of time by the output thread, until
+     *  their wall-clock deadlines arrive.  Inactive (lookahead of 0) unless
+     *  the performer enables it.
+     */
+
+    eventscheduler m_scheduler;
+
+    /**
+     *  One queue for each output buss, filled by play_at() without locking,
+     *  and emptied into m_scheduler (or sent, if the scheduler is off) by
+     *  the functions of the output cycle, which hold the mutex.  Allocated
+     *  by init() for the busses found by the MIDI API.
+     *
+     *  The drain keeps the mutex because it shares m_scheduler,
+     *  m_active_notes, and the busses (an ALSA client, for one) with
+     *  panic(), the port settings, and the MIDI thru of the input thread.
+     *  So the output thread locks m_mutex once per cycle, in end_cycle(),
+     *  and also in emit_clock() when clocks are sent, and in
+     *  schedule_origin() and dispatch() when the scheduler is active.
+     *  Uncontended, each lock is a pair of atomic operations.  Contended,
+     *  the cycle waits for the other caller, such as a SysEx sent to a full
+     *  JACK port (see midi_jack::api_sysex()).  In engine mode, the JACK
+     *  process callback instead tries the lock once per period, in
+     *  engine_begin(), and defers the period if it is busy.
+     */
+
+    outqueue m_outqueues[c_busscount_max];
+
+    /**
+     *  The notes sent and not yet released, on each channel of each output
+     *  buss.  Updated by send(), and used by panic() and all_notes_off() to
+     *  send only the Note Offs that are needed.
+     */
+
+    activenotes m_active_notes;
+
+    /**
+     *  The output transform of each buss, applied by send().  By default,
+     *  they change nothing.
+     */
+
+    outtransform m_bus_transforms[c_busscount_max];
+
+    /**
+     *  If greater than 0, the MIDI API can deliver events at a given time by
+     *  itself (the ALSA queue), and dispatch() hands over the events due
+     *  within this many microseconds, with their deadlines, instead of
+     *  sending each one when its deadline arrives.  See deliver_ahead().
+     */
+
+    long m_deliver_ahead_us;
+
+    /**
+     *  The latest deadline handed over to the MIDI API.  An event sent
+     *  right away is given this deadline, if it is still in the future, so
+     *  that it cannot overtake the events already handed over.  For
+     *  example, the Note Off sent when a pattern is muted must not arrive
+     *  before a pending Note On.
+     */
+
+    long m_deliver_until;
+
+    /**
+     *  If true, the output thread is running its cycles, and flush() only
+     *  notes that a drain is needed, in m_flush_pending.  Then end_cycle()
+     *  drains the output of all busses once, at the end of the cycle, so
+     *  that the events of a cycle (pattern events, clock, control output)
+     *  cost one system call instead of one per event or per buss.
+     */
+
+    bool m_batching;
+
+    /**
+     *  Set when flush() is called while batching.
+     */
+
+    bool m_flush_pending;
+
+    /**
+     *  If not null, output events are stored here instead of being sent.
+     *  Used by the performer to render a song offline.  Not owned.  Atomic
+     *  because play_at() tests it without locking.
+     */
+
+    std::atomic<midicapture *> m_capture;
+
+    /**
+     *  Counts the events sent on each buss since the last call to
+     *  cycle_counts(), for the playback statistics of the performer.
+     */
+
+    int m_bus_events[c_busscount_max];
+
     /**
      *  The locking mutex.  This object is passed to an automutex object that
      *  lends exception-safety to the mutex locking.
@@ -191,6 +305,7 @@ public:
         m_ppqn = ppqn;
         m_beats_per_minute = bpm;
         api_init(ppqn, bpm);
+        make_queues();
     }
 
     int get_num_out_buses () const
@@ -228,6 +343,27 @@ public:
         return m_dumping_input;
     }
 
+    /**
+     * \getter m_scheduler.active()
+     *      True if events rendered by the output thread are queued for
+     *      sending at their deadlines, instead of being sent right away.
+     */
+
+    bool scheduling () const
+    {
+        return m_scheduler.active();
+    }
+
+    /**
+     * \getter m_capture
+     *      True if output events are being captured instead of sent.
+     */
+
+    bool capturing () const
+    {
+        return not_nullptr(m_capture.load());
+    }
+
     /**
      * \getter m_seq
      *      Used only in performer::input_func() when not filtering MIDI input
@@ -244,13 +380,58 @@ public:
     void port_start (int client, int port);
     void port_exit (int client, int port);
     void play (bussbyte bus, event * e24, midibyte channel);
+    void play_off (bussbyte bus, event * e24, midibyte channel);
+    void play_at
+    (
+        bussbyte bus, event * e24, midibyte channel, midipulse tick
+    );
+    void lookahead_us (long us);
+    void schedule_origin (double tick, long us, midibpm bpm = 0.0);
+    long dispatch (long now);
+    void engine_dispatch (long start_us, long end_us, double frames_per_us);
+    bool engine_begin ();
+    void engine_end ();
+    void schedule_fixed (bool flag);
+    int dropped_events ();
+    void flush_scheduled ();
+    bool deliver_ahead (long us);
+    void batch_output (bool flag);
+    void end_cycle ();
+
+    /**
+     *  Asks the MIDI API to call the given function once per period from its
+     *  process callback.  Only JACK supports this.
+     *
+     * \param cb
+     *      The function to call, or null to stop the calls.
+     *
+     * \param arg
+     *      The first parameter passed to the function.
+     *
+     * \return
+     *      Returns true if the API will make the calls.
+     */
+
+    bool engine (engine_callback cb, void * arg)
+    {
+        return api_engine(cb, arg);
+    }
+
+    void capture (midicapture * cap);
+    void capture_tick (midipulse tick);
+    int cycle_counts (std::vector<int> & counts);
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
-    void emit_clock (midipulse tick);
+    void emit_clock
+    (
+        double tick, midipulse horizon = c_null_midipulse
+    );
     void sysex (event * event);
     void print () const;
     void flush ();
     void panic ();                                          /* kepler34 func  */
+    void all_notes_off ();
+    bool bus_transform (bussbyte bus, const outtransform & ot);
     void dump_midi_input (event in);                        /* seq32 function */
     std::string get_midi_out_bus_name (bussbyte bus);
     std::string get_midi_in_bus_name (bussbyte bus);
@@ -271,6 +452,17 @@ public:
         return api_get_midi_event(in);
     }
 
+    /**
+     *  Gets the arrival time of the event last obtained by get_midi_event(),
+     *  in microtime() microseconds, as stamped by the MIDI API.  Returns 0
+     *  if the API does not stamp input events.
+     */
+
+    long input_time_us ()
+    {
+        return api_input_time();
+    }
+
     bool set_clock (bussbyte bus, e_clock clock_type);
     bool set_input (bussbyte bus, bool inputing);
     bool get_input (bussbyte bus);
@@ -420,6 +612,57 @@ protected:
         // no code for portmidi
     }
 
+    /**
+     *  Provides MIDI API-specific functionality for the engine() function.
+     */
+
+    virtual bool api_engine (engine_callback /* cb */, void * /* arg */)
+    {
+        return false;                   /* no code for base, alsa, portmidi */
+    }
+
+    /**
+     *  Sets the frame offset, in the current period, of the events sent
+     *  next.  Used only by engine_dispatch(); -1 restores the default.
+     */
+
+    virtual void api_frame_offset (int /* offset */)
+    {
+        // no code for base, alsa, or portmidi
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the deliver_ahead()
+     *  function.  Returns true if the API can deliver events at a given
+     *  time, and is ready to do so.
+     */
+
+    virtual bool api_timed_output (bool /* flag */)
+    {
+        return false;                   /* no code for base, jack, portmidi */
+    }
+
+    /**
+     *  Sets the delivery time, in microtime() microseconds, of the events
+     *  sent next.  Used only when api_timed_output() succeeded; 0 restores
+     *  immediate sending.
+     */
+
+    virtual void api_deliver_at (long /* us */)
+    {
+        // no code for base, jack, or portmidi
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the input_time_us()
+     *  function.
+     */
+
+    virtual long api_input_time ()
+    {
+        return 0;                       /* no code for base, jack, portmidi */
+    }
+
     virtual bool api_get_midi_event (event * inev) = 0;
     virtual int api_poll_for_midi ();
 
@@ -438,6 +681,12 @@ private:
 
     bool save_clock (bussbyte bus, e_clock clock);
     bool save_input (bussbyte bus, bool inputing);
+    void send (bussbyte bus, event * e24, midibyte channel);
+    void deliver (bussbyte bus, event * e24, midibyte channel);
+    void send_slot (const schedslot & slot, event & e);
+    void send_note_offs ();
+    void make_queues ();
+    void drain_queues ();
 
 };          // class mastermidibase
 
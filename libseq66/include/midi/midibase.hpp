@@ -27,7 +27,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2016-11-24
- * \updates       2020-05-27
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  The midibase module is the new base class for the various implementations
@@ -38,7 +38,6 @@
 #include "app_limits.h"                 /* SEQ66_USE_DEFAULT_PPQN           */
 #include "midi/midibus_common.hpp"      /* values and e_clock enumeration   */
 #include "midi/midibytes.hpp"           /* seq66::midibyte alias            */
-#include "util/automutex.hpp"           /* seq66::recmutex recursive mutex  */
 
 /**
  *  Macros for selecting input versus output ports in a more obvious way.
@@ -179,7 +178,8 @@ private:
     std::string m_port_name;
 
     /**
-     *  The last (most recent? final?) tick.
+     *  The last tick covered by the MIDI clock.  Clocks are sent (or
+     *  scheduled) for the multiples of PPQN / 24 that follow it.
      */
 
     midipulse m_lasttick;
@@ -210,12 +210,6 @@ private:
 
     bool m_is_system_port;
 
-    /**
-     *  Locking mutex. This one is based on std:::recursive_mutex.
-     */
-
-    recmutex m_mutex;
-
 public:
 
     midibase
@@ -451,6 +445,8 @@ public:
     void start ();
     void stop ();
     void clock (midipulse tick);
+    midipulse next_clock (midipulse tick);
+    void send_clock (midipulse tick);
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
     void print ();
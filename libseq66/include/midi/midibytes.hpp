@@ -28,7 +28,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2018-11-09
- * \updates       2019-12-11
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  These alias specifications are intended to remove the ambiguity we have
@@ -193,10 +193,11 @@ const midishort c_midishort_max     = midishort(0xFFFF);
 const midilong c_midilong_max       = midilong(0xFFFFFFFF);
 
 /**
- *  Default value for c_max_busses.
+ *  Default value for c_max_busses.  JACK can easily provide more ports than
+ *  the 16 of the usual ALSA set-up, so this allows for 64 busses.
  */
 
-const int c_busscount_max           = 32;
+const int c_busscount_max           = 64;
 
 /**
  *  Indicates the maximum number of MIDI channels, counted internally from 0
@@ -494,7 +495,7 @@ is_null_midipulse (midipulse p)
 
 /**
  *  Compares a bussbyte value to the maximum value.  The maximum value is well
- *  over the c_busscount_max = 32 value, being 0xff = 255, and thus is a useful
+ *  over the c_busscount_max = 64 value, being 0xff = 255, and thus is a useful
  *  flag value to indicate an unusable bussbyte.
  */
 
@@ -0,0 +1,166 @@
+#if ! defined SEQ66_MIDICAPTURE_HPP
+#define SEQ66_MIDICAPTURE_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midicapture.hpp
+ *
+ *  This module declares an in-memory sink for the output of the performer.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  When a midicapture object is attached to the master buss, the events
+ *  that the performer would send to the output busses are stored here
+ *  instead, each with the pulse at which it would have sounded.  The
+ *  performer uses this to render ("bounce") a song offline, as fast as the
+ *  CPU allows, and the midifile class then writes the result as an SMF 0 or
+ *  SMF 1 file.  Since the events come from performer::play(), the render
+ *  includes everything that live playback does: mutes, queueing, one-shots,
+ *  and transposition.
+ */
+
+#include <vector>                       /* std::vector                      */
+
+#include "midi/midibytes.hpp"           /* seq66::midipulse, midibyte, etc. */
+#include "midi/tempomap.hpp"            /* seq66::tempomap::changes         */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+    class event;
+
+/**
+ *  A captured channel event.  The status byte includes the channel.
+ */
+
+struct capturedevent
+{
+    midipulse ce_tick;          /**< The pulse at which it was played.      */
+    unsigned ce_order;          /**< Capture order, keeps sorting stable.   */
+    bussbyte ce_bus;            /**< The output buss.                       */
+    midibyte ce_status;         /**< Status byte, with the channel.         */
+    midibyte ce_d0;             /**< First data byte.                       */
+    midibyte ce_d1;             /**< Second data byte, if used.             */
+};
+
+/**
+ *  Holds captured events and tempo changes.  This class does no locking;
+ *  the master buss does that.
+ */
+
+class midicapture
+{
+
+public:
+
+    using events = std::vector<capturedevent>;
+
+private:
+
+    /**
+     *  The events, in the order played until sort() is called.
+     */
+
+    events m_events;
+
+    /**
+     *  The tempo changes seen during the render.  The first one is the
+     *  starting tempo.
+     */
+
+    tempomap::changes m_tempos;
+
+    /**
+     *  The pulse to apply to events played without one, such as the Note
+     *  Offs sent when a pattern is muted.  Set by the performer as its
+     *  virtual clock advances.
+     */
+
+    midipulse m_tick;
+
+    /**
+     *  Incremented for every captured event.
+     */
+
+    unsigned m_order;
+
+public:
+
+    midicapture ();
+
+    midipulse tick () const
+    {
+        return m_tick;
+    }
+
+    void tick (midipulse t)
+    {
+        m_tick = t;
+    }
+
+    bool empty () const
+    {
+        return m_events.empty();
+    }
+
+    int count () const
+    {
+        return int(m_events.size());
+    }
+
+    const events & captured () const
+    {
+        return m_events;
+    }
+
+    const tempomap::changes & tempos () const
+    {
+        return m_tempos;
+    }
+
+    void add
+    (
+        bussbyte bus,
+        const event & e,
+        midibyte channel,
+        midipulse tick = c_null_midipulse
+    );
+    void add_tempo (midipulse tick, midibpm bpm);
+    void sort ();
+    void clear ();
+
+};          // class midicapture
+
+}           // namespace seq66
+
+#endif      // SEQ66_MIDICAPTURE_HPP
+
+/*
+ * midicapture.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -27,7 +27,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2019-11-24
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  The Seq24 MIDI file is a standard, Format 1 MIDI file, with some extra
@@ -124,6 +124,7 @@ namespace seq66
      */
 
     class event;
+    class midicapture;
     class midi_splitter;
     class midi_vector;
     class performer;
@@ -283,6 +284,13 @@ public:
     virtual bool write (performer & p, bool doseqspec = true);
 
     bool write_song (performer & p);
+    bool write_capture
+    (
+        const midicapture & cap,
+        int format,
+        int beatsperbar,
+        int beatwidth
+    );
 
     const std::string & error_message () const
     {
@@ -415,7 +423,7 @@ protected:
     void write_seq_number (midishort seqnum);
     int read_seq_number ();
     void write_track_end ();
-    bool write_header (int numtracks);
+    bool write_header (int numtracks, int format = 1);
 #if defined USE_WRITE_START_TEMPO
     void write_start_tempo (midibpm start_tempo);
 #endif
@@ -431,6 +439,15 @@ protected:
     bool set_error_dump (const std::string & msg);
     bool set_error_dump (const std::string & msg, unsigned long p);
     void write_track (const midi_vector & lst);
+    void write_capture_track
+    (
+        const midicapture & cap,
+        const std::string & name,
+        int beatsperbar,
+        int beatwidth,
+        bool meta,
+        int bus
+    );
 
     /**
      *  Returns the size of a sequence-number event, which is always 5
@@ -485,6 +502,13 @@ extern bool write_midi_file
     const std::string & fn,
     std::string & errmsg
 );
+extern bool bounce_midi_file
+(
+    performer & p,
+    const std::string & fn,
+    int format,
+    std::string & errmsg
+);
 
 }           // namespace seq66
 
@@ -0,0 +1,120 @@
+#if ! defined SEQ66_OUTQUEUE_HPP
+#define SEQ66_OUTQUEUE_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          outqueue.hpp
+ *
+ *  This module declares a lock-free queue of outgoing MIDI events for one
+ *  output buss.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  The thread that renders the patterns (the output thread, or the JACK
+ *  process callback in engine mode) is the only producer.  It pushes the
+ *  raw bytes of each channel event, with its pulse, without taking any
+ *  lock.  The master buss is the consumer.  It empties the queues while
+ *  holding its mutex, which serializes the consumers, and hands the events
+ *  to its scheduler or to the busses.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <vector>                       /* std::vector                      */
+
+#include "midi/midibytes.hpp"           /* seq66::midipulse, midibyte, etc. */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+    class event;
+
+/**
+ *  The number of events each queue can hold.  Must be a power of 2.  A
+ *  full queue is not an error; the master buss then takes the locked path.
+ */
+
+const unsigned c_outqueue_size = 512;
+
+/**
+ *  Holds a channel event rendered for one buss.  Only the bytes needed to
+ *  rebuild the event are kept.
+ */
+
+struct outslot
+{
+    midipulse os_tick;          /**< The pulse at which the event sounds.   */
+    midibyte os_channel;        /**< Channel to be applied to the status.   */
+    midibyte os_status;         /**< Status byte of the event.              */
+    midibyte os_d0;             /**< First data byte.                       */
+    midibyte os_d1;             /**< Second data byte.                      */
+};
+
+/**
+ *  A fixed-size single-producer, single-consumer ring of outslot objects.
+ *  The indices run freely; their difference is the number of events held.
+ *  The ring is empty, and push() fails, until allocate() is called.
+ */
+
+class outqueue
+{
+
+private:
+
+    std::vector<outslot> m_ring;
+    unsigned m_mask;
+    std::atomic<unsigned> m_head;       /**< Next slot to write.            */
+    std::atomic<unsigned> m_tail;       /**< Next slot to read.             */
+
+public:
+
+    outqueue ();
+
+    outqueue (const outqueue &) = delete;
+    outqueue & operator = (const outqueue &) = delete;
+
+    void allocate (unsigned size = c_outqueue_size);
+    bool push (midibyte channel, const event & e, midipulse tick);
+    bool pop (outslot & slot);
+    void clear ();
+
+    bool empty () const
+    {
+        return m_head.load(std::memory_order_acquire) ==
+            m_tail.load(std::memory_order_relaxed);
+    }
+
+};          // class outqueue
+
+}           // namespace seq66
+
+#endif      // SEQ66_OUTQUEUE_HPP
+
+/*
+ * outqueue.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
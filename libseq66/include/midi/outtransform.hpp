@@ -0,0 +1,163 @@
+#if ! defined SEQ66_OUTTRANSFORM_HPP
+#define SEQ66_OUTTRANSFORM_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          outtransform.hpp
+ *
+ *  This module declares a transformation applied to events as they are
+ *  played.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  An outtransform changes the copy of an event that is sent to a buss,
+ *  never the event stored in the pattern.  It can transpose the notes,
+ *  scale the Note On velocities, move the event to another channel, and
+ *  keep the notes inside a range.  Transforms are stacked by applying them
+ *  one after the other to the same copy: the performer's transpose and the
+ *  transform of the pattern (see sequence::put_event_on_bus()), then the
+ *  transform of the buss (see mastermidibase::send()).
+ *
+ *  Since the same transform is applied to the Note Offs sent when a pattern
+ *  is stopped, they match the Note Ons that were sent, as long as the
+ *  transform is not changed while notes are sounding.  If it is, the notes
+ *  left sounding are caught by mastermidibase::all_notes_off().
+ */
+
+#include "midi/midibytes.hpp"           /* seq66::midibyte, etc.            */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+    class event;
+
+/**
+ *  The velocity scale, in percent, that leaves velocities unchanged.  The
+ *  largest scale allowed is c_velocity_scale_max.
+ */
+
+const int c_velocity_scale_default = 100;
+const int c_velocity_scale_max = 400;
+
+/**
+ *  Holds the settings of one output transform.  The default transform
+ *  changes nothing.
+ */
+
+class outtransform
+{
+
+private:
+
+    /**
+     *  The number of semitones by which to transpose notes and Aftertouch.
+     *  A note moved outside of the MIDI range is left as is.
+     */
+
+    int m_transpose;
+
+    /**
+     *  The scale applied to the velocity of each Note On, in percent.  A
+     *  Note On is never scaled down to 0, which would make it a Note Off.
+     */
+
+    int m_velocity;
+
+    /**
+     *  The channel to which channel events are moved, or c_midibyte_max to
+     *  keep the channel.
+     */
+
+    midibyte m_channel;
+
+    /**
+     *  The range to which notes are clamped, after transposition.
+     */
+
+    midibyte m_note_min;
+    midibyte m_note_max;
+
+public:
+
+    outtransform ();
+
+    void transpose (int semitones);
+    void velocity (int percent);
+    void channel (midibyte ch);
+    void note_range (int notemin, int notemax);
+    void apply (event & e, midibyte & ch) const;
+
+    /**
+     * \return
+     *      Returns true if the transform changes nothing, so that apply()
+     *      and the copy of the event can be skipped.
+     */
+
+    bool identity () const
+    {
+        return m_transpose == 0 &&
+            m_velocity == c_velocity_scale_default &&
+            is_null_channel(m_channel) &&
+            m_note_min == 0 && m_note_max == c_midibyte_data_max - 1;
+    }
+
+    int transpose () const
+    {
+        return m_transpose;
+    }
+
+    int velocity () const
+    {
+        return m_velocity;
+    }
+
+    midibyte channel () const
+    {
+        return m_channel;
+    }
+
+    midibyte note_min () const
+    {
+        return m_note_min;
+    }
+
+    midibyte note_max () const
+    {
+        return m_note_max;
+    }
+
+};          // class outtransform
+
+}           // namespace seq66
+
+#endif      // SEQ66_OUTTRANSFORM_HPP
+
+/*
+ * outtransform.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,170 @@
+#if ! defined SEQ66_PLAYEVENTS_HPP
+#define SEQ66_PLAYEVENTS_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playevents.hpp
+ *
+ *  This module declares the compact copy of a pattern's events used for
+ *  playback.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  A seq66::event is built for editing: it holds its links, selection and
+ *  marking flags, and a vector for SysEx and Meta data, which makes it much
+ *  larger than a cache line.  sequence::play() only needs the time and the
+ *  bytes of each event, so it reads them from a playevents array instead,
+ *  rebuilt from the event list after each change to the pattern.  Each
+ *  record is 16 bytes, so the scan of a frame streams through contiguous
+ *  memory.
+ *
+ *  SysEx and Meta events are not played by sequence::play(), so they are
+ *  left out, except for tempo events, whose values are kept in a side
+ *  array indexed by the record.
+ */
+
+#include <cstdint>                      /* std::uint16_t                    */
+#include <vector>                       /* std::vector                      */
+
+#include "midi/event.hpp"               /* seq66::event                     */
+#include "midi/midibytes.hpp"           /* seq66::midipulse, midibyte, etc. */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+    class eventlist;
+
+/**
+ *  The playback form of an event.  The status has its channel nybble
+ *  cleared, as in seq66::event, and the channel is kept apart.
+ */
+
+struct playevent
+{
+    midipulse pe_timestamp;     /**< The pulse of the event in the pattern. */
+    midibyte pe_status;         /**< Status byte, channel nybble cleared.   */
+    midibyte pe_channel;        /**< Channel of the event itself.           */
+    midibyte pe_d0;             /**< First data byte.                       */
+    midibyte pe_d1;             /**< Second data byte.                      */
+    midibyte pe_flags;          /**< See c_playevent_tempo.                 */
+    std::uint16_t pe_extra;     /**< Index of the tempo of a tempo event.   */
+};
+
+/**
+ *  Marks a tempo event in playevent::pe_flags.
+ */
+
+const midibyte c_playevent_tempo = 0x01;
+
+/**
+ *  The compact array of the events of one pattern, in time order.
+ */
+
+class playevents
+{
+
+private:
+
+    /**
+     *  The records, one for each event that can be played.
+     */
+
+    std::vector<playevent> m_events;
+
+    /**
+     *  The tempos of the tempo events, in beats per minute.
+     */
+
+    std::vector<midibpm> m_tempos;
+
+public:
+
+    playevents ();
+
+    void build (const eventlist & evl);
+    void clear ();
+
+    /**
+     *  Loads a record into an event, for sending.  Only the status, channel,
+     *  and data bytes are set, which is all that the busses use.  Inline,
+     *  since it is called for every event played.
+     *
+     * \param pe
+     *      The record.
+     *
+     * \param [out] e
+     *      The event to fill, normally one kept for the purpose by the
+     *      caller.
+     */
+
+    void fill (const playevent & pe, event & e) const
+    {
+        e.set_channel_status(pe.pe_status, pe.pe_channel);
+        e.set_data(pe.pe_d0, pe.pe_d1);
+    }
+
+    bool empty () const
+    {
+        return m_events.empty();
+    }
+
+    size_t size () const
+    {
+        return m_events.size();
+    }
+
+    const playevent & operator [] (size_t i) const
+    {
+        return m_events[i];
+    }
+
+    std::vector<playevent>::const_iterator begin () const
+    {
+        return m_events.begin();
+    }
+
+    std::vector<playevent>::const_iterator end () const
+    {
+        return m_events.end();
+    }
+
+    midibpm tempo (const playevent & pe) const
+    {
+        return m_tempos[pe.pe_extra];
+    }
+
+};          // class playevents
+
+}           // namespace seq66
+
+#endif      // SEQ66_PLAYEVENTS_HPP
+
+/*
+ * playevents.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
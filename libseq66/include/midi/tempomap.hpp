@@ -0,0 +1,151 @@
+#if ! defined SEQ66_TEMPOMAP_HPP
+#define SEQ66_TEMPOMAP_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tempomap.hpp
+ *
+ *  This module declares a map of the tempo changes of a song, for converting
+ *  between pulses and time.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  In Live mode, a Set Tempo event in a pattern changes the tempo when it is
+ *  played, which is all we can do, since we cannot know what will play
+ *  next.  In Song mode, the triggers fix where each tempo event lands in the
+ *  song, so we can collect them all ahead of time.  The performer then
+ *  converts between pulses and microseconds from the start of the song by
+ *  binary search, rather than by integrating the current tempo.  Seeking to
+ *  a position, positioning JACK transport, and pacing the MIDI clock are then
+ *  exact, and playback no longer needs to change the tempo as a side effect.
+ *
+ *  Seq32 has a "tempo list" of its own that serves the same purpose.
+ *
+ *  A tempomap does no locking.  The performer rebuilds its own map on the
+ *  control side, and publishes a copy of it with each play-set snapshot
+ *  (see playsnapshot), which the output thread reads without locking.
+ */
+
+#include <vector>                       /* std::vector                      */
+
+#include "midi/midibytes.hpp"           /* seq66::midipulse, midibpm        */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  A tempo change at a given pulse in the song.
+ */
+
+struct tempochange
+{
+    midipulse tc_tick;          /**< The song pulse of the change.          */
+    midibpm tc_bpm;             /**< The new tempo.                         */
+};
+
+/**
+ *  A sorted list of constant-tempo segments.
+ */
+
+class tempomap
+{
+
+public:
+
+    /**
+     *  The list of changes gathered from the patterns, in no special order.
+     */
+
+    using changes = std::vector<tempochange>;
+
+    /**
+     *  A stretch of the song with a constant tempo.  It runs from ts_tick to
+     *  the ts_tick of the next segment.
+     */
+
+    struct segment
+    {
+        midipulse ts_tick;      /**< The first pulse of the segment.        */
+        midibpm ts_bpm;         /**< The tempo of the segment.              */
+        double ts_us;           /**< Microseconds from pulse 0 to ts_tick.  */
+        double ts_pulse_us;     /**< The length of a pulse in the segment.  */
+    };
+
+private:
+
+    /**
+     *  The segments, sorted by pulse.  The first segment always starts at
+     *  pulse 0, and holds the starting tempo.
+     */
+
+    std::vector<segment> m_segments;
+
+    /**
+     *  The PPQN used to convert the tempos to pulse lengths.
+     */
+
+    int m_ppqn;
+
+    /**
+     *  True if at least one tempo event was found.  If false, the map holds
+     *  only the starting tempo, and the caller should use the current tempo
+     *  as before.
+     */
+
+    bool m_active;
+
+public:
+
+    tempomap ();
+
+    void rebuild (midibpm bpm, int ppqn, changes & list);
+    void clear (midibpm bpm, int ppqn);
+    bool active () const;
+    int count () const;
+    midibpm bpm_at (double tick) const;
+    double tick_to_us (double tick) const;
+    double us_to_tick (double us) const;
+    double advance (double tick, long us) const;
+    changes segments () const;
+
+private:
+
+    size_t segment_at_tick (double tick) const;
+    size_t segment_at_us (double us) const;
+
+};          // class tempomap
+
+}           // namespace seq66
+
+#endif      // SEQ66_TEMPOMAP_HPP
+
+/*
+ * tempomap.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -5,7 +5,7 @@
  * \file          daemonize.hpp
  * \author        Chris Ahlstrom
  * \date          2005-07-03 to 2007-08-21 (from xpc-suite project)
- * \updates       2020-09-07
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *    Daemonization of POSIX C Wrapper (PSXC) library
@@ -88,6 +88,7 @@ extern bool pid_exists (const std::string & exename);
 extern void session_setup ();
 extern bool session_close ();
 extern bool session_save ();
+extern bool session_stats ();
 
 }        // namespace seq66
 
@@ -0,0 +1,87 @@
+#if ! defined SEQ66_RTTHREAD_HPP
+#define SEQ66_RTTHREAD_HPP
+
+/**
+ * \file          rtthread.hpp
+ * \author        Chris Ahlstrom
+ * \date          2020-11-23
+ * \updates       2020-11-23
+ * \license       GNU GPLv2 or above
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or (at
+ *    your option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful, but
+ *    WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *    02110-1301, USA.
+ *
+ *    This module provides functions to give a thread a real-time scheduling
+ *    policy and priority, to pin it to a set of CPUs, and to lock the memory
+ *    of the process.  When the process lacks the permission to do so, the
+ *    functions report what limit stands in the way and how to raise it.
+ *    These functions do something only in Linux; elsewhere they warn that
+ *    the setting is not supported.
+ */
+
+#include <string>
+#include <thread>                       /* std::thread                      */
+#include <vector>                       /* std::vector                      */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  The scheduling policies that can be configured.  "normal" leaves the
+ *  thread alone (SCHED_OTHER).
+ */
+
+enum class threadpolicy
+{
+    normal,
+    fifo,
+    rr
+};
+
+/*
+ *  Free functions.
+ */
+
+extern threadpolicy string_to_threadpolicy (const std::string & s);
+extern std::string threadpolicy_to_string (threadpolicy p);
+extern bool parse_cpu_list (const std::string & s, std::vector<int> & cpus);
+extern bool set_thread_policy
+(
+    std::thread & t,
+    const std::string & threadname,
+    threadpolicy policy,
+    int priority
+);
+extern bool set_thread_affinity
+(
+    std::thread & t,
+    const std::string & threadname,
+    const std::string & cpulist
+);
+extern bool lock_memory ();
+
+}           // namespace seq66
+
+#endif      // SEQ66_RTTHREAD_HPP
+
+/*
+ * rtthread.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
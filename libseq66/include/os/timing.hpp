@@ -5,7 +5,7 @@
  * \file          daemonize.hpp
  * \author        Chris Ahlstrom
  * \date          2005-07-03 to 2007-08-21 (from xpc-suite project)
- * \updates       2020-07-06
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *    Daemonization of POSIX C Wrapper (PSXC) library
@@ -42,10 +42,93 @@ namespace seq66
  */
 
 extern bool microsleep (int us);
+extern bool microsleep_until (long deadline_us);
 extern bool millisleep (int ms);
 extern long microtime ();
 extern long millitime ();
 
+/**
+ *  Provides a fixed grid of wakeups for a periodic thread, such as the
+ *  performer's output thread.  The grid points are absolute microtime()
+ *  values, so errors in one cycle do not push back the following cycles.
+ *  Each wakeup records how late it was, and the timer keeps an "anticipation"
+ *  value, adjusted from the running lateness, that is subtracted from the
+ *  sleep; the remainder is spent yielding the processor.  This corrects for
+ *  the typical wakeup latency of the kernel on a loaded system.
+ */
+
+class cycletimer
+{
+
+private:
+
+    long m_period_us;           /**< The distance between grid points.      */
+    long m_next_us;             /**< The next grid point (deadline).        */
+    long m_anticipation_us;     /**< How much earlier than the deadline to  */
+                                /**< wake up, then yield until it.          */
+    long m_max_anticipation_us; /**< The limit of m_anticipation_us.        */
+    long m_lateness_us;         /**< The lateness of the last wakeup.       */
+    long m_max_lateness_us;     /**< The worst lateness since start().      */
+    long m_total_lateness_us;   /**< Sum of lateness, for the average.      */
+    long m_wakeups;             /**< Number of wakeups since start().       */
+    long m_overruns;            /**< Grid points missed completely.         */
+
+public:
+
+    cycletimer (long period_us = 0);
+
+    void start (long period_us, long now = microtime());
+    bool sleep_until (long deadline_us);
+    long advance (long now = microtime());
+    void max_anticipation_us (long us);
+
+    long period_us () const
+    {
+        return m_period_us;
+    }
+
+    long next_us () const
+    {
+        return m_next_us;
+    }
+
+    long lateness_us () const
+    {
+        return m_lateness_us;
+    }
+
+    long max_lateness_us () const
+    {
+        return m_max_lateness_us;
+    }
+
+    long average_lateness_us () const
+    {
+        return m_wakeups > 0 ? m_total_lateness_us / m_wakeups : 0 ;
+    }
+
+    long anticipation_us () const
+    {
+        return m_anticipation_us;
+    }
+
+    long max_anticipation_us () const
+    {
+        return m_max_anticipation_us;
+    }
+
+    long wakeups () const
+    {
+        return m_wakeups;
+    }
+
+    long overruns () const
+    {
+        return m_overruns;
+    }
+
+};          // class cycletimer
+
 }        // namespace seq66
 
 #endif   // SEQ66_TIMING_HPP
@@ -28,7 +28,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2018-11-12
- * \updates       2020-11-17
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  */
@@ -43,6 +43,9 @@
 #include "play/inputslist.hpp"          /* list of boolean input settings   */
 #include "play/mutegroups.hpp"          /* class seq66::mutegroups          */
 #include "play/playlist.hpp"            /* seq66::playlist                  */
+#include "midi/tempomap.hpp"            /* seq66::tempomap                  */
+#include "play/playsnapshot.hpp"        /* seq66::playsnapshot              */
+#include "play/playstats.hpp"           /* seq66::playstats                 */
 #include "play/sequence.hpp"            /* seq66::sequence                  */
 #include "play/setmapper.hpp"           /* seq66::seqmanager and seqstatus  */
 #include "util/condition.hpp"           /* seq66::condition (variable)      */
@@ -51,6 +54,7 @@
 #include <set>                          /* std::set, arbitary selection     */
 #endif
 
+#include <atomic>                       /* std::atomic<> engine flags       */
 #include <memory>                       /* std::shared_ptr<>, unique_ptr<>  */
 #include <vector>                       /* std::vector<>                    */
 #include <thread>                       /* std::thread                      */
@@ -324,6 +328,101 @@ private:
 
     std::vector<seq::pointer> m_play_set;
 
+    /**
+     *  The copy of m_play_set that is iterated by the output thread in
+     *  play().  It is published by fill_play_set() each time m_play_set is
+     *  refilled, and is read without locks or reference-counting.  The other
+     *  users of m_play_set are on the control side, and use it directly.
+     */
+
+    playsnapshot m_play_snapshot;
+
+    /**
+     *  The tempo changes of the play-set in Song mode, located by the
+     *  triggers.  Rebuilt by build_tempo_map() on the control side whenever
+     *  the play-set, a pattern, or a trigger changes.  When active, Song
+     *  mode paces the output thread, JACK transport, and MIDI clock from
+     *  the map, and tempo events are not applied as they are played.  The
+     *  output thread does not read this map, but the copy published with
+     *  each play-set snapshot.
+     */
+
+    tempomap m_tempo_map;
+
+    /**
+     *  Whether m_tempo_map holds a tempo change, for tempo_map_active(),
+     *  which the output thread also calls.
+     */
+
+    std::atomic<bool> m_tempo_map_active;
+
+    /**
+     *  The timing statistics of the output thread: wakeup lateness, the
+     *  duration of play(), and the events sent per cycle.  Always kept, and
+     *  readable from any thread.
+     */
+
+    playstats m_play_stats;
+
+    /**
+     *  Receives the per-buss event counts from the master buss at the end of
+     *  each output cycle.  Its capacity is reserved up front, so that the
+     *  output thread does not allocate.
+     */
+
+    std::vector<int> m_cycle_counts;
+
+    /**
+     *  True if the JACK process callback drives playback (the "jack_engine"
+     *  option), instead of the output thread.  Set in launch() if the MIDI
+     *  API accepts the engine function.
+     */
+
+    bool m_engine_active;
+
+    /**
+     *  Set by the output thread while playback is running in engine mode.
+     *  Checked by engine_cycle() in the JACK thread.
+     */
+
+    std::atomic<bool> m_engine_play;
+
+    /**
+     *  Set by engine_cycle() while it runs, so that the output thread can
+     *  wait for the last cycle to finish when playback stops.
+     */
+
+    std::atomic<bool> m_engine_busy;
+
+    /**
+     *  The (fractional) pulse at the start of the next engine period.  Used
+     *  only by engine_cycle(), once playback has started.
+     */
+
+    double m_engine_tick;
+
+    /**
+     *  The (fractional) pulse of the MIDI clock in engine mode.  Unlike
+     *  m_engine_tick, it does not jump back when the song loops.
+     */
+
+    double m_engine_clock;
+
+    /**
+     *  The number of frames played since the engine was started, the time
+     *  base of the lookahead scheduler in engine mode.
+     */
+
+    long long m_engine_frames;
+
+    /**
+     *  The number of frames of the periods not yet rendered, because the
+     *  master buss was busy when they came (see engine_cycle()).  They are
+     *  rendered with the next period.
+     */
+
+    long long m_engine_pending;
+
     /**
      *  Provides an optional play-list, loosely patterned after Stazed's Seq32
      *  play-list. Important: This object is now owned by perform.
@@ -720,6 +819,14 @@ private:
 
     mutable midipulse m_tick;
 
+    /**
+     *  The microtime() at which the output thread set m_tick, or 0 if not
+     *  playing.  Used by input_tick() to place a recorded event at the pulse
+     *  of its arrival time, as stamped by the MIDI API.
+     */
+
+    std::atomic<long> m_tick_us;
+
     /**
      *  Let's try to save the last JACK pad structure tick for re-use with
      *  resume after pausing.
@@ -1491,6 +1598,7 @@ public:
     bool init_jack_transport ();
     bool deinit_jack_transport ();
     void position_jack (bool state, midipulse tick = 0);
+    void position_jack (bool state, midipulse tick, const tempomap * tmap);
     bool set_jack_mode (bool mode);
 
     void toggle_jack_mode ()
@@ -1600,6 +1708,33 @@ public:
         return m_song_start_mode == sequence::playback::song;
     }
 
+    const tempomap & tempo_map () const
+    {
+        return m_tempo_map;
+    }
+
+    playstats & play_stats ()
+    {
+        return m_play_stats;
+    }
+
+    const playstats & play_stats () const
+    {
+        return m_play_stats;
+    }
+
+    bool report_play_stats () const;
+
+    /**
+     *  True if Song mode is in force and the tempo map holds at least one
+     *  tempo change.  The map is not used when slaved to MIDI clock.
+     */
+
+    bool tempo_map_active () const
+    {
+        return song_mode() && ! m_usemidiclock && m_tempo_map_active;
+    }
+
     bool live_mode (sequence::playback p) const
     {
         return p == sequence::playback::live;
@@ -1725,6 +1860,7 @@ public:
     bool clear_all (bool clearplaylist = false);
     bool clear_song ();
     bool launch (int ppqn);
+    bool create_master_bus ();
     bool finish ();
     bool activate ();
     bool new_sequence (seq::number seq = seq::unassigned());
@@ -1755,7 +1891,19 @@ public:
     void auto_stop ();
     void auto_pause ();
     void auto_play ();
-    void play (midipulse tick);
+    void play
+    (
+        midipulse tick,
+        midipulse rendertick = c_null_midipulse,
+        bool nowait = false
+    );
+    void fill_play_set ();
+    void build_tempo_map ();
+    const tempomap * published_tempo_map
+    (
+        const playsnapshot::snapshot & ps
+    ) const;
+    bool bounce (midicapture & cap, midipulse endtick, std::string & errmsg);
     void all_notes_off ();
 
     void unqueue_sequences (int hotseq)
@@ -2774,7 +2922,6 @@ private:
     bool set_overwrite_recording (seq::number seqno, bool active, bool toggle);
     bool set_thru (seq::number seqno, bool active, bool toggle);
     bool log_current_tempo ();
-    bool create_master_bus ();
     void reset_sequences (bool pause = false);
 
 #if defined USE_STAZED_PARSE_SYSEX
@@ -2906,10 +3053,23 @@ private:
 private:
 
     void output_func ();
+    void engine_run (double tick);
+    void engine_cycle (unsigned nframes, unsigned rate);
+    void engine_render (unsigned nframes, unsigned rate);
+    static void engine_callback (void * arg, unsigned nframes, unsigned rate);
     void input_func ();
     bool poll_cycle ();
+    midipulse input_tick ();
     void launch_input_thread ();
     void launch_output_thread ();
+    void set_thread_scheduling
+    (
+        std::thread & t,
+        const std::string & threadname,
+        const std::string & policyname,
+        int priority,
+        const std::string & cpus
+    );
 
     condition & cv ()
     {
@@ -0,0 +1,199 @@
+#if ! defined SEQ66_PLAYSNAPSHOT_HPP
+#define SEQ66_PLAYSNAPSHOT_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playsnapshot.hpp
+ *
+ *  This module declares an immutable, atomically-published copy of the
+ *  performer's play-set, for use by the output thread.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-23
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  The control side (user-interface, MIDI control, session handling) rebuilds
+ *  the play-set whenever the playing screenset or its patterns change.  The
+ *  output thread iterates the play-set on every output cycle.  Rather than
+ *  have the output thread copy a std::shared_ptr (an atomic increment and
+ *  decrement) for every pattern, or lock a mutex, the control side publishes
+ *  each new play-set as a snapshot:  an array of raw sequence pointers plus
+ *  a generation number.  The pointer to the current snapshot is swapped
+ *  atomically.
+ *
+ *  Reclamation is RCU-like.  The output thread, the only reader, marks the
+ *  snapshot it is using (a single "hazard pointer").  A replaced snapshot is
+ *  retired, and is deleted by a later publish() only when the output thread
+ *  is no longer using it.  Each snapshot also holds the shared pointers of
+ *  its sequences, so that a sequence removed by the user stays alive until
+ *  the output thread has moved past every snapshot that refers to it.
+ *
+ *  Each snapshot also carries a copy of the performer's tempo map, so that
+ *  the output thread reads the map of Song mode without taking a lock.  A
+ *  new map is published with the current play-set, and vice versa.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <vector>                       /* std::vector<>                    */
+
+#include "midi/tempomap.hpp"            /* seq66::tempomap                  */
+#include "play/screenset.hpp"           /* seq66::screenset::playset        */
+#include "util/automutex.hpp"           /* seq66::recmutex, automutex       */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+    class sequence;
+
+/**
+ *  Publishes play-set snapshots from the control side to the output thread.
+ */
+
+class playsnapshot
+{
+
+public:
+
+    /**
+     *  One published play-set.  Never modified after publication.
+     */
+
+    class snapshot
+    {
+        friend class playsnapshot;
+
+    private:
+
+        unsigned long m_generation;             /**< Publication number.    */
+        std::vector<sequence *> m_sequences;    /**< What the reader uses.  */
+        screenset::playset m_owners;            /**< Keeps sequences alive. */
+        tempomap m_tempo_map;                   /**< Copy of the tempo map. */
+
+    public:
+
+        snapshot
+        (
+            unsigned long generation,
+            const screenset::playset & p,
+            const tempomap & tm
+        );
+
+        unsigned long generation () const
+        {
+            return m_generation;
+        }
+
+        const std::vector<sequence *> & sequences () const
+        {
+            return m_sequences;
+        }
+
+        const tempomap & tempo_map () const
+        {
+            return m_tempo_map;
+        }
+
+    };
+
+private:
+
+    /**
+     *  The snapshot the output thread will pick up at its next acquire().
+     */
+
+    std::atomic<snapshot *> m_current;
+
+    /**
+     *  The snapshot the output thread is iterating, or null between cycles.
+     */
+
+    std::atomic<snapshot *> m_in_use;
+
+    /**
+     *  The number of acquire() calls not yet released.  Used only by the
+     *  output thread, so that a snapshot held for a whole output cycle can
+     *  be acquired again by performer::play() within it.
+     */
+
+    int m_depth;
+
+    /**
+     *  Snapshots replaced by publish(), awaiting deletion.  Accessed only by
+     *  the control side, under m_mutex.
+     */
+
+    std::vector<snapshot *> m_retired;
+
+    /**
+     *  Incremented for each publication.
+     */
+
+    unsigned long m_generation;
+
+    /**
+     *  Serializes publishers, which can be in more than one control thread.
+     *  The reader never takes this lock.
+     */
+
+    recmutex m_mutex;
+
+public:
+
+    playsnapshot ();
+    ~playsnapshot ();
+
+    playsnapshot (const playsnapshot &) = delete;
+    playsnapshot & operator = (const playsnapshot &) = delete;
+
+    void publish (const screenset::playset & p);
+    void publish (const tempomap & tm);
+    const snapshot & acquire ();
+    void release ();
+
+    /**
+     *  The generation of the latest publication.  Mostly of use for
+     *  troubleshooting.
+     */
+
+    unsigned long generation () const
+    {
+        return m_current.load()->generation();
+    }
+
+private:
+
+    void reclaim ();
+
+};          // class playsnapshot
+
+}           // namespace seq66
+
+#endif      // SEQ66_PLAYSNAPSHOT_HPP
+
+/*
+ * playsnapshot.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
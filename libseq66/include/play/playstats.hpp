@@ -0,0 +1,238 @@
+#if ! defined SEQ66_PLAYSTATS_HPP
+#define SEQ66_PLAYSTATS_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playstats.hpp
+ *
+ *  This module declares the timing statistics kept by the output thread.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  The output thread records, in every cycle, how late it woke up, how long
+ *  the call to performer::play() took, how many events it sent on each
+ *  buss, and how many events were waiting in the lookahead scheduler.  Each
+ *  quantity goes into a histogram with power-of-2 buckets.  Recording is a
+ *  few relaxed atomic increments and never allocates or locks, so the
+ *  statistics are always on.  Any other thread (the GUI, the signal handler
+ *  of the daemon, the exit code) can read them at any time; the numbers it
+ *  gets are consistent to within a cycle or so, which is good enough for a
+ *  report.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <string>                       /* std::string                      */
+#include <vector>                       /* std::vector                      */
+
+#include "midi/midibytes.hpp"           /* seq66::c_busscount_max           */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  A histogram of non-negative values, with one bucket per power of 2.
+ *  Bucket 0 holds the value 0, bucket 1 holds 1, bucket 2 holds 2 to 3,
+ *  bucket 3 holds 4 to 7, and so on; the last bucket holds everything
+ *  larger.  Only one thread may call add().
+ */
+
+class histogram
+{
+
+public:
+
+    /**
+     *  The number of buckets.  The last bucket starts at 2^30.
+     */
+
+    static const int c_bucket_count = 32;
+
+private:
+
+    std::atomic<unsigned long> m_buckets[c_bucket_count];
+    std::atomic<unsigned long> m_count;     /**< Number of values added.    */
+    std::atomic<long> m_total;              /**< Sum of values, for mean.   */
+    std::atomic<long> m_maximum;            /**< Largest value added.       */
+
+public:
+
+    histogram ();
+
+    histogram (const histogram &) = delete;
+    histogram & operator = (const histogram &) = delete;
+
+    void add (long value);
+    void clear ();
+    long percentile (double fraction) const;
+    std::string report
+    (
+        const std::string & name,
+        const std::string & units
+    ) const;
+
+    unsigned long count () const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    long maximum () const
+    {
+        return m_maximum.load(std::memory_order_relaxed);
+    }
+
+    long average () const
+    {
+        unsigned long c = count();
+        return c > 0 ? long(m_total.load(std::memory_order_relaxed) / c) : 0 ;
+    }
+
+};          // class histogram
+
+/**
+ *  The set of histograms kept by the output thread of the performer.
+ */
+
+class playstats
+{
+
+private:
+
+    /**
+     *  How late each wakeup of the output thread was, in microseconds.
+     */
+
+    histogram m_wake_lateness;
+
+    /**
+     *  How long each rendering pass, performer::play(), took, in
+     *  nanoseconds.
+     */
+
+    histogram m_play_duration;
+
+    /**
+     *  How many events were sent in each cycle, on all busses.
+     */
+
+    histogram m_cycle_events;
+
+    /**
+     *  How many events were sent in each cycle, on each buss.
+     */
+
+    histogram m_bus_events[c_busscount_max];
+
+    /**
+     *  How many events were queued in the lookahead scheduler at the end of
+     *  each cycle.
+     */
+
+    histogram m_scheduler_fill;
+
+    /**
+     *  One more than the highest buss that has sent an event, so that the
+     *  report skips the busses that are not used.
+     */
+
+    std::atomic<int> m_bus_count;
+
+    /**
+     *  In engine mode, the JACK periods put off to the next period because
+     *  another thread held the master buss.
+     */
+
+    std::atomic<unsigned long> m_deferred_periods;
+
+    /**
+     *  In engine mode, the patterns left for the next period because they
+     *  were being edited.
+     */
+
+    std::atomic<unsigned long> m_skipped_patterns;
+
+    /**
+     *  In engine mode, the events dropped because the scheduler was full.
+     */
+
+    std::atomic<unsigned long> m_dropped_events;
+
+public:
+
+    playstats ();
+
+    playstats (const playstats &) = delete;
+    playstats & operator = (const playstats &) = delete;
+
+    void wake_lateness (long us)
+    {
+        m_wake_lateness.add(us);
+    }
+
+    void play_duration (long ns)
+    {
+        m_play_duration.add(ns);
+    }
+
+    void deferred_period ()
+    {
+        m_deferred_periods.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void skipped_patterns (int count)
+    {
+        if (count > 0)
+            m_skipped_patterns.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void dropped_events (int count)
+    {
+        if (count > 0)
+            m_dropped_events.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void cycle (const std::vector<int> & buscounts, int scheduled);
+    void clear ();
+    std::string report () const;
+    bool write (const std::string & filename) const;
+
+    unsigned long cycles () const
+    {
+        return m_cycle_events.count();
+    }
+
+};          // class playstats
+
+}           // namespace seq66
+
+#endif      // SEQ66_PLAYSTATS_HPP
+
+/*
+ * playstats.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -28,7 +28,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-07-30
- * \updates       2020-07-30
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  The functions add_list_var() and add_long_list() have been replaced by
@@ -47,6 +47,9 @@
 #include "cfg/usrsettings.hpp"          /* enum class record                */
 #include "midi/eventlist.hpp"           /* seq66::eventlist                 */
 #include "midi/midibus.hpp"             /* seq66::midibus                   */
+#include "midi/outtransform.hpp"        /* seq66::outtransform              */
+#include "midi/playevents.hpp"          /* seq66::playevents                */
+#include "midi/tempomap.hpp"            /* seq66::tempomap::changes         */
 #include "play/triggers.hpp"            /* seq66::triggers, etc.            */
 #include "util/automutex.hpp"           /* seq66::recmutex, automutex       */
 #include "util/calculations.hpp"        /* measures_to_ticks()              */
@@ -320,6 +323,14 @@ private:
 
     bool m_transposable;
 
+    /**
+     *  The transform applied to a copy of each event as it is played (see
+     *  put_event_on_bus()).  It is not saved with the pattern, and by
+     *  default changes nothing.
+     */
+
+    outtransform m_transform;
+
     /**
      *  Provides a member to hold the polyphonic step-edit note counter.  We
      *  will never come close to the short limit of 32767.
@@ -563,6 +574,21 @@ private:
     midipulse m_queued_tick;        /**< Provides the tick for queuing.     */
     midipulse m_trigger_offset;     /**< Provides the trigger offset.       */
 
+    /**
+     *  The persistent play cursor.  Holds the index of the next event to be
+     *  examined by play(), and the pulse offset (a multiple of the length) of
+     *  the loop pass it belongs to.  With the cursor, play() starts where the
+     *  previous frame stopped, instead of rescanning from the beginning of
+     *  the event list.  It is reset by reset_play_cursor() on reposition,
+     *  length change, or edit, and is also checked against the event list
+     *  before use.
+     */
+
+    bool m_play_cursor_valid;       /**< The cursor can be used.            */
+    size_t m_play_index;            /**< Next event index to examine.       */
+    midipulse m_play_base;          /**< Loop-pass offset for that index.   */
+    int m_play_count;               /**< Event count when cursor was saved. */
+
     /**
      *  This constant provides the scaling used to calculate the time position
      *  in ticks (pulses), based also on the PPQN value.  Hardwired to
@@ -719,6 +745,29 @@ private:
 
     mutable recmutex m_mutex;
 
+    /**
+     *  The compact copy of m_events scanned by play().  It is rebuilt by
+     *  update_play_events(), under m_mutex, by the thread that edits the
+     *  event list, so the output thread only reads it.  Only edits of the
+     *  events rebuild it; muting, triggers, renaming, and buss or channel
+     *  changes do not.  The play cursor indexes this array.
+     *
+     *  The flag is raised only by append_event(), which the MIDI-file
+     *  readers call for each event before one sort_events() or
+     *  verify_and_link() call, which rebuilds the array.  If play() finds
+     *  the flag still raised, it rebuilds the array itself.
+     */
+
+    playevents m_play_events;
+    bool m_play_stale;
+
+    /**
+     *  The event loaded from m_play_events for sending, kept here so that
+     *  play() does not construct one for each call.
+     */
+
+    event m_play_event;
+
 private:
 
     /*
@@ -838,7 +887,7 @@ public:
         m_seq_edit_mode = mode;
     }
 
-    void modify ();
+    void modify (bool eventschanged = true);
     int event_count () const;
     int note_count ();
     bool minmax_notes (int & lowest, int & highest);
@@ -1005,6 +1054,13 @@ public:
         return m_transposable;
     }
 
+    const outtransform & transform () const
+    {
+        return m_transform;
+    }
+
+    void transform (const outtransform & ot);
+
     std::string title () const;
 
     const std::string & name () const
@@ -1270,7 +1326,10 @@ public:
     );
     std::string to_string () const;
     void play (midipulse tick, bool playback_mode, bool resume = false);
-    void play_queue (midipulse tick, bool playbackmode, bool resume);
+    bool play_queue
+    (
+        midipulse tick, bool playbackmode, bool resume, bool nowait = false
+    );
     bool add_note
     (
         midipulse tick, midipulse len, int note,
@@ -1292,10 +1351,7 @@ public:
     );
     bool append_event (const event & er);
 
-    void sort_events ()
-    {
-        m_events.sort();
-    }
+    void sort_events ();
 
     void notify_change ();
     void notify_trigger ();
@@ -1313,6 +1369,7 @@ public:
     bool get_trigger_state (midipulse tick) const;
     bool select_trigger (midipulse tick);
     triggers::List get_triggers () const;
+    int get_tempo_changes (tempomap::changes & list) const;
     bool unselect_trigger (midipulse tick);
     bool unselect_triggers ();
     bool intersect_triggers (midipulse pos, midipulse & start, midipulse & end);
@@ -1647,7 +1704,28 @@ private:
     );
     bool change_ppqn (int p);
     void set_parent (performer * p);
-    void put_event_on_bus (event & ev);
+    void put_event_on_bus (event & ev, midipulse tick = c_null_midipulse);
+    void send_to_bus
+    (
+        event & ev, midibyte channel, midipulse tick, bool ending = false
+    );
+
+    /**
+     *  Forces play() to locate its starting event anew.
+     */
+
+    void reset_play_cursor ()
+    {
+        m_play_cursor_valid = false;
+    }
+
+    void update_play_events ();
+
+    bool play_cursor_check (midipulse start_tick_offset);
+    void play_cursor_locate
+    (
+        midipulse start_tick_offset, size_t & index, midipulse & offset_base
+    );
     void reset_loop ();
     void set_trigger_offset (midipulse trigger_offset);
     void adjust_trigger_offsets_to_length (midipulse newlen);
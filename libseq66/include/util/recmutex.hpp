@@ -27,7 +27,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2020-07-16
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This recursive mutex is implemented in pthreads due to difficulties we had
@@ -116,12 +116,9 @@ public:
     recmutex & operator = (const recmutex &) = delete;
 
     void lock () const;
+    bool try_lock () const;
     void unlock () const;
 
-    /*
-     * bool try_lock () noexcept;
-     */
-
     native & native_locker () const
     {
         return m_mutex_lock;
@@ -75,11 +75,18 @@ HEADERS += include/app_limits.h \
  include/ctrl/midioperation.hpp \
  include/ctrl/opcontainer.hpp \
  include/ctrl/opcontrol.hpp \
+ include/midi/activenotes.hpp \
  include/midi/event.hpp \
  include/midi/eventlist.hpp \
+ include/midi/eventscheduler.hpp \
  include/midi/midibytes.hpp \
+ include/midi/midicapture.hpp \
  include/midi/midi_vector_base.hpp \
  include/midi/midi_vector.hpp \
+ include/midi/outqueue.hpp \
+ include/midi/outtransform.hpp \
+ include/midi/playevents.hpp \
+ include/midi/tempomap.hpp \
  include/play/clockslist.hpp \
  include/play/inputslist.hpp \
  include/play/mutegroup.hpp \
@@ -87,6 +94,8 @@ HEADERS += include/app_limits.h \
  include/play/notemapper.hpp \
  include/play/performer.hpp \
  include/play/playlist.hpp \
+ include/play/playsnapshot.hpp \
+ include/play/playstats.hpp \
  include/play/screenset.hpp \
  include/play/seq.hpp \
  include/play/sequence.hpp \
@@ -97,6 +106,7 @@ HEADERS += include/app_limits.h \
  include/sessions/clinsmanager.hpp \
  include/sessions/smanager.hpp \
  include/os/daemonize.hpp \
+ include/os/rtthread.hpp \
  include/os/timing.hpp \
  include/util/automutex.hpp \
  include/util/basic_macros.h \
@@ -140,26 +150,35 @@ SOURCES += src/seq66_features.cpp \
  src/ctrl/midioperation.cpp \
  src/ctrl/opcontainer.cpp \
  src/ctrl/opcontrol.cpp \
+ src/midi/activenotes.cpp \
  src/midi/businfo.cpp \
  src/midi/controllers.cpp \
  src/midi/editable_event.cpp \
  src/midi/editable_events.cpp \
  src/midi/event.cpp \
  src/midi/eventlist.cpp \
+ src/midi/eventscheduler.cpp \
  src/midi/jack_assistant.cpp \
  src/midi/mastermidibase.cpp \
  src/midi/midibase.cpp \
  src/midi/midibytes.cpp \
+ src/midi/midicapture.cpp \
  src/midi/midifile.cpp \
  src/midi/midi_splitter.cpp \
  src/midi/midi_vector_base.cpp \
  src/midi/midi_vector.cpp \
+ src/midi/outqueue.cpp \
+ src/midi/outtransform.cpp \
+ src/midi/playevents.cpp \
+ src/midi/tempomap.cpp \
  src/midi/wrkfile.cpp \
  src/play/mutegroup.cpp \
  src/play/mutegroups.cpp \
  src/play/notemapper.cpp \
  src/play/performer.cpp \
  src/play/playlist.cpp \
+ src/play/playsnapshot.cpp \
+ src/play/playstats.cpp \
  src/play/screenset.cpp \
  src/play/seq.cpp \
  src/play/sequence.cpp \
@@ -169,6 +188,7 @@ SOURCES += src/seq66_features.cpp \
  src/sessions/clinsmanager.cpp \
  src/sessions/smanager.cpp \
  src/os/daemonize.cpp \
+ src/os/rtthread.cpp \
  src/os/timing.cpp \
  src/util/automutex.cpp \
  src/util/basic_macros.cpp \
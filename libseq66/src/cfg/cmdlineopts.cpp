@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-11-20
- * \updates       2020-11-06
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  The "rc" command-line options override setting that are first read from
@@ -290,10 +290,35 @@ const std::string
 cmdlineopts::s_help_4b =
 "              scale=x.y     Scales size of main window. Range: 0.5 to 3.0.\n"
 "              mutes=value   Saving of mute-groups: 'mutes', 'midi', or 'both'.\n"
+"              rt-output=p:n Scheduling of the output thread: policy 'fifo',\n"
+"                            'rr', or 'normal', and priority 1 to 99, e.g.\n"
+"                            'fifo:20'. Needs an 'rtprio' limit (Linux only).\n"
+"              rt-input=p:n  Scheduling of the input thread, e.g. 'rr:10'.\n"
+"              cpus-output=l Run the output thread only on the CPUs in list l,\n"
+"                            such as '2', '2,3', or '0-1'.\n"
+"              cpus-input=l  Run the input thread only on the CPUs in list l.\n"
+"              mlock         Lock the memory of the process (mlockall()).\n"
+"              jack-engine   Let the JACK process callback drive playback, for\n"
+"                            sample-accurate output. Implies JACK MIDI. The\n"
+"                            callback does not wait for locks: while the GUI\n"
+"                            or MIDI thru holds the output, or a pattern is\n"
+"                            being edited, its events go out a period late.\n"
+"              alsa-queue    Send ALSA output through a timestamped queue.\n"
+"              alsa-input-time Record ALSA input at its arrival time, as\n"
+"                            stamped by the kernel.\n"
+"              loopback=i:o  Use in-memory MIDI ports instead of ALSA or JACK,\n"
+"                            with i inputs and o outputs, for testing and\n"
+"                            benchmarking. 'loopback' alone means 1:16.\n"
+"              stats=f       Write the playback timing statistics to file f\n"
+"                            at exit. seq66cli also writes it upon SIGUSR2.\n"
 "\n"
 " seq66cli:\n"
 "              daemonize     Makes this application fork to the background.\n"
 "              no-daemonize  Or not.  These options do not apply to Windows.\n"
+"              bounce=f      Render the song offline, faster than real time,\n"
+"                            to MIDI file f (SMF 1, a track per buss), then\n"
+"                            exit. Follows the Live/Song start-mode setting.\n"
+"              bounce0=f     The same, but writes a single-track SMF 0 file.\n"
 "\n"
 "The 'daemonize' option works only in the CLI build. The 'sets' option works in\n"
 "the CLI build.  Specify the '--user-save' option to make these options\n"
@@ -491,6 +516,32 @@ cmdlineopts::parse_o_options (int argc, char * argv [])
                                 result = true;
                                 usr().option_daemonize(false);
                             }
+                            else if (arg == "mlock")
+                            {
+                                result = true;
+                                rc().lock_memory(true);
+                            }
+                            else if (arg == "alsa-queue")
+                            {
+                                result = true;
+                                rc().alsa_queue(true);
+                            }
+                            else if (arg == "alsa-input-time")
+                            {
+                                result = true;
+                                rc().alsa_input_time(true);
+                            }
+                            else if (arg == "jack-engine")
+                            {
+                                result = true;
+                                rc().jack_engine(true);
+                                rc().with_jack_midi(true);
+                            }
+                            else if (arg == "loopback")
+                            {
+                                result = true;
+                                rc().loopback_ports(1, SEQ66_OUTPUT_BUSS_MAX);
+                            }
                             else if (arg == "log")
                             {
                                 /*
@@ -519,6 +570,42 @@ cmdlineopts::parse_o_options (int argc, char * argv [])
                                 if (! arg.empty())
                                     usr().option_use_logfile(true);
                             }
+                            else if
+                            (
+                                optionname == "bounce" ||
+                                optionname == "bounce0"
+                            )
+                            {
+                                if (! arg.empty())
+                                {
+                                    int format = optionname == "bounce0" ?
+                                        0 : 1 ;
+
+                                    usr().option_bounce(arg, format);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "stats")
+                            {
+                                if (! arg.empty())
+                                {
+                                    usr().option_stats(arg);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "loopback")
+                            {
+                                std::string::size_type p =
+                                    arg.find_first_of(":");
+
+                                if (p != std::string::npos)
+                                {
+                                    int ins = string_to_int(arg.substr(0, p));
+                                    int outs = string_to_int(arg.substr(p+1));
+                                    rc().loopback_ports(ins, outs);
+                                    result = outs > 0;
+                                }
+                            }
                             else if (optionname == "wid")
                             {
                                 // not supported, replaced by external frames
@@ -561,6 +648,63 @@ cmdlineopts::parse_o_options (int argc, char * argv [])
                                 if (arg.length() >= 1)
                                     result = usr().parse_window_scale(arg);
                             }
+                            else if
+                            (
+                                optionname == "rt-output" ||
+                                optionname == "rt-input"
+                            )
+                            {
+                                /*
+                                 * The value is "policy" or "policy:priority",
+                                 * such as "fifo:20".
+                                 */
+
+                                std::string policy = arg;
+                                int priority = 0;
+                                std::string::size_type p = arg.find(':');
+                                if (p != std::string::npos)
+                                {
+                                    policy = arg.substr(0, p);
+                                    priority = string_to_int(arg.substr(p+1));
+                                }
+                                if
+                                (
+                                    policy == "fifo" || policy == "rr" ||
+                                    policy == "normal"
+                                )
+                                {
+                                    bool out = optionname == "rt-output";
+                                    if (out)
+                                        rc().output_thread_policy(policy);
+                                    else
+                                        rc().input_thread_policy(policy);
+
+                                    if (priority > 0)
+                                    {
+                                        if (out)
+                                            rc().output_thread_priority(priority);
+                                        else
+                                            rc().input_thread_priority(priority);
+                                    }
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "cpus-output")
+                            {
+                                if (! arg.empty())
+                                {
+                                    rc().output_thread_cpus(arg);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "cpus-input")
+                            {
+                                if (! arg.empty())
+                                {
+                                    rc().input_thread_cpus(arg);
+                                    result = true;
+                                }
+                            }
                             else if (optionname == "mutes")
                             {
                                 if
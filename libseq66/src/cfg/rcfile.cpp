@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2018-11-23
- * \updates       2020-11-15
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  The <code> ~/.config/seq66.rc </code> configuration file is fairly simple
@@ -186,6 +186,26 @@ rcfile::~rcfile ()
  *      Set to 1 if you want seq66 to create its own virtual ports and not
  *      connect to other clients.
  *
+ *  [output-scheduling]
+ *
+ *      The size of the lookahead window of the output thread, in
+ *      milliseconds.  Set to 0 to disable the lookahead.  Then a flag to
+ *      hand the events to an ALSA queue with timestamps.  Then the size of
+ *      the ALSA output pool, in events, 0 for the ALSA default.  Then the
+ *      PortMidi output latency in milliseconds, 0 to disable timestamps.
+ *      Then the longest spin of the output timer in microseconds.
+ *
+ *  [input-timing]
+ *
+ *      A flag to record ALSA input at the arrival time stamped by the
+ *      kernel.
+ *
+ *  [thread-scheduling]
+ *
+ *      The scheduling policy ("normal", "fifo", or "rr"), real-time
+ *      priority, and CPU list of the output thread, then of the input
+ *      thread, then a flag to lock the process memory with mlockall().
+ *
  *  [last-used-dir]
  *
  *      This section simply holds the last path-name that was used to read or
@@ -414,6 +434,11 @@ rcfile::parse ()
         {
             sscanf(scanline(), "%d", &flag);            /* 5 */
             rc_ref().with_jack_midi(bool(flag));
+            if (next_data_line(file))
+            {
+                sscanf(scanline(), "%d", &flag);        /* 6 */
+                rc_ref().jack_engine(bool(flag));
+            }
         }
     }
 
@@ -508,6 +533,90 @@ rcfile::parse ()
     {
         (void) make_error_message("reveal-ports", "data line missing");
     }
+    if (line_after(file, "[output-scheduling]"))
+    {
+        int ms = SEQ66_DEFAULT_LOOKAHEAD_MS;
+        sscanf(scanline(), "%d", &ms);
+        rc_ref().lookahead_ms(ms);
+        if (next_data_line(file))
+        {
+            int flag = 0;
+            sscanf(scanline(), "%d", &flag);
+            rc_ref().alsa_queue(bool(flag));
+            if (next_data_line(file))
+            {
+                int events = 0;
+                sscanf(scanline(), "%d", &events);
+                rc_ref().alsa_pool(events);
+                if (next_data_line(file))
+                {
+                    int latency = 0;
+                    sscanf(scanline(), "%d", &latency);
+                    rc_ref().portmidi_latency(latency);
+                    if (next_data_line(file))
+                    {
+                        int us = SEQ66_DEFAULT_WAKE_SPIN_US;
+                        sscanf(scanline(), "%d", &us);
+                        rc_ref().wake_spin_us(us);
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        /* A missing output-scheduling section is not an error. */
+    }
+    if (line_after(file, "[input-timing]"))
+    {
+        int flag = 0;
+        sscanf(scanline(), "%d", &flag);
+        if (! rc_ref().alsa_input_time())
+            rc_ref().alsa_input_time(bool(flag));
+    }
+    else
+    {
+        /* A missing input-timing section is not an error. */
+    }
+    if (line_after(file, "[thread-scheduling]"))
+    {
+        char policy[16];
+        char cpus[64];
+        int priority = SEQ66_DEFAULT_OUTPUT_PRIORITY;
+        int count = sscanf(scanline(), "%15s %d %63s", policy, &priority, cpus);
+        if (count >= 1)
+        {
+            rc_ref().output_thread_policy(policy);
+            if (count >= 2)
+                rc_ref().output_thread_priority(priority);
+
+            if (count == 3 && cpus[0] != '#')
+                rc_ref().output_thread_cpus(cpus);
+        }
+        if (next_data_line(file))
+        {
+            priority = SEQ66_DEFAULT_INPUT_PRIORITY;
+            count = sscanf(scanline(), "%15s %d %63s", policy, &priority, cpus);
+            if (count >= 1)
+            {
+                rc_ref().input_thread_policy(policy);
+                if (count >= 2)
+                    rc_ref().input_thread_priority(priority);
+
+                if (count == 3 && cpus[0] != '#')
+                    rc_ref().input_thread_cpus(cpus);
+            }
+        }
+        if (next_data_line(file))
+        {
+            sscanf(scanline(), "%d", &flag);
+            rc_ref().lock_memory(bool(flag));
+        }
+    }
+    else
+    {
+        /* A missing thread-scheduling section is not an error. */
+    }
     if (line_after(file, "[last-used-dir]"))
     {
         if (! line().empty())
@@ -992,6 +1101,86 @@ rcfile::write ()
         << "   # flag for reveal ports\n"
         ;
 
+    /*
+     * Output scheduling (lookahead)
+     */
+
+    file
+        << "\n[output-scheduling]\n\n"
+           "# Sets the size of the output lookahead window, in milliseconds.\n"
+           "# Events are prepared this far ahead of time, and each is sent at\n"
+           "# its exact time, so that the cost of the output loop does not\n"
+           "# add timing jitter.  Values from 5 to 20 are good.  Larger\n"
+           "# values delay reactions to muting.  0, the default, disables\n"
+           "# the lookahead and sends events as soon as they are prepared.\n"
+           "\n"
+        << rc_ref().lookahead_ms() << "   # lookahead in ms\n"
+           "\n"
+           "# With ALSA, set to 1 to hand the events to an ALSA queue a bit\n"
+           "# early, with timestamps, so that the kernel sends each one at\n"
+           "# its exact time.  Needs a lookahead.\n"
+           "\n"
+        << (rc_ref().alsa_queue() ? "1" : "0") << "   # alsa_queue\n"
+           "\n"
+           "# The size of the ALSA output pool, in events.  The output of\n"
+           "# each cycle is collected there and sent with one system call.\n"
+           "# Raise it for dense output on many ports.  0 is the default.\n"
+           "\n"
+        << rc_ref().alsa_pool() << "   # alsa_pool\n"
+           "\n"
+           "# With PortMidi, the output latency in milliseconds.  If not 0,\n"
+           "# each event is stamped with its time, and PortMidi sends it\n"
+           "# then.  Needs a lookahead.  0 sends events as written.\n"
+           "\n"
+        << rc_ref().portmidi_latency() << "   # portmidi_latency\n"
+           "\n"
+           "# The longest time, in microseconds, that the output thread\n"
+           "# spends yielding after its sleep to land on a deadline.  This\n"
+           "# uses the processor.  0 leaves the timing to the kernel.\n"
+           "\n"
+        << rc_ref().wake_spin_us() << "   # wake_spin_us\n"
+        ;
+
+    /*
+     * Input timing
+     */
+
+    file
+        << "\n[input-timing]\n\n"
+           "# With ALSA, set to 1 to record each input event at the time it\n"
+           "# arrived, as stamped by the kernel, instead of the time at which\n"
+           "# seq66 reads it.  Fast playing is then recorded more exactly.\n"
+           "\n"
+        << (rc_ref().alsa_input_time() ? "1" : "0") << "   # alsa_input_time\n"
+        ;
+
+    /*
+     * Thread scheduling
+     */
+
+    file
+        << "\n[thread-scheduling]\n\n"
+           "# Sets the scheduling of the output thread (first line) and the\n"
+           "# input thread (second line). Each line holds a policy, 'normal',\n"
+           "# 'fifo', or 'rr'; a real-time priority, 1 to 99, used with 'fifo'\n"
+           "# and 'rr'; and the CPUs to run on, such as '2', '2,3', or '0-1',\n"
+           "# or 'all'. The third line, if 1, locks the memory of the process\n"
+           "# so that page faults do not delay MIDI output. Real-time settings\n"
+           "# need an 'rtprio' and 'memlock' limit in\n"
+           "# /etc/security/limits.d/audio.conf, e.g. '@audio - rtprio 95'.\n"
+           "\n"
+        << rc_ref().output_thread_policy() << " "
+        << rc_ref().output_thread_priority() << " "
+        << rc_ref().output_thread_cpus()
+        << "   # output thread policy, priority, CPUs\n"
+        << rc_ref().input_thread_policy() << " "
+        << rc_ref().input_thread_priority() << " "
+        << rc_ref().input_thread_cpus()
+        << "   # input thread policy, priority, CPUs\n"
+        << (rc_ref().lock_memory() ? "1" : "0")
+        << "   # flag for locking memory\n"
+        ;
+
 #if defined SEQ66_USE_FRUITY_CODE         /* will not be supported in seq66   */
 
     /*
@@ -1072,7 +1261,14 @@ rcfile::write ()
         << rc_ref().song_start_mode() << "   # song_start_mode\n\n"
         "# jack_midi - Enable JACK MIDI, which is a separate option from\n"
         "# JACK Transport.\n\n"
-        << rc_ref().with_jack_midi() << "   # with_jack_midi\n"
+        << rc_ref().with_jack_midi() << "   # with_jack_midi\n\n"
+        "# jack_engine - The JACK process callback drives the sequencer,\n"
+        "# advancing it by one period per call and writing the events at\n"
+        "# their frame offsets in the port buffers. The output latency is one\n"
+        "# JACK period. The callback does not wait for locks: if the output\n"
+        "# or a pattern is busy (GUI, MIDI thru, editing), those events go\n"
+        "# out one period late. Requires jack_midi.\n\n"
+        << rc_ref().jack_engine() << "   # jack_engine\n"
         ;
 
 #if defined SEQ66_LASH_SUPPORT_MOVED
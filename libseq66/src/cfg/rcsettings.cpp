@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-09-22
- * \updates       2020-11-15
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  Note that this module also sets the legacy global variables, so that
@@ -86,6 +86,19 @@ rcsettings::rcsettings () :
     m_show_midi                 (false),
     m_priority                  (false),
     m_pass_sysex                (false),
+    m_lookahead_ms              (SEQ66_DEFAULT_LOOKAHEAD_MS),
+    m_alsa_queue                (false),
+    m_alsa_pool                 (0),
+    m_portmidi_latency          (0),
+    m_wake_spin_us              (SEQ66_DEFAULT_WAKE_SPIN_US),
+    m_alsa_input_time           (false),
+    m_output_thread_policy      ("normal"),
+    m_output_thread_priority    (SEQ66_DEFAULT_OUTPUT_PRIORITY),
+    m_output_thread_cpus        ("all"),
+    m_input_thread_policy       ("normal"),
+    m_input_thread_priority     (SEQ66_DEFAULT_INPUT_PRIORITY),
+    m_input_thread_cpus         ("all"),
+    m_lock_memory               (false),
     m_with_jack_transport       (false),
     m_with_jack_master          (false),
     m_with_jack_master_cond     (false),
@@ -94,6 +107,9 @@ rcsettings::rcsettings () :
 #else
     m_with_jack_midi            (false),
 #endif
+    m_jack_engine               (false),
+    m_loopback_inputs           (0),
+    m_loopback_outputs          (0),
     m_song_start_mode           (false),
     m_manual_ports              (false),
     m_manual_port_count         (SEQ66_OUTPUT_BUSS_MAX),
@@ -178,6 +194,19 @@ rcsettings::set_defaults ()
     m_show_midi                 = false;
     m_priority                  = false;
     m_pass_sysex                = false;
+    m_lookahead_ms              = SEQ66_DEFAULT_LOOKAHEAD_MS;
+    m_alsa_queue                = false;
+    m_alsa_pool                 = 0;
+    m_portmidi_latency          = 0;
+    m_wake_spin_us              = SEQ66_DEFAULT_WAKE_SPIN_US;
+    m_alsa_input_time           = false;
+    m_output_thread_policy      = "normal";
+    m_output_thread_priority    = SEQ66_DEFAULT_OUTPUT_PRIORITY;
+    m_output_thread_cpus        = "all";
+    m_input_thread_policy       = "normal";
+    m_input_thread_priority     = SEQ66_DEFAULT_INPUT_PRIORITY;
+    m_input_thread_cpus         = "all";
+    m_lock_memory               = false;
     m_with_jack_transport       = false;
     m_with_jack_master          = false;
     m_with_jack_master_cond     = false;
@@ -186,6 +215,9 @@ rcsettings::set_defaults ()
 #else
     m_with_jack_midi            = false;
 #endif
+    m_jack_engine               = false;
+    m_loopback_inputs           = 0;
+    m_loopback_outputs          = 0;
     m_song_start_mode           = false;
     m_manual_ports              = false;
     m_manual_port_count         = SEQ66_OUTPUT_BUSS_MAX;
@@ -659,6 +691,45 @@ rcsettings::tempo_track_number (int track)
     m_tempo_track_number = track;
 }
 
+/**
+ * \setter m_loopback_inputs and m_loopback_outputs
+ *
+ *  Each count is limited to c_busscount_max.  Enabling the loopback API
+ *  disables JACK MIDI and JACK transport, since the point is to run without
+ *  any system MIDI services.
+ *
+ * \param inputs
+ *      The number of loopback input ports, which can be 0.
+ *
+ * \param outputs
+ *      The number of loopback output ports.  If 0, the loopback API is not
+ *      used.
+ */
+
+void
+rcsettings::loopback_ports (int inputs, int outputs)
+{
+    if (inputs < 0)
+        inputs = 0;
+    else if (inputs > c_busscount_max)
+        inputs = c_busscount_max;
+
+    if (outputs < 0)
+        outputs = 0;
+    else if (outputs > c_busscount_max)
+        outputs = c_busscount_max;
+
+    m_loopback_inputs = inputs;
+    m_loopback_outputs = outputs;
+    if (outputs > 0)
+    {
+        m_with_jack_midi = false;
+        m_with_jack_transport = false;
+        m_with_jack_master = false;
+        m_with_jack_master_cond = false;
+    }
+}
+
 /**
  * \getter m_recent_files
  *
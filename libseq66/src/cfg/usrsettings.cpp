@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-09-23
- * \updates       2020-09-03
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  Note that this module also sets the remaining legacy global variables, so
@@ -298,6 +298,9 @@ usrsettings::usrsettings () :
     m_user_option_daemonize     (false),
     m_user_use_logfile          (false),
     m_user_option_logfile       (),
+    m_user_option_bounce        (),
+    m_user_option_bounce_format (1),
+    m_user_option_stats         (),
     m_work_around_play_image    (false),
     m_work_around_transpose_image (false),
 
@@ -409,6 +412,9 @@ usrsettings::usrsettings (const usrsettings & rhs) :
     m_user_option_daemonize     (rhs.m_user_option_daemonize),
     m_user_use_logfile          (rhs.m_user_use_logfile),
     m_user_option_logfile       (rhs.m_user_option_logfile),
+    m_user_option_bounce        (rhs.m_user_option_bounce),
+    m_user_option_bounce_format (rhs.m_user_option_bounce_format),
+    m_user_option_stats         (rhs.m_user_option_stats),
     m_work_around_play_image    (rhs.m_work_around_play_image),
     m_work_around_transpose_image (rhs.m_work_around_transpose_image),
 
@@ -528,6 +534,9 @@ usrsettings::operator = (const usrsettings & rhs)
         m_user_option_daemonize = rhs.m_user_option_daemonize;
         m_user_use_logfile = rhs.m_user_use_logfile;
         m_user_option_logfile = rhs.m_user_option_logfile;
+        m_user_option_bounce = rhs.m_user_option_bounce;
+        m_user_option_bounce_format = rhs.m_user_option_bounce_format;
+        m_user_option_stats = rhs.m_user_option_stats;
         m_work_around_play_image = rhs.m_work_around_play_image;
         m_work_around_transpose_image = rhs.m_work_around_transpose_image;
 
@@ -616,6 +625,9 @@ usrsettings::set_defaults ()
     m_user_option_daemonize = false;
     m_user_use_logfile = false;
     m_user_option_logfile.clear();
+    m_user_option_bounce.clear();
+    m_user_option_bounce_format = 1;
+    m_user_option_stats.clear();
     m_work_around_play_image = false;
     m_work_around_transpose_image = false;
     m_user_ui_key_height = SEQ66_SEQKEY_HEIGHT;
@@ -0,0 +1,214 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          activenotes.cpp
+ *
+ *  This module defines the table of the notes sounding on the output busses.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  See the activenotes.hpp module for an overview.
+ */
+
+#include "midi/activenotes.hpp"         /* seq66::activenotes               */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  Creates an empty table.
+ */
+
+activenotes::activenotes () :
+    m_notes     (),
+    m_channels  (),
+    m_busses    (0),
+    m_count     (0)
+{
+    // Empty body
+}
+
+/**
+ *  Marks a note as sounding.  Values out of range are ignored.
+ *
+ * \param bus
+ *      The output buss.
+ *
+ * \param channel
+ *      The channel on which the note is played.
+ *
+ * \param note
+ *      The note number.
+ */
+
+void
+activenotes::note_on (bussbyte bus, midibyte channel, midibyte note)
+{
+    if (int(bus) < c_busscount_max && note < c_midibyte_data_max)
+    {
+        channel &= 0x0F;
+
+        std::uint64_t & word = m_notes[bus][channel][note >> 6];
+        std::uint64_t bit = std::uint64_t(1) << (note & 0x3F);
+        if ((word & bit) == 0)
+        {
+            word |= bit;
+            m_channels[bus] |= std::uint16_t(1u << channel);
+            m_busses |= std::uint64_t(1) << bus;
+            ++m_count;
+        }
+    }
+}
+
+/**
+ *  Marks a note as released.  Values out of range are ignored.
+ *
+ * \param bus
+ *      The output buss.
+ *
+ * \param channel
+ *      The channel on which the note is played.
+ *
+ * \param note
+ *      The note number.
+ */
+
+void
+activenotes::note_off (bussbyte bus, midibyte channel, midibyte note)
+{
+    if (int(bus) < c_busscount_max && note < c_midibyte_data_max)
+    {
+        channel &= 0x0F;
+
+        std::uint64_t (& words)[2] = m_notes[bus][channel];
+        std::uint64_t bit = std::uint64_t(1) << (note & 0x3F);
+        std::uint64_t & word = words[note >> 6];
+        if ((word & bit) != 0)
+        {
+            word &= ~bit;
+            --m_count;
+            if (words[0] == 0 && words[1] == 0)
+            {
+                m_channels[bus] &= std::uint16_t(~(1u << channel));
+                if (m_channels[bus] == 0)
+                    m_busses &= ~(std::uint64_t(1) << bus);
+            }
+        }
+    }
+}
+
+/**
+ * \return
+ *      Returns true if the note is marked as sounding.
+ */
+
+bool
+activenotes::active (bussbyte bus, midibyte channel, midibyte note) const
+{
+    bool result = int(bus) < c_busscount_max && note < c_midibyte_data_max;
+    if (result)
+    {
+        std::uint64_t word = m_notes[bus][channel & 0x0F][note >> 6];
+        result = (word & (std::uint64_t(1) << (note & 0x3F))) != 0;
+    }
+    return result;
+}
+
+/**
+ *  Removes a sounding note from the table.  The masks lead straight to the
+ *  buss, channel, and word holding it, so emptying the table takes time in
+ *  proportion to the number of sounding notes.
+ *
+ * \param [out] bus
+ *      Receives the buss of the note.
+ *
+ * \param [out] channel
+ *      Receives the channel of the note.
+ *
+ * \param [out] note
+ *      Receives the note number.
+ *
+ * \return
+ *      Returns false if no note is sounding.
+ */
+
+bool
+activenotes::pop (bussbyte & bus, midibyte & channel, midibyte & note)
+{
+    bool result = m_busses != 0;
+    if (result)
+    {
+        int b = 0;
+        while ((m_busses & (std::uint64_t(1) << b)) == 0)
+            ++b;
+
+        int c = 0;
+        while ((m_channels[b] & (1u << c)) == 0)
+            ++c;
+
+        int w = m_notes[b][c][0] != 0 ? 0 : 1 ;
+        std::uint64_t word = m_notes[b][c][w];
+        int n = 0;
+        while ((word & (std::uint64_t(1) << n)) == 0)
+            ++n;
+
+        bus = bussbyte(b);
+        channel = midibyte(c);
+        note = midibyte(w * 64 + n);
+        note_off(bus, channel, note);
+    }
+    return result;
+}
+
+/**
+ *  Marks all notes as released, without sending anything.
+ */
+
+void
+activenotes::clear ()
+{
+    for (int bus = 0; bus < c_busscount_max; ++bus)
+    {
+        if (m_channels[bus] != 0)
+        {
+            for (auto & words : m_notes[bus])
+                words[0] = words[1] = 0;
+
+            m_channels[bus] = 0;
+        }
+    }
+    m_busses = 0;
+    m_count = 0;
+}
+
+}           // namespace seq66
+
+/*
+ * activenotes.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
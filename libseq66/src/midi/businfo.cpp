@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2016-12-31
- * \updates       2020-08-02
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This file provides a base-class implementation for various master MIDI
@@ -401,6 +401,44 @@ busarray::play (bussbyte bus, event * e24, midibyte channel)
         m_container[bus].bus()->play(e24, channel);
 }
 
+/**
+ *  Gets the next MIDI clock pulse of the given buss, up to the given tick.
+ *  See midibase::next_clock().
+ *
+ * \param bus
+ *      The output buss.
+ *
+ * \param tick
+ *      The last pulse that is due.
+ *
+ * \return
+ *      Returns the pulse of the clock, or -1 if there is none, or if the
+ *      buss is not valid.
+ */
+
+midipulse
+busarray::next_clock (bussbyte bus, midipulse tick)
+{
+    return bus < count() ? m_container[bus].next_clock(tick) : -1 ;
+}
+
+/**
+ *  Sends one MIDI clock on the given buss, if it is active.
+ *
+ * \param bus
+ *      The output buss.
+ *
+ * \param tick
+ *      The pulse of the clock, used only for debugging.
+ */
+
+void
+busarray::send_clock (bussbyte bus, midipulse tick)
+{
+    if (bus < count() && m_container[bus].active())
+        m_container[bus].send_clock(tick);
+}
+
 /**
  *  Sets the clock type for the given bus, usually the output buss.
  *  This code is a bit more restrictive than the original code in
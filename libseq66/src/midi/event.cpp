@@ -24,7 +24,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2020-08-04
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  A MIDI event (i.e. "track event") is encapsulated by the seq66::event
@@ -377,29 +377,6 @@ event::set_status (midibyte status)
     }
 }
 
-/**
- *  This overload is useful when synthesizing events, such as converting a
- *  Note On event with a velocity of zero to a Note Off event.  See its usage
- *  around line 681 of midifile.cpp.
- *
- * \param eventcode
- *      The status byte, perhaps read from a MIDI file.  This byte is
- *      assumed to have already had its low nybble cleared by masking against
- *      EVENT_CLEAR_CHAN_MASK.
- *
- * \param channel
- *      The channel byte.  Combined with the event-code, this makes a valid
- *      MIDI "status" byte.  This byte is assumed to have already had its high
- *      nybble cleared by masking against EVENT_GET_CHAN_MASK.
- */
-
-void
-event::set_channel_status (midibyte eventcode, midibyte channel)
-{
-    m_status = eventcode;               /* already masked against 0xF0      */
-    m_channel = channel;                /* already masked against 0x0F      */
-}
-
 /**
  *  This function is used in recording to preserve the input channel
  *  information for deciding what to do with an incoming MIDI event.
@@ -0,0 +1,286 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          eventscheduler.cpp
+ *
+ *  This module defines the timestamped queue of outgoing MIDI events.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-22
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  See the eventscheduler.hpp module for an overview.
+ */
+
+#include <algorithm>                    /* std::push_heap(), etc.           */
+
+#include "midi/event.hpp"               /* seq66::event                     */
+#include "midi/eventscheduler.hpp"      /* seq66::eventscheduler            */
+#include "util/calculations.hpp"        /* seq66::pulse_length_us()         */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  The number of slots reserved up front.  Even 300 busy patterns rarely
+ *  render this many events inside a 20 ms window.
+ */
+
+static const size_t c_scheduler_reserve = 2048;
+
+/**
+ *  Comparison for the heap.  The standard heap functions build a max-heap, so
+ *  we invert the comparison to get the earliest deadline at the front.
+ */
+
+static bool
+later_slot (const schedslot & a, const schedslot & b)
+{
+    if (a.ss_deadline == b.ss_deadline)
+        return a.ss_order > b.ss_order;
+    else
+        return a.ss_deadline > b.ss_deadline;
+}
+
+/**
+ *  Default constructor.  Scheduling is disabled until lookahead_us() is
+ *  called with a non-zero value.
+ */
+
+eventscheduler::eventscheduler () :
+    m_slots         (),
+    m_fixed_capacity(false),
+    m_dropped       (0),
+    m_lookahead_us  (0),
+    m_origin_tick   (0.0),
+    m_origin_us     (0),
+    m_pulse_us      (0.0),
+    m_order         (0)
+{
+    m_slots.reserve(c_scheduler_reserve);
+}
+
+/**
+ *  Ties a pulse value to a microtime() value.  Called by the output thread at
+ *  the start of each cycle, before the play set is rendered.
+ *
+ * \param tick
+ *      The current (fractional) pulse.
+ *
+ * \param us
+ *      The microtime() value at which the pulse was calculated.
+ *
+ * \param bpm
+ *      The current tempo.  A tempo change inside the lookahead window is
+ *      picked up in the next cycle.
+ *
+ * \param ppqn
+ *      The current PPQN.
+ */
+
+void
+eventscheduler::set_origin (double tick, long us, midibpm bpm, int ppqn)
+{
+    m_origin_tick = tick;
+    m_origin_us = us;
+    m_pulse_us = pulse_length_us(bpm, ppqn);
+}
+
+/**
+ *  Converts a pulse to a wall-clock deadline using the current origin.
+ *  Pulses earlier than the origin yield deadlines in the past, which means
+ *  "send right away".
+ */
+
+long
+eventscheduler::deadline (midipulse tick) const
+{
+    double delta = (double(tick) - m_origin_tick) * m_pulse_us;
+    return m_origin_us + long(delta);
+}
+
+/**
+ *  Converts a number of pulses after the origin to a deadline.  Used for
+ *  pulses that do not follow the song position, such as those of the MIDI
+ *  clock, which keep running when the song loops.
+ */
+
+long
+eventscheduler::deadline_after (double pulses) const
+{
+    return m_origin_us + long(pulses * m_pulse_us);
+}
+
+/**
+ *  Adds an event to the queue.  If the capacity is fixed and the reserved
+ *  slots are all in use, the event is dropped and counted instead.
+ *
+ * \param deadline
+ *      The time, in microtime() microseconds, at which to send the event.
+ *
+ * \param bus
+ *      The output buss.
+ *
+ * \param channel
+ *      The channel, as passed to mastermidibase::play().
+ *
+ * \param e
+ *      The event, which must be a channel event.
+ */
+
+void
+eventscheduler::push
+(
+    long deadline, bussbyte bus, midibyte channel, const event & e
+)
+{
+    if (m_fixed_capacity && m_slots.size() == m_slots.capacity())
+    {
+        ++m_dropped;
+        return;
+    }
+
+    schedslot slot;
+    slot.ss_deadline = deadline;
+    slot.ss_order = m_order++;
+    slot.ss_bus = bus;
+    slot.ss_channel = channel;
+    slot.ss_status = e.get_status();
+    e.get_data(slot.ss_d0, slot.ss_d1);
+    m_slots.push_back(slot);
+    std::push_heap(m_slots.begin(), m_slots.end(), later_slot);
+}
+
+/**
+ *  Removes the earliest event if its deadline has arrived.
+ *
+ * \param now
+ *      The current microtime() value.
+ *
+ * \param [out] slot
+ *      Receives the event, if one is due.
+ *
+ * \return
+ *      Returns true if an event was due and removed.
+ */
+
+bool
+eventscheduler::pop_due (long now, schedslot & slot)
+{
+    bool result = ! m_slots.empty() && m_slots.front().ss_deadline <= now;
+    if (result)
+        result = pop(slot);
+
+    return result;
+}
+
+/**
+ *  Removes the earliest event, due or not.
+ */
+
+bool
+eventscheduler::pop (schedslot & slot)
+{
+    bool result = ! m_slots.empty();
+    if (result)
+    {
+        std::pop_heap(m_slots.begin(), m_slots.end(), later_slot);
+        slot = m_slots.back();
+        m_slots.pop_back();
+    }
+    return result;
+}
+
+/**
+ *  Removes pending Note Ons matching a Note Off that is being sent right
+ *  away.  This happens when a pattern is muted or stopped inside the
+ *  lookahead window; sequence::off_playing_notes() sends its Note Offs
+ *  immediately, and the queued Note On would otherwise sound afterward and
+ *  hang.
+ *
+ * \return
+ *      Returns the number of Note Ons removed.
+ */
+
+int
+eventscheduler::cancel_note_on (bussbyte bus, midibyte channel, midibyte note)
+{
+    auto match = [bus, channel, note] (const schedslot & s)
+    {
+        return s.ss_bus == bus && s.ss_channel == channel &&
+            s.ss_status == EVENT_NOTE_ON && s.ss_d0 == note;
+    };
+    auto it = std::remove_if(m_slots.begin(), m_slots.end(), match);
+    int result = int(std::distance(it, m_slots.end()));
+    if (result > 0)
+    {
+        m_slots.erase(it, m_slots.end());
+        std::make_heap(m_slots.begin(), m_slots.end(), later_slot);
+    }
+    return result;
+}
+
+/**
+ *  Removes all pending Note Ons, for an "all notes off" while playing.
+ *
+ * \return
+ *      Returns the number of Note Ons removed.
+ */
+
+int
+eventscheduler::cancel_note_ons ()
+{
+    auto match = [] (const schedslot & s)
+    {
+        return s.ss_status == EVENT_NOTE_ON;
+    };
+    auto it = std::remove_if(m_slots.begin(), m_slots.end(), match);
+    int result = int(std::distance(it, m_slots.end()));
+    if (result > 0)
+    {
+        m_slots.erase(it, m_slots.end());
+        std::make_heap(m_slots.begin(), m_slots.end(), later_slot);
+    }
+    return result;
+}
+
+/**
+ *  Drops all pending events.
+ */
+
+void
+eventscheduler::clear ()
+{
+    m_slots.clear();
+    m_order = 0;
+}
+
+}           // namespace seq66
+
+/*
+ * eventscheduler.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
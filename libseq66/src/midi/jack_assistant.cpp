@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-09-14
- * \updates       2020-10-26
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This module was created from code that existed in the performer object.
@@ -59,6 +59,7 @@
 
 #include "midi/jack_assistant.hpp"      /* this seq66::jack_ass class       */
 #include "midi/midifile.hpp"            /* seq66::midifile class            */
+#include "midi/tempomap.hpp"            /* seq66::tempomap                  */
 #include "util/automutex.hpp"           /* seq66::mutex, automutex          */
 #include "play/performer.hpp"           /* seq66::performer class           */
 #include "cfg/settings.hpp"             /* "rc" and "user" settings         */
@@ -1009,10 +1010,17 @@ jack_assistant::set_beats_per_minute (midibpm bpminute)
  *      If using Song mode for this call then this value is set as the
  *      "current tick" value.  If it's value is bad (null_midipulse),
  *      then this parameter is set to 0 before being used.
+ *
+ * \param tmap
+ *      The tempo map to locate the tick with in Song mode, or null if none
+ *      is in use.  See performer::position_jack().
  */
 
 void
-jack_assistant::position (bool songmode, midipulse tick)
+jack_assistant::position
+(
+    bool songmode, midipulse tick, const tempomap * tmap
+)
 {
 
 #if defined SEQ66_JACK_SUPPORT
@@ -1039,11 +1047,29 @@ jack_assistant::position (bool songmode, midipulse tick)
     else
         tick = 0;
 
-    int ticks_per_beat = m_ppqn * 10;
-    int beats_per_minute = parent().get_beats_per_minute();
-    uint64_t tick_rate = (uint64_t(m_jack_frame_rate) * tick * 60.0);
-    long tpb_bpm = ticks_per_beat * beats_per_minute * 4.0 / m_beat_width;
-    uint64_t jack_frame = tick_rate / tpb_bpm;
+    uint64_t jack_frame;
+    if (songmode && not_nullptr(tmap))
+    {
+        /*
+         * The tempo map gives the exact time of the pulse, whatever tempo
+         * changes precede it.  The beat-width scaling matches the
+         * calculation below.
+         */
+
+        double us = tmap->tick_to_us(double(tick) / 10.0);
+        jack_frame = uint64_t
+        (
+            us * m_beat_width / 4.0 * m_jack_frame_rate / 1000000.0
+        );
+    }
+    else
+    {
+        int ticks_per_beat = m_ppqn * 10;
+        int beats_per_minute = parent().get_beats_per_minute();
+        uint64_t tick_rate = (uint64_t(m_jack_frame_rate) * tick * 60.0);
+        long tpb_bpm = ticks_per_beat * beats_per_minute * 4.0 / m_beat_width;
+        jack_frame = tick_rate / tpb_bpm;
+    }
     if (m_jack_master)
     {
         /*
@@ -1369,6 +1395,37 @@ jack_session_callback (jack_session_event_t * ev, void * arg)
 
 #endif  // SEQ66_JACK_SESSION
 
+/**
+ *  Converts a JACK frame to a song pulse, using the performer's tempo map.
+ *  The beat-width scaling matches the calculations of position() and
+ *  output().
+ *
+ * \param frame
+ *      The JACK frame number.
+ *
+ * \param tmap
+ *      The tempo map published for the output thread.
+ *
+ * \return
+ *      Returns the pulse, in Seq66 PPQN units.
+ */
+
+double
+jack_assistant::frame_to_map_tick
+(
+    jack_nframes_t frame, const tempomap & tmap
+) const
+{
+    double result = 0.0;
+    if (m_jack_pos.frame_rate > 0)
+    {
+        double us = double(frame) * 1000000.0 / m_jack_pos.frame_rate;
+        us = us * 4.0 / m_beat_width;
+        result = tmap.us_to_tick(us);
+    }
+    return result;
+}
+
 /**
  *  Performance output function for JACK, called by the performer function
  *  of the same name.  This code comes from performer::output_func() from seq66.
@@ -1430,6 +1487,13 @@ jack_assistant::output (jack_scratchpad & pad)
         m_jack_pos.beat_type = m_beat_width;
         m_jack_pos.ticks_per_beat = m_ppqn * 10;
         m_jack_pos.beats_per_minute = parent().get_beats_per_minute();
+
+        bool usemap = pad.js_playback_mode && not_nullptr(pad.js_tempo_map);
+        if (usemap)
+        {
+            m_jack_pos.beats_per_minute =
+                pad.js_tempo_map->bpm_at(pad.js_current_tick);
+        }
         if
         (
             m_jack_transport_state_last == JackTransportStarting &&
@@ -1447,18 +1511,26 @@ jack_assistant::output (jack_scratchpad & pad)
             pad.js_dumping = true;
 
             /*
-             * Here, Seq32 uses the tempo map if in song mode, instead of
+             * Like Seq32, we use the tempo map if in song mode, instead of
              * making these calculations.
              */
 
-            m_jack_tick = m_jack_pos.frame * m_jack_pos.ticks_per_beat *
-                m_jack_pos.beats_per_minute / (m_jack_pos.frame_rate * 60.0);
-
-            jack_ticks_converted = m_jack_tick * tick_multiplier();
+            if (usemap)
+            {
+                jack_ticks_converted = frame_to_map_tick
+                (
+                    m_jack_pos.frame, *pad.js_tempo_map
+                );
+                m_jack_tick = jack_ticks_converted / tick_multiplier();
+            }
+            else
+            {
+                m_jack_tick = m_jack_pos.frame * m_jack_pos.ticks_per_beat *
+                    m_jack_pos.beats_per_minute /
+                    (m_jack_pos.frame_rate * 60.0);
 
-            /*
-             * And Seq32 continues here.
-             */
+                jack_ticks_converted = m_jack_tick * tick_multiplier();
+            }
 
             m_jack_parent.set_last_ticks(long(jack_ticks_converted));
             pad.js_init_clock = true;
@@ -1507,10 +1579,17 @@ jack_assistant::output (jack_scratchpad & pad)
             if (m_jack_frame_current > m_jack_frame_last)   /* moving ahead? */
             {
                 /*
-                 * Seq32 uses tempo map if in song mode here, instead.
+                 * Like Seq32, use the tempo map if in song mode here.
                  */
 
-                if (m_jack_pos.frame_rate > 1000)           /* usually 48000 */
+                if (usemap)
+                {
+                    m_jack_tick = frame_to_map_tick
+                    (
+                        m_jack_frame_current, *pad.js_tempo_map
+                    ) / tick_multiplier();
+                }
+                else if (m_jack_pos.frame_rate > 1000)      /* usually 48000 */
                 {
                     m_jack_tick += (m_jack_frame_current - m_jack_frame_last) *
                         m_jack_pos.ticks_per_beat * m_jack_pos.beats_per_minute /
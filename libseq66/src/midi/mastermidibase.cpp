@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2016-11-23
- * \updates       2020-08-02
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This file provides a base-class implementation for various master MIDI
@@ -37,7 +37,7 @@
 #include "midi/event.hpp"               /* seq66::event                     */
 #include "midi/mastermidibase.hpp"      /* seq66::mastermidibase            */
 #include "play/sequence.hpp"            /* seq66::sequence                  */
-#include "os/timing.hpp"                /* seq66::microsleep()              */
+#include "os/timing.hpp"                /* seq66::microsleep(), microtime() */
 #include "util/calculations.hpp"        /* seq66::extract_port_names()      */
 
 /*
@@ -79,6 +79,16 @@ mastermidibase::mastermidibase
     m_vector_sequence   (),             /* stazed feature                   */
     m_filter_by_channel (false),        /* set based on configuration       */
     m_seq               (nullptr),
+    m_scheduler         (),
+    m_outqueues         (),
+    m_active_notes      (),
+    m_bus_transforms    (),
+    m_deliver_ahead_us  (0),
+    m_deliver_until     (0),
+    m_batching          (false),
+    m_flush_pending     (false),
+    m_capture           (nullptr),
+    m_bus_events        (),
     m_mutex             ()
 {
     // Empty body now
@@ -179,25 +189,52 @@ mastermidibase::stop ()
 /**
  *  Generates the MIDI clock for each of the output busses.  Also calls the
  *  api_clock() function, which does nothing for the <i> original </i> ALSA
- *  implementation and the PortMidi implementation.
+ *  implementation and the PortMidi implementation.  Then flushes the output
+ *  once for all of the busses.
+ *
+ *  If the scheduler is active and a horizon is given, the clocks up to the
+ *  horizon are queued instead, each with the deadline of its own pulse, so
+ *  that they go out as a steady stream, like the notes rendered ahead.  The
+ *  tick must then be the clock pulse at the current origin of the scheduler
+ *  (see schedule_origin()).  The clock pulses run on when the song loops, so
+ *  they are offset from that origin, not converted from the song pulses.
  *
  * \threadsafe
  *
  * \param tick
  *      Provides the tick value with which to set the buss clock.
+ *
+ * \param horizon
+ *      The last clock pulse to queue ahead, or c_null_midipulse to send the
+ *      clocks that are due right away.
  */
 
 void
-mastermidibase::emit_clock (midipulse tick)
+mastermidibase::emit_clock (double tick, midipulse horizon)
 {
     automutex locker(m_mutex);
-
-    /*
-     * Doesn't do anything: api_clock().  But where do we call flush()?
-     * Do we even need to flush clock?
-     */
-
-    m_outbus_array.clock(tick);
+    drain_queues();                     /* unscheduled events go first      */
+    if (m_scheduler.active() && horizon != c_null_midipulse)
+    {
+        int busses = m_outbus_array.count();
+        event e;
+        e.set_status(EVENT_MIDI_CLOCK);
+        for (int bus = 0; bus < busses; ++bus)
+        {
+            bussbyte b = bussbyte(bus);
+            midipulse c = m_outbus_array.next_clock(b, horizon);
+            for ( ; c >= 0; c = m_outbus_array.next_clock(b, horizon))
+            {
+                long deadline = m_scheduler.deadline_after(double(c) - tick);
+                m_scheduler.push(deadline, b, 0, e);
+            }
+        }
+    }
+    else
+    {
+        m_outbus_array.clock(midipulse(tick));
+        flush();                        /* once for all busses, see flush() */
+    }
 }
 
 /**
@@ -239,7 +276,8 @@ mastermidibase::set_beats_per_minute (midibpm bpm)
 /**
  *  Flushes our local queue events out  The implementation-specific API
  *  function is called.  For example, ALSA provides a function to "drain" the
- *  output.
+ *  output.  While the output thread batches its cycles (see batch_output()),
+ *  the drain is put off until the end of the current cycle.
  *
  * \threadsafe
  */
@@ -248,35 +286,103 @@ void
 mastermidibase::flush ()
 {
     automutex locker(m_mutex);
-    api_flush();
+    drain_queues();                     /* events queued by play()          */
+    if (m_batching)
+        m_flush_pending = true;
+    else
+        api_flush();
 }
 
 /**
  *  Stops all notes on all channels on all busses.  Adapted from Oli Kester's
  *  Kepler34 project.  Whether the buss is active or not is ultimately checked
- *  in the busarray::play() function.  A bit wasteful, but do we really care?
+ *  in the busarray::play() function.  Only the notes still sounding (see
+ *  m_active_notes) get a Note Off, rather than every note of every channel,
+ *  which flooded slow devices with thousands of messages.
+ *
+ * \threadsafe
  */
 
 void
 mastermidibase::panic ()
 {
     automutex locker(m_mutex);
+    drain_queues();
+    m_scheduler.clear();                /* pending notes would restart      */
+    send_note_offs();
+    flush();
+}
+
+/**
+ *  Sends a Note Off for each note still sounding, whichever pattern (or
+ *  other source) sent it.  Unlike panic(), the scheduler keeps its pending
+ *  events, except the Note Ons, which have not sounded yet.  While the
+ *  output is captured, nothing is sent to the busses, so nothing is done.
+ *
+ * \threadsafe
+ */
+
+void
+mastermidibase::all_notes_off ()
+{
+    automutex locker(m_mutex);
+    if (is_nullptr(m_capture.load()))
+    {
+        drain_queues();
+        (void) m_scheduler.cancel_note_ons();
+        send_note_offs();
+    }
+    flush();
+}
+
+/**
+ *  Sends a Note Off for each note in m_active_notes, and empties it.  The
+ *  caller holds the mutex, and flushes the busses.
+ */
+
+void
+mastermidibase::send_note_offs ()
+{
+    bussbyte bus;
+    midibyte channel, note;
     event e;
     e.set_status(EVENT_NOTE_OFF);
-    flush();
-    for (int bus = 0; bus < c_busscount_max; ++bus)
+    while (m_active_notes.pop(bus, channel, note))
     {
-        for (int channel = 0; channel < c_midichannel_max; ++channel)
-        {
-            for (int note = 0; note < c_midibyte_data_max; ++note)
-            {
-                e.set_data(note, 0);            /* values > 0 do expression */
-                m_outbus_array.play(bus, &e, channel);
-            }
-        }
+        e.set_data(note, 0);                /* values > 0 do expression     */
+        m_outbus_array.play(bus, &e, channel);
     }
 }
 
+/**
+ *  Sets the output transform of a buss, which is applied to every channel
+ *  event sent to it, after the transform of the pattern.  Notes sounding
+ *  when the transform changes are left to all_notes_off().
+ *
+ * \threadsafe
+ *
+ * \param bus
+ *      The output buss.
+ *
+ * \param ot
+ *      The transform.  The default outtransform removes the transform.
+ *
+ * \return
+ *      Returns false if the buss number is out of range.
+ */
+
+bool
+mastermidibase::bus_transform (bussbyte bus, const outtransform & ot)
+{
+    bool result = int(bus) < c_busscount_max;
+    if (result)
+    {
+        automutex locker(m_mutex);
+        m_bus_transforms[bus] = ot;
+    }
+    return result;
+}
+
 /**
  *  Handle the sending of SYSEX events.  The event is sent to all MIDI output
  *  busses.  Then flush() is called.
@@ -321,7 +427,642 @@ void
 mastermidibase::play (bussbyte bus, event * e24, midibyte channel)
 {
     automutex locker(m_mutex);
+    midicapture * cap = m_capture.load();
+    if (not_nullptr(cap))
+    {
+        cap->add(bus, *e24, channel);
+        return;
+    }
+    drain_queues();                     /* keep the events in order         */
+    bool stamp = m_deliver_until > 0 && m_deliver_until > microtime();
+    if (stamp)
+        api_deliver_at(m_deliver_until);        /* stay behind queued events */
+
+    send(bus, e24, channel);
+    if (stamp)
+        api_deliver_at(0);
+}
+
+/**
+ *  Plays a Note Off that ends a note of a pattern, such as one sent by
+ *  sequence::off_playing_notes() when the pattern is muted or stopped.  If
+ *  the matching Note On is still waiting in the lookahead scheduler, it is
+ *  dropped, since it would otherwise sound after the Note Off and hang.
+ *  Other Note Offs, such as MIDI thru or the piano roll, go through play()
+ *  and leave the scheduler alone.
+ *
+ * \threadsafe
+ *
+ * \param bus
+ *      The buss on which to play the Note Off.
+ *
+ * \param e24
+ *      The Note Off event.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ */
+
+void
+mastermidibase::play_off (bussbyte bus, event * e24, midibyte channel)
+{
+    automutex locker(m_mutex);
+    if (is_nullptr(m_capture.load()))
+    {
+        drain_queues();                 /* so queued Note Ons are found     */
+        if (! m_scheduler.empty() && e24->is_note_off())
+            (void) m_scheduler.cancel_note_on(bus, channel, e24->get_note());
+    }
+    play(bus, e24, channel);
+}
+
+/**
+ *  Sends an event to a buss, counting it for the playback statistics, and
+ *  keeping track of the notes that are sounding.  If the buss has an output
+ *  transform, it is applied to a copy of the event first.  The caller holds
+ *  the mutex.
+ */
+
+void
+mastermidibase::send (bussbyte bus, event * e24, midibyte channel)
+{
+    if (int(bus) < c_busscount_max && ! m_bus_transforms[bus].identity())
+    {
+        event copy(*e24);
+        m_bus_transforms[bus].apply(copy, channel);
+        deliver(bus, &copy, channel);
+    }
+    else
+        deliver(bus, e24, channel);
+}
+
+/**
+ *  The second half of send().
+ */
+
+void
+mastermidibase::deliver (bussbyte bus, event * e24, midibyte channel)
+{
+    if (e24->is_note_on() && ! e24->is_note_off_recorded())
+        m_active_notes.note_on(bus, channel, e24->get_note());
+    else if (e24->is_note_off() || e24->is_note_off_recorded())
+        m_active_notes.note_off(bus, channel, e24->get_note());
+
     m_outbus_array.play(bus, e24, channel);
+    if (int(bus) < c_busscount_max)
+        ++m_bus_events[bus];
+}
+
+/**
+ *  Sends an event taken from the scheduler.  A MIDI clock goes to the
+ *  clock function of the buss, since it is not a channel event.
+ *
+ * \param slot
+ *      The event and its buss.
+ *
+ * \param e
+ *      Scratch event used to rebuild a channel event.
+ */
+
+void
+mastermidibase::send_slot (const schedslot & slot, event & e)
+{
+    if (slot.ss_status == EVENT_MIDI_CLOCK)
+    {
+        m_outbus_array.send_clock(slot.ss_bus, c_null_midipulse);
+    }
+    else
+    {
+        e.set_status(slot.ss_status);
+        e.set_data(slot.ss_d0, slot.ss_d1);
+        send(slot.ss_bus, &e, slot.ss_channel);
+    }
+}
+
+/**
+ *  Plays an event rendered ahead of time.  This is the path of the output
+ *  thread (or of the JACK process callback in engine mode), which is the
+ *  only caller.  Normally the event is pushed onto the lock-free queue of
+ *  its buss, and no mutex is taken.  The queues are emptied by the
+ *  functions of the output cycle, such as schedule_origin(), dispatch(),
+ *  emit_clock(), and end_cycle().  There, if scheduling is active, the
+ *  event is queued with the deadline calculated from its pulse, and is sent
+ *  by a later call to dispatch().  Otherwise it is sent right away, which
+ *  is the legacy behavior.
+ *
+ *  If the output is being captured, or the queue is full (or was never
+ *  allocated, for a port that appeared later), the event takes the locked
+ *  path, after the queued events, so that the order is kept.
+ *
+ * \threadsafe
+ *
+ * \param bus
+ *      The bus to play on.
+ *
+ * \param e24
+ *      The seq66 event to play on the buss.  Must be a channel event.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param tick
+ *      The global pulse at which the event is meant to sound.
+ */
+
+void
+mastermidibase::play_at
+(
+    bussbyte bus, event * e24, midibyte channel, midipulse tick
+)
+{
+    bool queued = is_nullptr(m_capture.load()) && int(bus) < c_busscount_max;
+    if (queued)
+        queued = m_outqueues[bus].push(channel, *e24, tick);
+
+    if (! queued)
+    {
+        automutex locker(m_mutex);
+        midicapture * cap = m_capture.load();
+        if (not_nullptr(cap))
+        {
+            cap->add(bus, *e24, channel, tick);
+        }
+        else
+        {
+            drain_queues();
+            if (m_scheduler.active())
+            {
+                long deadline = m_scheduler.deadline(tick);
+                m_scheduler.push(deadline, bus, channel, *e24);
+            }
+            else
+            {
+                send(bus, e24, channel);
+                flush();
+            }
+        }
+    }
+}
+
+/**
+ *  Sizes the queue of each output buss found by api_init().  Called before
+ *  the output thread starts.
+ */
+
+void
+mastermidibase::make_queues ()
+{
+    int busses = m_outbus_array.count();
+    if (busses > c_busscount_max)
+        busses = c_busscount_max;
+
+    for (int bus = 0; bus < busses; ++bus)
+        m_outqueues[bus].allocate();
+}
+
+/**
+ *  Empties the queues filled by play_at().  If scheduling is active, each
+ *  event goes to the scheduler, with the deadline of its pulse at the
+ *  current origin.  Otherwise it is sent, and the busses are flushed.  The
+ *  caller holds the mutex, which makes this the single consumer of the
+ *  queues, and protects the scheduler and busses that it shares with the
+ *  other threads; see m_outqueues.  The queues are taken one buss at a
+ *  time; only the order of the events of each buss matters.
+ */
+
+void
+mastermidibase::drain_queues ()
+{
+    int busses = m_outbus_array.count();
+    if (busses > c_busscount_max)
+        busses = c_busscount_max;
+
+    bool scheduling = m_scheduler.active();
+    bool sent = false;
+    outslot slot;
+    event e;
+    for (int bus = 0; bus < busses; ++bus)
+    {
+        outqueue & q = m_outqueues[bus];
+        while (q.pop(slot))
+        {
+            e.set_status(slot.os_status);
+            e.set_data(slot.os_d0, slot.os_d1);
+            if (scheduling)
+            {
+                long deadline = m_scheduler.deadline(slot.os_tick);
+                m_scheduler.push(deadline, bussbyte(bus), slot.os_channel, e);
+            }
+            else
+            {
+                send(bussbyte(bus), &e, slot.os_channel);
+                sent = true;
+            }
+        }
+    }
+    if (sent)
+        flush();
+}
+
+/**
+ *  Sets the size of the lookahead window.  A value of 0 disables scheduling,
+ *  and any pending events are sent right away.
+ *
+ * \threadsafe
+ *
+ * \param us
+ *      The window in microseconds.
+ */
+
+void
+mastermidibase::lookahead_us (long us)
+{
+    automutex locker(m_mutex);
+    if (us == 0)
+        flush_scheduled();
+    else
+        drain_queues();                 /* queued in the previous mode      */
+
+    m_scheduler.lookahead_us(us);
+}
+
+/**
+ *  Starts or stops the capture of output events.  While capturing, play()
+ *  and play_at() store the events in the given object instead of sending
+ *  them, and nothing is scheduled.
+ *
+ * \threadsafe
+ *
+ * \param cap
+ *      The object to receive the events, or null to stop capturing.  The
+ *      caller owns it, and must stop the capture before destroying it.
+ */
+
+void
+mastermidibase::capture (midicapture * cap)
+{
+    automutex locker(m_mutex);
+    if (not_nullptr(cap))
+        flush_scheduled();
+
+    m_capture = cap;
+}
+
+/**
+ *  Sets the pulse given to captured events that are played without one.
+ *
+ * \threadsafe
+ */
+
+void
+mastermidibase::capture_tick (midipulse tick)
+{
+    automutex locker(m_mutex);
+    midicapture * cap = m_capture.load();
+    if (not_nullptr(cap))
+        cap->tick(tick);
+}
+
+/**
+ *  Gets the number of events sent on each buss since the last call, and
+ *  restarts the counts.  Called by the output thread at the end of each
+ *  cycle.
+ *
+ * \threadsafe
+ *
+ * \param [out] counts
+ *      Receives one count per output buss.  It should have a capacity of
+ *      c_busscount_max, so that resizing it does not allocate.
+ *
+ * \return
+ *      Returns the number of events waiting in the lookahead scheduler.
+ */
+
+int
+mastermidibase::cycle_counts (std::vector<int> & counts)
+{
+    automutex locker(m_mutex);
+    int busses = m_outbus_array.count();
+    if (busses > c_busscount_max)
+        busses = c_busscount_max;
+
+    counts.resize(size_t(busses));
+    for (int bus = 0; bus < busses; ++bus)
+    {
+        counts[bus] = m_bus_events[bus];
+        m_bus_events[bus] = 0;
+    }
+    return m_scheduler.count();
+}
+
+/**
+ *  Ties the given pulse to the given microtime() value, using the current
+ *  tempo and PPQN.  Called by the output thread before each rendering pass.
+ *
+ * \threadsafe
+ *
+ * \param tick
+ *      The current pulse.
+ *
+ * \param us
+ *      The microtime() value of that pulse.
+ *
+ * \param bpm
+ *      If greater than 0, the tempo to use instead of the buss tempo.  The
+ *      performer passes the tempo from its tempo map in Song mode.
+ */
+
+void
+mastermidibase::schedule_origin (double tick, long us, midibpm bpm)
+{
+    automutex locker(m_mutex);
+    if (bpm <= 0.0)
+        bpm = m_beats_per_minute;
+
+    drain_queues();                     /* rendered with the old origin     */
+    m_scheduler.set_origin(tick, us, bpm, m_ppqn);
+}
+
+/**
+ *  Sends all of the queued events whose deadline has arrived, then flushes
+ *  the busses if anything was sent.
+ *
+ * \threadsafe
+ *
+ * \param now
+ *      The current microtime() value.
+ *
+ *  If the MIDI API delivers events itself (see deliver_ahead()), the events
+ *  due a little later are also sent, each stamped with its deadline.
+ *
+ * \return
+ *      Returns the time at which to call this function again, the deadline
+ *      of the next pending event (less the delivery window), or 0 if the
+ *      queue is empty.
+ */
+
+long
+mastermidibase::dispatch (long now)
+{
+    automutex locker(m_mutex);
+    schedslot slot;
+    bool sent = false;
+    bool timed = m_deliver_ahead_us > 0;
+    event e;
+    drain_queues();
+    while (m_scheduler.pop_due(now + m_deliver_ahead_us, slot))
+    {
+        if (timed)
+        {
+            long deadline = slot.ss_deadline > now ? slot.ss_deadline : 0 ;
+            if (deadline > m_deliver_until)
+                m_deliver_until = deadline;
+
+            api_deliver_at(deadline);
+        }
+        send_slot(slot, e);
+        sent = true;
+    }
+    if (timed)
+        api_deliver_at(0);
+
+    if (sent)
+    {
+        api_flush();
+        m_flush_pending = false;        /* the pending output went too      */
+    }
+
+    long result = m_scheduler.next_deadline();
+    if (result > 0 && timed)
+    {
+        result -= m_deliver_ahead_us;
+        if (result <= 0)
+            result = 1;
+    }
+    return result;
+}
+
+/**
+ *  The version of dispatch() used when the MIDI API drives the sequencer
+ *  (see performer::engine_cycle()).  The times are not microtime() values,
+ *  but the position of the engine in microseconds of frames.  Sends every
+ *  queued event that falls inside the current period, telling the API the
+ *  frame offset of each one, so that it can be placed exactly in the period
+ *  buffer.  Events due before the period, rendered late because the period
+ *  before it was deferred, go at the first frame.
+ *
+ * \threadsafe
+ *
+ * \param start_us
+ *      The time of the first frame of the period.
+ *
+ * \param end_us
+ *      The time of the first frame of the next period.
+ *
+ * \param frames_per_us
+ *      The frame rate divided by 1000000.
+ */
+
+void
+mastermidibase::engine_dispatch
+(
+    long start_us, long end_us, double frames_per_us
+)
+{
+    automutex locker(m_mutex);
+    schedslot slot;
+    bool sent = false;
+    event e;
+    drain_queues();
+    while (m_scheduler.pop_due(end_us - 1, slot))
+    {
+        long delta = slot.ss_deadline - start_us;
+        int offset = delta > 0 ? int(double(delta) * frames_per_us) : 0 ;
+        api_frame_offset(offset);
+        send_slot(slot, e);
+        sent = true;
+    }
+    api_frame_offset(-1);
+    if (sent)
+        api_flush();
+}
+
+/**
+ *  Starts a period of the JACK process callback in engine mode (see
+ *  performer::engine_cycle()).  The mutex is tried, not waited for, since
+ *  the callback must not block.  If it is taken, the mutex stays locked
+ *  for the rest of the period, so that the locking functions called by the
+ *  engine, such as schedule_origin(), emit_clock(), and engine_dispatch(),
+ *  only lock it again recursively.
+ *
+ * \return
+ *      Returns true if the mutex was taken; engine_end() must then be
+ *      called.  Returns false if another thread holds it.
+ */
+
+bool
+mastermidibase::engine_begin ()
+{
+    return m_mutex.try_lock();
+}
+
+/**
+ *  Ends a period started by a successful engine_begin().
+ */
+
+void
+mastermidibase::engine_end ()
+{
+    m_mutex.unlock();
+}
+
+/**
+ *  Keeps the lookahead scheduler from growing past its reserved size.  Set
+ *  in engine mode, so that the JACK process callback does not allocate.
+ *  The events that do not fit are dropped and counted (see
+ *  dropped_events()).
+ *
+ * \threadsafe
+ *
+ * \param flag
+ *      True to fix the capacity, false to let it grow again.
+ */
+
+void
+mastermidibase::schedule_fixed (bool flag)
+{
+    automutex locker(m_mutex);
+    m_scheduler.fixed_capacity(flag);
+}
+
+/**
+ *  Gets the number of events dropped by a full scheduler since the last
+ *  call, and restarts the count.
+ *
+ * \threadsafe
+ */
+
+int
+mastermidibase::dropped_events ()
+{
+    automutex locker(m_mutex);
+    return m_scheduler.take_dropped();
+}
+
+/**
+ *  Empties the queue when playback stops.  Pending Note Offs and other
+ *  channel events are sent right away.  Pending Note Ons are dropped, since
+ *  they have not sounded yet; the Note Offs sent later by
+ *  sequence::off_playing_notes() are then harmless.  Pending MIDI clocks
+ *  are dropped as well, rather than sent in a burst.  Events already handed
+ *  over to the MIDI API are still delivered, and the events sent here are
+ *  stamped to follow them.
+ *
+ * \threadsafe
+ */
+
+void
+mastermidibase::flush_scheduled ()
+{
+    automutex locker(m_mutex);
+    schedslot slot;
+    bool sent = false;
+    bool stamp = m_deliver_until > 0 && m_deliver_until > microtime();
+    event e;
+    drain_queues();
+    if (stamp)
+        api_deliver_at(m_deliver_until);        /* stay behind queued events */
+
+    while (m_scheduler.pop(slot))
+    {
+        bool keep = slot.ss_status != EVENT_NOTE_ON &&
+            slot.ss_status != EVENT_MIDI_CLOCK;
+
+        if (keep)
+        {
+            send_slot(slot, e);
+            sent = true;
+        }
+    }
+    m_scheduler.clear();
+    if (stamp)
+        api_deliver_at(0);
+
+    if (sent)
+        api_flush();
+}
+
+/**
+ *  Lets the MIDI API deliver the scheduled events itself, if it can.  Then
+ *  dispatch() hands each event over a little before its deadline, stamped
+ *  with the deadline, and the API (the kernel, for the ALSA queue) sends it
+ *  at the right time.  This removes the wakeup jitter of the output thread.
+ *  Called by the output thread when playback starts.
+ *
+ * \threadsafe
+ *
+ * \param us
+ *      How far ahead of their deadlines the events are handed over, in
+ *      microseconds.  This should cover the wakeup lateness of the output
+ *      thread.  A value of 0 turns off this mode.
+ *
+ * \return
+ *      Returns true if the API delivers the events itself.
+ */
+
+bool
+mastermidibase::deliver_ahead (long us)
+{
+    automutex locker(m_mutex);
+    bool result = us > 0 && api_timed_output(true);
+    if (! result && m_deliver_ahead_us > 0)
+        (void) api_timed_output(false);
+
+    m_deliver_ahead_us = result ? us : 0 ;
+    m_deliver_until = 0;
+    return result;
+}
+
+/**
+ *  Starts or stops the batching of the output, done by the output thread
+ *  around its playback loop.  While batching, flush() calls do not drain
+ *  the output, and the output thread calls end_cycle() once per cycle.
+ *  Stopping the batching drains anything still pending.
+ *
+ * \threadsafe
+ *
+ * \param flag
+ *      True to start batching, false to stop.
+ */
+
+void
+mastermidibase::batch_output (bool flag)
+{
+    automutex locker(m_mutex);
+    m_batching = flag;
+    if (! flag)
+        end_cycle();
+}
+
+/**
+ *  Empties the buss queues, then drains the output of all busses, if
+ *  anything was flushed during the cycle.  With ALSA, all of the ports
+ *  share one client, and this is the only snd_seq_drain_output() call of
+ *  the cycle.
+ *
+ * \threadsafe
+ */
+
+void
+mastermidibase::end_cycle ()
+{
+    automutex locker(m_mutex);
+    drain_queues();
+    if (m_flush_pending)
+    {
+        m_flush_pending = false;
+        api_flush();
+    }
 }
 
 /**
@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2016-11-25
- * \updates       2020-08-02
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This file provides a cross-platform implementation of MIDI support.
@@ -174,8 +174,7 @@ midibase::midibase
     m_lasttick          (0),
     m_is_virtual_port   (makevirtual),
     m_is_input_port     (isinput),
-    m_is_system_port    (makesystem),
-    m_mutex             ()
+    m_is_system_port    (makesystem)
 {
     if (! makevirtual)
     {
@@ -564,7 +563,9 @@ midibase::print ()
  *  direct-passing mode to send the event without queueing, and puts it in the
  *  queue.
  *
- * \threadsafe
+ *  This function, like sysex(), flush(), and clock(), does no locking.  It
+ *  is called only through the master buss, which holds its own mutex, so a
+ *  second lock for each event is not needed.
  *
  * \param e24
  *      The event to be played on this bus.  For speed, we don't bother to
@@ -577,7 +578,6 @@ midibase::print ()
 void
 midibase::play (event * e24, midibyte channel)
 {
-    automutex locker(m_mutex);
     api_play(e24, channel);
 }
 
@@ -592,7 +592,6 @@ midibase::play (event * e24, midibyte channel)
 void
 midibase::sysex (event * e24)
 {
-    automutex locker(m_mutex);
     api_sysex(e24);
 }
 
@@ -603,7 +602,6 @@ midibase::sysex (event * e24)
 void
 midibase::flush ()
 {
-    automutex locker(m_mutex);
     api_flush();
 }
 
@@ -748,10 +746,10 @@ midibase::stop ()
 }
 
 /**
- *  Generates the MIDI clock, starting at the given tick value.  The number
- *  of ticks needed is calculated.
- *
- * \threadsafe
+ *  Generates the MIDI clock, starting at the given tick value.  Each clock
+ *  pulse due up to the tick is sent, with its own pulse value.  The master
+ *  buss flushes the output of all of the busses afterward.  The master buss
+ *  holds its mutex.
  *
  * \param tick
  *      Provides the starting tick.
@@ -760,20 +758,65 @@ midibase::stop ()
 void
 midibase::clock (midipulse tick)
 {
-    automutex locker(m_mutex);
-    if (clock_enabled())
+    for (midipulse c = next_clock(tick); c >= 0; c = next_clock(tick))
+        api_clock(c);
+}
+
+/**
+ *  Finds the next MIDI clock pulse not yet sent.  The clock boundary (a
+ *  multiple of PPQN / 24) is calculated directly, instead of walking from
+ *  the last tick one pulse at a time, so the cost depends on the number of
+ *  clocks, not on the PPQN.  Used by clock(), and by the master buss to
+ *  schedule each clock at its own time.
+ *
+ * \param tick
+ *      The last pulse that is due.
+ *
+ * \return
+ *      Returns the pulse of the next clock, if it is not later than the
+ *      tick, and marks it as sent.  Otherwise, -1 is returned, and all of
+ *      the pulses up to the tick are marked as covered.
+ */
+
+midipulse
+midibase::next_clock (midipulse tick)
+{
+    midipulse result = -1;
+    if (clock_enabled() && m_lasttick < tick)
     {
-        bool done = m_lasttick >= tick;
-        int ct = clock_ticks_from_ppqn(m_ppqn);         /* ppqn / 24        */
-        while (! done)
+        midipulse ct = clock_ticks_from_ppqn(m_ppqn);   /* ppqn / 24        */
+        if (ct < 1)
+            ct = 1;
+
+        midipulse next = m_lasttick + 1;                /* at least -1 + 1  */
+        midipulse leftover = next % ct;
+        if (leftover > 0)
+            next += ct - leftover;
+
+        if (next <= tick)
         {
-            ++m_lasttick;
-            done = m_lasttick >= tick;
-            if ((m_lasttick % ct) == 0)                 /* tick time yet?   */
-                api_clock(tick);
+            m_lasttick = next;
+            result = next;
         }
-        api_flush();                                    /* and send it out  */
+        else
+            m_lasttick = tick;
     }
+    return result;
+}
+
+/**
+ *  Sends one MIDI clock right away, with no check of the pulse.  Used for
+ *  the clocks queued by the master buss at their deadlines.
+ *
+ * \param tick
+ *      The pulse of the clock, used only for debugging.
+ */
+
+void
+midibase::send_clock (midipulse tick)
+{
+    if (clock_enabled())
+        api_clock(tick);
 }
 
 /**
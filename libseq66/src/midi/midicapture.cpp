@@ -0,0 +1,156 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midicapture.cpp
+ *
+ *  This module defines an in-memory sink for the output of the performer.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  See the midicapture.hpp module for an overview.
+ */
+
+#include <algorithm>                    /* std::sort()                      */
+
+#include "midi/event.hpp"               /* seq66::event                     */
+#include "midi/midicapture.hpp"         /* seq66::midicapture               */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  The number of events reserved up front, enough for a few minutes of a
+ *  busy song.  The vector grows as needed after that.
+ */
+
+static const size_t c_capture_reserve = 65536;
+
+/**
+ *  Default constructor.
+ */
+
+midicapture::midicapture () :
+    m_events    (),
+    m_tempos    (),
+    m_tick      (0),
+    m_order     (0)
+{
+    m_events.reserve(c_capture_reserve);
+}
+
+/**
+ *  Stores an event.  The channel is applied the same way the output busses
+ *  apply it.
+ *
+ * \param bus
+ *      The output buss.
+ *
+ * \param e
+ *      The event, which must be a channel event.
+ *
+ * \param channel
+ *      The channel passed to mastermidibase::play().
+ *
+ * \param tick
+ *      The pulse of the event.  If c_null_midipulse, the current pulse of
+ *      the virtual clock is used.
+ */
+
+void
+midicapture::add
+(
+    bussbyte bus,
+    const event & e,
+    midibyte channel,
+    midipulse tick
+)
+{
+    capturedevent ce;
+    ce.ce_tick = is_null_midipulse(tick) ? m_tick : tick ;
+    ce.ce_order = m_order++;
+    ce.ce_bus = bus;
+    ce.ce_status = e.get_status() + (channel & 0x0F);
+    e.get_data(ce.ce_d0, ce.ce_d1);
+    m_events.push_back(ce);
+}
+
+/**
+ *  Stores a tempo change, unless the tempo is the same as the last one.
+ */
+
+void
+midicapture::add_tempo (midipulse tick, midibpm bpm)
+{
+    if (m_tempos.empty() || m_tempos.back().tc_bpm != bpm)
+    {
+        tempochange tc;
+        tc.tc_tick = tick;
+        tc.tc_bpm = bpm;
+        m_tempos.push_back(tc);
+    }
+}
+
+/**
+ *  Sorts the events by pulse.  Events with the same pulse stay in the order
+ *  in which they were played.  Events scheduled ahead of time can be
+ *  captured before events played at an earlier pulse, so this is needed
+ *  before writing.
+ */
+
+void
+midicapture::sort ()
+{
+    auto earlier = [] (const capturedevent & a, const capturedevent & b)
+    {
+        if (a.ce_tick == b.ce_tick)
+            return a.ce_order < b.ce_order;
+        else
+            return a.ce_tick < b.ce_tick;
+    };
+    std::sort(m_events.begin(), m_events.end(), earlier);
+}
+
+/**
+ *  Drops everything captured so far.
+ */
+
+void
+midicapture::clear ()
+{
+    m_events.clear();
+    m_tempos.clear();
+    m_tick = 0;
+    m_order = 0;
+}
+
+}           // namespace seq66
+
+/*
+ * midicapture.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -24,7 +24,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2020-11-13
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  For a quick guide to the MIDI format, see, for example:
@@ -85,10 +85,12 @@
  *      -#  Any data bytes are ignored when the buffer is 0.
  */
 
+#include <algorithm>                    /* std::find(), std::sort()         */
 #include <fstream>                      /* std::ifstream and std::ofstream  */
 #include <memory>                       /* std::unique_ptr<>                */
 
 #include "cfg/settings.hpp"             /* seq66::rc() and choose_ppqn()    */
+#include "midi/midicapture.hpp"         /* seq66::midicapture               */
 #include "midi/midifile.hpp"            /* seq66::midifile                  */
 #include "midi/midi_vector.hpp"         /* seq66::midi_vector container     */
 #include "midi/wrkfile.hpp"             /* seq66::wrkfile class             */
@@ -2191,14 +2193,17 @@ midifile::varinum_size (long len) const
  *                -# Otherwise, 2 bytes + varinum_size(length) + 4 bytes.
  *                -# Length of the prop data.
  *          -# Track End. 3 bytes.
+ *
+ *  The header format is 1, except for a song rendered as SMF 0; see
+ *  write_capture().
  */
 
 bool
-midifile::write_header (int numtracks)
+midifile::write_header (int numtracks, int format)
 {
-    write_long(0x4D546864);                 /* MIDI Format 1 header MThd    */
+    write_long(0x4D546864);                 /* MIDI header MThd             */
     write_long(6);                          /* Length of the header         */
-    write_short(1);                         /* MIDI Format 1                */
+    write_short(format);                    /* MIDI Format 0 or 1           */
     write_short(numtracks);                 /* number of tracks             */
     write_short(m_ppqn);                    /* parts per quarter note       */
     return numtracks > 0;
@@ -2660,6 +2665,216 @@ midifile::write_song (performer & p)
     return result;
 }
 
+/**
+ *  Values for the bus parameter of write_capture_track().
+ */
+
+static const int c_capture_all_busses = (-1);
+static const int c_capture_no_busses = (-2);
+
+/**
+ *  Writes a song rendered by performer::bounce() as a standard MIDI file.
+ *  Unlike write_song(), which unrolls the triggers of each pattern, this
+ *  writes exactly what was played, so mutes, queueing, and transposition
+ *  are included.  Sequencer-specific data is not written.
+ *
+ *  For SMF 0, a single track holds the time signature, the tempo changes,
+ *  and all of the events.  For SMF 1, the first track holds the time
+ *  signature and tempo changes, and each output buss that was used gets a
+ *  track of its own, named after the buss number.
+ *
+ * \param cap
+ *      The render, already sorted by pulse.
+ *
+ * \param format
+ *      The SMF format, 0 or 1.
+ *
+ * \param beatsperbar
+ *      The numerator of the time signature.
+ *
+ * \param beatwidth
+ *      The denominator of the time signature.
+ *
+ * \return
+ *      Returns true if the write operations succeeded.  If false is returned,
+ *      then m_error_message will contain a description of the error.
+ */
+
+bool
+midifile::write_capture
+(
+    const midicapture & cap,
+    int format,
+    int beatsperbar,
+    int beatwidth
+)
+{
+    automutex locker(m_mutex);
+    m_error_message.clear();
+    bool result = ! cap.empty();
+    if (result)
+    {
+        std::vector<int> busses;
+        for (const auto & ce : cap.captured())
+        {
+            int b = int(ce.ce_bus);
+            if (std::find(busses.begin(), busses.end(), b) == busses.end())
+                busses.push_back(b);
+        }
+        std::sort(busses.begin(), busses.end());
+
+        bool smf0 = format == 0;
+        int numtracks = smf0 ? 1 : int(busses.size()) + 1 ;
+        printf
+        (
+            "[Rendering song as SMF %d, %d tracks, %d ppqn]\n",
+            smf0 ? 0 : 1, numtracks, m_ppqn
+        );
+        result = write_header(numtracks, smf0 ? 0 : 1);
+        if (smf0)
+        {
+            write_capture_track
+            (
+                cap, "Song", beatsperbar, beatwidth, true, c_capture_all_busses
+            );
+        }
+        else
+        {
+            write_capture_track
+            (
+                cap, "Tempo", beatsperbar, beatwidth, true, c_capture_no_busses
+            );
+            for (auto b : busses)
+            {
+                std::string name = "Bus " + std::to_string(b);
+                write_capture_track(cap, name, beatsperbar, beatwidth, false, b);
+            }
+        }
+    }
+    else
+        m_error_message = "Nothing was rendered";
+
+    if (result)
+    {
+        std::ofstream file
+        (
+            m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
+        );
+        if (file.is_open())
+        {
+            char file_buffer[SEQ66_MIDI_LINE_MAX];  /* enable bufferization */
+            file.rdbuf()->pubsetbuf(file_buffer, sizeof file_buffer);
+            for (auto c : m_char_list)
+            {
+                char kc = char(c);
+                file.write(&kc, 1);
+            }
+            m_char_list.clear();
+        }
+        else
+        {
+            m_error_message = "Error opening MIDI file for rendering";
+            result = false;
+        }
+    }
+    return result;
+}
+
+/**
+ *  Writes one track of a render.  The track body is built by itself, so
+ *  that its size is known before the track header is written.
+ *
+ * \param cap
+ *      The render.
+ *
+ * \param name
+ *      The name of the track.
+ *
+ * \param beatsperbar
+ *      The numerator of the time signature, used if \a meta is true.
+ *
+ * \param beatwidth
+ *      The denominator of the time signature, used if \a meta is true.
+ *
+ * \param meta
+ *      If true, the time signature and the tempo changes are written, merged
+ *      with the events.
+ *
+ * \param bus
+ *      The buss whose events are written, c_capture_all_busses, or
+ *      c_capture_no_busses.
+ */
+
+void
+midifile::write_capture_track
+(
+    const midicapture & cap,
+    const std::string & name,
+    int beatsperbar,
+    int beatwidth,
+    bool meta,
+    int bus
+)
+{
+    std::list<midibyte> saved;
+    saved.swap(m_char_list);                /* build the body by itself     */
+    write_track_name(name);
+
+    const auto & tempos = cap.tempos();
+    size_t ti = 0;
+    midipulse previous = 0;
+    auto write_tempo = [&] (const tempochange & tc)
+    {
+        write_varinum(midilong(tc.tc_tick - previous));
+        previous = tc.tc_tick;
+        write_short(0xFF51);
+        write_byte(0x03);                   /* message length, must be 3    */
+        write_triple(midilong(tempo_us_from_bpm(tc.tc_bpm)));
+    };
+    if (meta)
+    {
+        write_byte(0x00);                   /* delta time at beginning      */
+        write_short(0xFF58);
+        write_byte(0x04);                   /* the message length           */
+        write_byte(beatsperbar);            /* nn                           */
+        write_byte(beat_log2(beatwidth));   /* dd                           */
+        write_short(0x1808);                /* cc bb                        */
+    }
+    if (bus != c_capture_no_busses)
+    {
+        for (const auto & ce : cap.captured())
+        {
+            if (bus != c_capture_all_busses && int(ce.ce_bus) != bus)
+                continue;
+
+            if (ce.ce_status < 0x80 || ce.ce_status >= 0xF0)
+                continue;                   /* channel messages only        */
+
+            while (meta && ti < tempos.size() && tempos[ti].tc_tick <= ce.ce_tick)
+                write_tempo(tempos[ti++]);
+
+            write_varinum(midilong(ce.ce_tick - previous));
+            previous = ce.ce_tick;
+            write_byte(ce.ce_status);
+            write_byte(ce.ce_d0);
+            if (! event::is_one_byte_msg(ce.ce_status & EVENT_CLEAR_CHAN_MASK))
+                write_byte(ce.ce_d1);
+        }
+    }
+    while (meta && ti < tempos.size())
+        write_tempo(tempos[ti++]);
+
+    write_byte(0x00);                       /* delta time of the end        */
+    write_track_end();
+
+    std::list<midibyte> body;
+    body.swap(m_char_list);
+    m_char_list.swap(saved);
+    write_long(SEQ66_MTRK_TAG);             /* magic number 'MTrk'          */
+    write_long(midilong(body.size()));
+    m_char_list.splice(m_char_list.end(), body);
+}
+
 /**
  *  Writes out the final proprietary/SeqSpec section, using the new format.
  *
@@ -3131,6 +3346,65 @@ write_midi_file
     return result;
 }
 
+/**
+ *  Renders the playing screenset offline and writes it as a standard MIDI
+ *  file.  See performer::bounce() and midifile::write_capture().
+ *
+ * \param p
+ *      The performer, which must not be running.
+ *
+ * \param fn
+ *      The name of the file to write.
+ *
+ * \param format
+ *      The SMF format, 0 or 1.
+ *
+ * \param [out] errmsg
+ *      Holds the reason for a failure.
+ *
+ * \return
+ *      Returns true if the file was written.
+ */
+
+bool
+bounce_midi_file
+(
+    performer & p,
+    const std::string & fn,
+    int format,
+    std::string & errmsg
+)
+{
+    bool result = false;
+    if (fn.empty())
+    {
+        errmsg = "No file-name for bounce_midi_file()";
+    }
+    else
+    {
+        midicapture cap;
+        result = p.bounce(cap, c_null_midipulse, errmsg);
+        if (result)
+        {
+            midifile f(fn, p.ppqn());
+            result = f.write_capture
+            (
+                cap, format, p.get_beats_per_bar(), p.get_beat_width()
+            );
+            if (result)
+            {
+                file_message("Rendered MIDI file", fn);
+            }
+            else
+            {
+                errmsg = f.error_message();
+                file_error("Render failed", fn);
+            }
+        }
+    }
+    return result;
+}
+
 }           // namespace seq66
 
 /*
@@ -0,0 +1,156 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          outqueue.cpp
+ *
+ *  This module defines the lock-free queue of outgoing MIDI events.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  See the outqueue.hpp module for an overview.
+ */
+
+#include "midi/event.hpp"               /* seq66::event                     */
+#include "midi/outqueue.hpp"            /* seq66::outqueue                  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  Creates an empty queue, which holds nothing until allocate() is called.
+ */
+
+outqueue::outqueue () :
+    m_ring  (),
+    m_mask  (0),
+    m_head  (0),
+    m_tail  (0)
+{
+    // Empty body
+}
+
+/**
+ *  Sizes the ring.  This is not thread-safe; it must be done before the
+ *  producer and consumer start.
+ *
+ * \param size
+ *      The number of events to hold, rounded up to a power of 2.
+ */
+
+void
+outqueue::allocate (unsigned size)
+{
+    unsigned count = 1;
+    while (count < size)
+        count <<= 1;
+
+    m_ring.resize(size_t(count));
+    m_mask = count - 1;
+    m_head.store(0);
+    m_tail.store(0);
+}
+
+/**
+ *  Adds an event.  Called only by the producer.  Does not lock or allocate.
+ *
+ * \param channel
+ *      The channel on which the event is to be played.
+ *
+ * \param e
+ *      The event, which must be a channel event.
+ *
+ * \param tick
+ *      The pulse at which the event is meant to sound.
+ *
+ * \return
+ *      Returns false if the queue is full or was never allocated.
+ */
+
+bool
+outqueue::push (midibyte channel, const event & e, midipulse tick)
+{
+    bool result = ! m_ring.empty();
+    if (result)
+    {
+        unsigned head = m_head.load(std::memory_order_relaxed);
+        unsigned tail = m_tail.load(std::memory_order_acquire);
+        result = (head - tail) <= m_mask;
+        if (result)
+        {
+            outslot & slot = m_ring[head & m_mask];
+            slot.os_tick = tick;
+            slot.os_channel = channel;
+            slot.os_status = e.get_status();
+            e.get_data(slot.os_d0, slot.os_d1);
+            m_head.store(head + 1, std::memory_order_release);
+        }
+    }
+    return result;
+}
+
+/**
+ *  Removes the oldest event.  Called only by the consumer.
+ *
+ * \param [out] slot
+ *      Receives the event, if there is one.
+ *
+ * \return
+ *      Returns true if an event was removed.
+ */
+
+bool
+outqueue::pop (outslot & slot)
+{
+    unsigned tail = m_tail.load(std::memory_order_relaxed);
+    unsigned head = m_head.load(std::memory_order_acquire);
+    bool result = tail != head;
+    if (result)
+    {
+        slot = m_ring[tail & m_mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+    }
+    return result;
+}
+
+/**
+ *  Drops the events waiting in the queue.  Called only by the consumer.
+ */
+
+void
+outqueue::clear ()
+{
+    unsigned head = m_head.load(std::memory_order_acquire);
+    m_tail.store(head, std::memory_order_release);
+}
+
+}           // namespace seq66
+
+/*
+ * outqueue.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
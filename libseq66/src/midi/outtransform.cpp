@@ -0,0 +1,195 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          outtransform.cpp
+ *
+ *  This module defines the transformation applied to events as they are
+ *  played.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  See the outtransform.hpp module for an overview.
+ */
+
+#include <utility>                      /* std::swap()                      */
+
+#include "midi/event.hpp"               /* seq66::event                     */
+#include "midi/outtransform.hpp"        /* seq66::outtransform              */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  Creates a transform that changes nothing.
+ */
+
+outtransform::outtransform () :
+    m_transpose     (0),
+    m_velocity      (c_velocity_scale_default),
+    m_channel       (c_midibyte_max),
+    m_note_min      (0),
+    m_note_max      (c_midibyte_data_max - 1)
+{
+    // Empty body
+}
+
+/**
+ * \setter m_transpose
+ *
+ * \param semitones
+ *      The transposition, clamped to plus or minus one MIDI range.
+ */
+
+void
+outtransform::transpose (int semitones)
+{
+    int limit = int(c_midibyte_data_max) - 1;
+    if (semitones > limit)
+        semitones = limit;
+    else if (semitones < -limit)
+        semitones = -limit;
+
+    m_transpose = semitones;
+}
+
+/**
+ * \setter m_velocity
+ *
+ * \param percent
+ *      The velocity scale, clamped to the range 1 to c_velocity_scale_max.
+ */
+
+void
+outtransform::velocity (int percent)
+{
+    if (percent < 1)
+        percent = 1;
+    else if (percent > c_velocity_scale_max)
+        percent = c_velocity_scale_max;
+
+    m_velocity = percent;
+}
+
+/**
+ * \setter m_channel
+ *
+ * \param ch
+ *      The channel to move events to, or c_midibyte_max (or any value
+ *      above 15) to keep the channel of the event.
+ */
+
+void
+outtransform::channel (midibyte ch)
+{
+    m_channel = ch < c_midichannel_max ? ch : c_midibyte_max ;
+}
+
+/**
+ *  Sets the range to which notes are clamped.  The values are clamped to
+ *  the MIDI range, and swapped if given in the wrong order.
+ *
+ * \param notemin
+ *      The lowest note to be sent.
+ *
+ * \param notemax
+ *      The highest note to be sent.
+ */
+
+void
+outtransform::note_range (int notemin, int notemax)
+{
+    int limit = int(c_midibyte_data_max) - 1;
+    if (notemin > notemax)
+        std::swap(notemin, notemax);
+
+    if (notemin < 0)
+        notemin = 0;
+
+    if (notemax > limit)
+        notemax = limit;
+
+    m_note_min = midibyte(notemin);
+    m_note_max = midibyte(notemax);
+}
+
+/**
+ *  Applies the transform to an event that is about to be played.  The
+ *  caller passes a copy of the event, not the one held by the pattern.
+ *
+ * \param e
+ *      The event to transform.  Only channel events are changed.
+ *
+ * \param [in,out] ch
+ *      The channel on which the event is to be played.  Replaced by the
+ *      channel of the transform, if one is set.
+ */
+
+void
+outtransform::apply (event & e, midibyte & ch) const
+{
+    if (e.get_status() >= EVENT_MIDI_SYSEX)
+        return;
+
+    if (e.is_note())                    /* Note On, Note Off, Aftertouch    */
+    {
+        midibyte d0, d1;
+        e.get_data(d0, d1);
+
+        int note = int(d0) + m_transpose;
+        if (note < 0 || note >= int(c_midibyte_data_max))
+            note = int(d0);                         /* as transpose_note()  */
+
+        if (note < int(m_note_min))
+            note = int(m_note_min);
+        else if (note > int(m_note_max))
+            note = int(m_note_max);
+
+        int vel = int(d1);
+        bool scale = m_velocity != c_velocity_scale_default &&
+            e.is_note_on() && vel > 0;
+
+        if (scale)
+        {
+            vel = vel * m_velocity / 100;
+            if (vel < 1)
+                vel = 1;
+            else if (vel >= int(c_midibyte_data_max))
+                vel = int(c_midibyte_data_max) - 1;
+        }
+        e.set_data(midibyte(note), midibyte(vel));
+    }
+    if (! is_null_channel(m_channel))
+        ch = m_channel;
+}
+
+}           // namespace seq66
+
+/*
+ * outtransform.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,122 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playevents.cpp
+ *
+ *  This module defines the compact copy of a pattern's events used for
+ *  playback.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  See the playevents.hpp module for an overview.
+ */
+
+#include "midi/eventlist.hpp"           /* seq66::eventlist                 */
+#include "midi/playevents.hpp"          /* seq66::playevents                */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  The records are meant to be 16 bytes, with a 64-bit midipulse.
+ */
+
+static_assert
+(
+    sizeof(playevent) <= 16, "playevent must fit in 16 bytes"
+);
+
+/**
+ *  Creates an empty array.
+ */
+
+playevents::playevents () :
+    m_events        (),
+    m_tempos        ()
+{
+    // Empty body
+}
+
+/**
+ *  Rebuilds the array from an event list, which must be sorted.  The
+ *  vectors keep their capacity, so a rebuild after a small edit does not
+ *  allocate.
+ *
+ * \param evl
+ *      The event list of the pattern.
+ */
+
+void
+playevents::build (const eventlist & evl)
+{
+    m_events.clear();
+    m_tempos.clear();
+    m_events.reserve(size_t(evl.count()));
+    for (auto ei = evl.cbegin(); ei != evl.cend(); ++ei)
+    {
+        const event & ev = eventlist::cdref(ei);
+        playevent pe;
+        pe.pe_flags = 0;
+        pe.pe_extra = 0;
+        if (ev.is_tempo())
+        {
+            if (m_tempos.size() > UINT16_MAX)
+                continue;
+
+            pe.pe_flags = c_playevent_tempo;
+            pe.pe_extra = std::uint16_t(m_tempos.size());
+            m_tempos.push_back(ev.tempo());
+        }
+        else if (ev.is_ex_data())
+            continue;                           /* not played by sequence   */
+
+        pe.pe_timestamp = ev.timestamp();
+        pe.pe_status = ev.get_status();
+        pe.pe_channel = ev.channel();
+        ev.get_data(pe.pe_d0, pe.pe_d1);
+        m_events.push_back(pe);
+    }
+}
+
+/**
+ *  Empties the array.
+ */
+
+void
+playevents::clear ()
+{
+    m_events.clear();
+    m_tempos.clear();
+}
+
+}           // namespace seq66
+
+/*
+ * playevents.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
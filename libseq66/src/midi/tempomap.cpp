@@ -0,0 +1,258 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tempomap.cpp
+ *
+ *  This module defines the map of the tempo changes of a song.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  See the tempomap.hpp module for an overview.
+ */
+
+#include <algorithm>                    /* std::stable_sort(), etc.         */
+
+#include "midi/tempomap.hpp"            /* seq66::tempomap                  */
+#include "util/calculations.hpp"        /* seq66::pulse_length_us()         */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  Default constructor.  The map starts out inactive, at the default tempo.
+ */
+
+tempomap::tempomap () :
+    m_segments  (),
+    m_ppqn      (SEQ66_DEFAULT_PPQN),
+    m_active    (false)
+{
+    clear(SEQ66_DEFAULT_BPM, SEQ66_DEFAULT_PPQN);
+}
+
+/**
+ *  Empties the map, leaving a single segment at the given tempo.
+ */
+
+void
+tempomap::clear (midibpm bpm, int ppqn)
+{
+    segment s;
+    s.ts_tick = 0;
+    s.ts_bpm = bpm;
+    s.ts_us = 0.0;
+    s.ts_pulse_us = pulse_length_us(bpm, ppqn);
+    m_segments.clear();
+    m_segments.push_back(s);
+    m_ppqn = ppqn;
+    m_active = false;
+}
+
+/**
+ *  Builds the map from a list of tempo changes.  The list is sorted by pulse;
+ *  when two changes fall on the same pulse, the one added later wins, which
+ *  matches the order in which the patterns would have played them.  Then the
+ *  microsecond offset of each segment is accumulated from the previous one.
+ *
+ * \param bpm
+ *      The tempo in force before the first change.
+ *
+ * \param ppqn
+ *      The PPQN of the song.
+ *
+ * \param list
+ *      The tempo changes.  They are sorted in place.
+ */
+
+void
+tempomap::rebuild (midibpm bpm, int ppqn, changes & list)
+{
+    auto earlier = [] (const tempochange & a, const tempochange & b)
+    {
+        return a.tc_tick < b.tc_tick;
+    };
+    std::stable_sort(list.begin(), list.end(), earlier);
+
+    clear(bpm, ppqn);
+    for (const auto & tc : list)
+    {
+        if (tc.tc_tick < 0 || tc.tc_bpm <= 0.0)
+            continue;
+
+        segment & last = m_segments.back();
+        if (tc.tc_tick == last.ts_tick)
+        {
+            last.ts_bpm = tc.tc_bpm;                    /* replaces it      */
+            last.ts_pulse_us = pulse_length_us(tc.tc_bpm, ppqn);
+        }
+        else if (tc.tc_bpm != last.ts_bpm)
+        {
+            segment s;
+            s.ts_tick = tc.tc_tick;
+            s.ts_bpm = tc.tc_bpm;
+            s.ts_us = last.ts_us +
+                double(tc.tc_tick - last.ts_tick) * last.ts_pulse_us;
+
+            s.ts_pulse_us = pulse_length_us(tc.tc_bpm, ppqn);
+            m_segments.push_back(s);
+        }
+    }
+    m_active = ! list.empty();
+}
+
+bool
+tempomap::active () const
+{
+    return m_active;
+}
+
+int
+tempomap::count () const
+{
+    return int(m_segments.size());
+}
+
+/**
+ *  Finds the segment holding the given pulse.  Pulses before 0 belong to
+ *  the first segment.  No locking is needed: a published map is never
+ *  changed, and the output thread reaches it only through the snapshot it
+ *  has acquired.
+ */
+
+size_t
+tempomap::segment_at_tick (double tick) const
+{
+    auto later = [] (double t, const segment & s)
+    {
+        return t < double(s.ts_tick);
+    };
+    auto it = std::upper_bound
+    (
+        m_segments.begin(), m_segments.end(), tick, later
+    );
+    return it == m_segments.begin() ? 0 : size_t(it - m_segments.begin()) - 1 ;
+}
+
+/**
+ *  Finds the segment holding the given time.  Read-only, like
+ *  segment_at_tick(); the map is not changed once published.
+ */
+
+size_t
+tempomap::segment_at_us (double us) const
+{
+    auto later = [] (double t, const segment & s)
+    {
+        return t < s.ts_us;
+    };
+    auto it = std::upper_bound
+    (
+        m_segments.begin(), m_segments.end(), us, later
+    );
+    return it == m_segments.begin() ? 0 : size_t(it - m_segments.begin()) - 1 ;
+}
+
+/**
+ * \return
+ *      Returns the tempo in force at the given pulse.
+ */
+
+midibpm
+tempomap::bpm_at (double tick) const
+{
+    return m_segments[segment_at_tick(tick)].ts_bpm;
+}
+
+/**
+ *  Converts a song pulse to microseconds from the start of the song.
+ */
+
+double
+tempomap::tick_to_us (double tick) const
+{
+    const segment & s = m_segments[segment_at_tick(tick)];
+    return s.ts_us + (tick - double(s.ts_tick)) * s.ts_pulse_us;
+}
+
+/**
+ *  Converts microseconds from the start of the song to a song pulse.
+ */
+
+double
+tempomap::us_to_tick (double us) const
+{
+    const segment & s = m_segments[segment_at_us(us)];
+    return double(s.ts_tick) + (us - s.ts_us) / s.ts_pulse_us;
+}
+
+/**
+ *  Finds the pulse that is reached by playing for a while from a given
+ *  pulse, following any tempo changes on the way.  This is what the output
+ *  thread needs in each cycle.
+ *
+ * \param tick
+ *      The starting pulse.
+ *
+ * \param us
+ *      The elapsed time, in microseconds.
+ *
+ * \return
+ *      Returns the pulse reached, with its fraction.
+ */
+
+double
+tempomap::advance (double tick, long us) const
+{
+    return us_to_tick(tick_to_us(tick) + double(us));
+}
+
+/**
+ *  Provides the tempo of each segment, starting with the tempo at pulse 0.
+ *  Used to write the tempo track of a rendered song.
+ */
+
+tempomap::changes
+tempomap::segments () const
+{
+    changes result;
+    for (const auto & s : m_segments)
+    {
+        tempochange tc;
+        tc.tc_tick = s.ts_tick;
+        tc.tc_bpm = s.ts_bpm;
+        result.push_back(tc);
+    }
+    return result;
+}
+
+}           // namespace seq66
+
+/*
+ * tempomap.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -3,7 +3,7 @@
  * \library       seq66 application (from PSXC library)
  * \author        Chris Ahlstrom
  * \date          2005-07-03 to 2007-08-21 (pre-Sequencer24/64)
- * \updates       2020-09-07
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  Daemonization module of the POSIX C Wrapper (PSXC) library
@@ -360,6 +360,7 @@ reroute_stdio (const std::string & logfile, bool closem)
 
 static bool sg_needs_close = false;
 static bool sg_needs_save = false;
+static bool sg_needs_stats = false;
 
 /**
  *  Provides a basic session handler, called upon receipt of a POSIX signal.
@@ -392,11 +393,17 @@ session_handler (int sig)
 
         sg_needs_save = true;
         break;
+
+    case SIGUSR2:                       /* 12: "user-defined signal 2       */
+
+        sg_needs_stats = true;
+        break;
     }
 }
 
 /**
- *  Sets up the application to intercept SIGINT, SIGTERM, and SIGUSR1.
+ *  Sets up the application to intercept SIGINT, SIGTERM, SIGUSR1, and
+ *  SIGUSR2.
  */
 
 void
@@ -408,6 +415,7 @@ session_setup ()
     sigaction(SIGINT, &action, NULL);                   /* SIGINT is 2      */
     sigaction(SIGTERM, &action, NULL);                  /* SIGTERM is 15    */
     sigaction(SIGUSR1, &action, NULL);                  /* SIGUSR1 is 10    */
+    sigaction(SIGUSR2, &action, NULL);                  /* SIGUSR2 is 12    */
 }
 
 /**
@@ -442,6 +450,19 @@ session_save ()
     return result;
 }
 
+/**
+ *  Returns the boolean to indicate a request to report the playback
+ *  statistics.
+ */
+
+bool
+session_stats ()
+{
+    bool result = sg_needs_stats;
+    sg_needs_stats = false;
+    return result;
+}
+
 /**
  *  Looks up an executable in the process list using the pidof program.  This
  *  function copies the pidof command line, then opens a pipe to that process
@@ -499,6 +520,12 @@ session_save ()
     return false;
 }
 
+bool
+session_stats ()
+{
+    return false;
+}
+
 #endif  // defined SEQ66_PLATFORM_LINUX
 
 }           // namespace seq66
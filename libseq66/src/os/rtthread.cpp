@@ -0,0 +1,386 @@
+/**
+ * \file          rtthread.cpp
+ * \author        Chris Ahlstrom
+ * \date          2020-11-23
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or (at
+ *    your option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful, but
+ *    WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *    02110-1301, USA.
+ *
+ *    See the rtthread.hpp module for an overview.
+ *
+ *    In Linux, an ordinary user may raise a thread to a real-time policy
+ *    only up to the RLIMIT_RTPRIO resource limit, which is 0 unless the
+ *    administrator raises it.  Likewise, mlockall() is limited by
+ *    RLIMIT_MEMLOCK.  Most audio distributions set these limits for the
+ *    "audio" group in /etc/security/limits.d/audio.conf:
+ *
+\verbatim
+        @audio   -  rtprio     95
+        @audio   -  memlock    unlimited
+\endverbatim
+ *
+ *    Running as root is not needed, and not recommended.
+ */
+
+#include <cctype>                       /* std::isdigit()                   */
+#include <cstring>                      /* std::strerror()                  */
+
+#include "seq66_platform_macros.h"      /* detecting the platform           */
+#include "util/basic_macros.hpp"        /* seq66::msgprintf(), etc.         */
+#include "util/strfunctions.hpp"        /* seq66::tokenize(), etc.          */
+#include "os/rtthread.hpp"              /* seq66::set_thread_policy(), etc. */
+
+#if defined SEQ66_PLATFORM_LINUX
+
+#include <errno.h>                      /* EPERM                            */
+#include <pthread.h>                    /* pthread_setschedparam(), etc.    */
+#include <sched.h>                      /* SCHED_FIFO, CPU_SET(), etc.      */
+#include <sys/mman.h>                   /* mlockall()                       */
+#include <sys/resource.h>               /* getrlimit(), RLIMIT_RTPRIO       */
+
+#endif
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  Converts "fifo", "rr", or anything else (usually "normal") to the
+ *  threadpolicy value.
+ */
+
+threadpolicy
+string_to_threadpolicy (const std::string & s)
+{
+    threadpolicy result = threadpolicy::normal;
+    if (s == "fifo")
+        result = threadpolicy::fifo;
+    else if (s == "rr")
+        result = threadpolicy::rr;
+
+    return result;
+}
+
+/**
+ *  The converse of string_to_threadpolicy().
+ */
+
+std::string
+threadpolicy_to_string (threadpolicy p)
+{
+    std::string result = "normal";
+    if (p == threadpolicy::fifo)
+        result = "fifo";
+    else if (p == threadpolicy::rr)
+        result = "rr";
+
+    return result;
+}
+
+/**
+ *  Parses a list of CPU numbers in the style of taskset(1), such as "2",
+ *  "2,3", or "0-1,6".  An empty string, or "all", yields an empty list,
+ *  meaning no CPU restriction.
+ *
+ * \param s
+ *      The list to parse.
+ *
+ * \param [out] cpus
+ *      Receives the CPU numbers.
+ *
+ * \return
+ *      Returns false if the list is malformed.
+ */
+
+bool
+parse_cpu_list (const std::string & s, std::vector<int> & cpus)
+{
+    bool result = true;
+    cpus.clear();
+    if (s.empty() || s == "all")
+        return result;
+
+    std::vector<std::string> items = tokenize(s, ",");
+    for (const auto & item : items)
+    {
+        std::string::size_type dash = item.find_first_of("-", 1);
+        bool wellformed = ! item.empty() &&
+            std::isdigit(static_cast<unsigned char>(item[0])) &&
+            item.find_first_not_of("0123456789-") == std::string::npos &&
+            item.find_last_of("-") == dash;     /* at most one, not first   */
+
+        int first = wellformed ? string_to_int(item, -1) : -1 ;
+        int last = first;
+        if (dash != std::string::npos)
+            last = string_to_int(item.substr(dash + 1), -1);
+
+        if (first < 0 || last < first)
+        {
+            result = false;
+            break;
+        }
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    if (! result)
+        cpus.clear();
+
+    return result;
+}
+
+#if defined SEQ66_PLATFORM_LINUX
+
+/**
+ *  Explains why a setting failed.  For a permission error, shows the
+ *  pertinent resource limit and the usual way to raise it.
+ *
+ * \param threadname
+ *      The name of the thread (or of the process) for the message.
+ *
+ * \param what
+ *      What could not be set, e.g. "SCHED_FIFO priority 20".
+ *
+ * \param err
+ *      The errno value (or pthread return code) of the failure.
+ *
+ * \param resource
+ *      The resource limit that applies, RLIMIT_RTPRIO or RLIMIT_MEMLOCK.
+ */
+
+static void
+report_rt_failure
+(
+    const std::string & threadname,
+    const std::string & what,
+    int err,
+    int resource
+)
+{
+    std::string msg = threadname + " thread: couldn't set " + what + " (" +
+        std::strerror(err) + ").";
+
+    if (err == EPERM || err == ENOMEM)
+    {
+        bool rtprio = resource == RLIMIT_RTPRIO;
+        struct rlimit lim;
+        if (getrlimit(resource, &lim) == 0)
+        {
+            std::string limit = lim.rlim_cur == RLIM_INFINITY ?
+                std::string("unlimited") : std::to_string(lim.rlim_cur) ;
+
+            msg += rtprio ? " RLIMIT_RTPRIO is " : " RLIMIT_MEMLOCK is ";
+            msg += limit;
+            msg += ".";
+        }
+        msg += " Add the user to the 'audio' group, add the line '@audio - ";
+        msg += rtprio ? "rtprio 95" : "memlock unlimited" ;
+        msg += "' to /etc/security/limits.d/audio.conf, and log in again.";
+    }
+    errprint(msg);
+}
+
+#endif  // defined SEQ66_PLATFORM_LINUX
+
+/**
+ *  Sets the scheduling policy and priority of a thread.  The priority is
+ *  clamped to the range allowed by the policy (1 to 99 in Linux).  The
+ *  "normal" policy does nothing.  A failure is reported, but is not fatal;
+ *  the thread keeps running with the normal policy.
+ *
+ * \param t
+ *      The running thread to modify.
+ *
+ * \param threadname
+ *      The name of the thread, for messages.
+ *
+ * \param policy
+ *      The policy to set.
+ *
+ * \param priority
+ *      The real-time priority to set.
+ *
+ * \return
+ *      Returns true if the policy was set, or if there was nothing to do.
+ */
+
+bool
+set_thread_policy
+(
+    std::thread & t,
+    const std::string & threadname,
+    threadpolicy policy,
+    int priority
+)
+{
+    bool result = true;
+    if (policy == threadpolicy::normal)
+        return result;
+
+#if defined SEQ66_PLATFORM_LINUX
+    int pol = policy == threadpolicy::fifo ? SCHED_FIFO : SCHED_RR ;
+    int minprio = sched_get_priority_min(pol);
+    int maxprio = sched_get_priority_max(pol);
+    if (priority < minprio)
+        priority = minprio;
+    else if (priority > maxprio)
+        priority = maxprio;
+
+    struct sched_param schp;
+    std::memset(&schp, 0, sizeof(sched_param));
+    schp.sched_priority = priority;
+
+    std::string what = policy == threadpolicy::fifo ?
+        "SCHED_FIFO" : "SCHED_RR" ;
+
+    what += " priority ";
+    what += std::to_string(priority);
+
+    int rc = pthread_setschedparam(t.native_handle(), pol, &schp);
+    result = rc == 0;
+    if (result)
+    {
+        msgprintf
+        (
+            msg_level::info, "%s thread: %s",
+            threadname.c_str(), what.c_str()
+        );
+    }
+    else
+        report_rt_failure(threadname, what, rc, RLIMIT_RTPRIO);
+#else
+    (void) t;
+    (void) priority;
+    warnprintf("%s thread: real-time policy not supported", threadname.c_str());
+    result = false;
+#endif
+
+    return result;
+}
+
+/**
+ *  Restricts a thread to a set of CPUs.  Keeping the output thread on a CPU
+ *  that the GUI does not use, or on a CPU isolated with the "isolcpus"
+ *  kernel parameter, keeps it from being pre-empted by repaints.
+ *
+ * \param t
+ *      The running thread to modify.
+ *
+ * \param threadname
+ *      The name of the thread, for messages.
+ *
+ * \param cpulist
+ *      The list of CPUs, as parsed by parse_cpu_list().  If empty or "all",
+ *      nothing is done.
+ *
+ * \return
+ *      Returns true if the affinity was set, or if there was nothing to do.
+ */
+
+bool
+set_thread_affinity
+(
+    std::thread & t,
+    const std::string & threadname,
+    const std::string & cpulist
+)
+{
+    std::vector<int> cpus;
+    bool result = parse_cpu_list(cpulist, cpus);
+    if (! result)
+    {
+        msgprintf
+        (
+            msg_level::error, "%s thread: bad CPU list '%s'",
+            threadname.c_str(), cpulist.c_str()
+        );
+        return result;
+    }
+    if (cpus.empty())
+        return result;
+
+#if defined SEQ66_PLATFORM_LINUX
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (auto cpu : cpus)
+    {
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &cpuset);
+    }
+
+    int rc = pthread_setaffinity_np(t.native_handle(), sizeof cpuset, &cpuset);
+    result = rc == 0;
+    if (result)
+    {
+        msgprintf
+        (
+            msg_level::info, "%s thread: CPUs %s",
+            threadname.c_str(), cpulist.c_str()
+        );
+    }
+    else
+    {
+        msgprintf
+        (
+            msg_level::error, "%s thread: couldn't set CPUs %s (%s)",
+            threadname.c_str(), cpulist.c_str(), std::strerror(rc)
+        );
+    }
+#else
+    (void) t;
+    warnprintf("%s thread: CPU affinity not supported", threadname.c_str());
+    result = false;
+#endif
+
+    return result;
+}
+
+/**
+ *  Locks all current and future pages of the process into memory, so that
+ *  the real-time threads never wait on a page fault caused by a disk flush
+ *  or by memory pressure from other applications.
+ *
+ * \return
+ *      Returns true if the memory was locked.
+ */
+
+bool
+lock_memory ()
+{
+#if defined SEQ66_PLATFORM_LINUX
+    bool result = mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+    if (result)
+        infoprint("Process memory locked");
+    else
+        report_rt_failure("Main", "mlockall()", errno, RLIMIT_MEMLOCK);
+
+    return result;
+#else
+    warnprint("Memory locking not supported");
+    return false;
+#endif
+}
+
+}           // namespace seq66
+
+/*
+ * rtthread.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
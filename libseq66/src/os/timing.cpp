@@ -3,7 +3,7 @@
  * \library       seq66 application (from PSXC library)
  * \author        Chris Ahlstrom
  * \date          2005-07-03 to 2007-08-21 (pre-Sequencer24/64)
- * \updates       2020-07-06
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This program is free software; you can redistribute it and/or modify it
@@ -21,6 +21,7 @@
  *  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "app_limits.h"                 /* SEQ66_DEFAULT_WAKE_SPIN_US       */
 #include "seq66_platform_macros.h"      /* for detecting 32-bit builds      */
 #include "os/timing.hpp"                /* seq66::microsleep(), etc.        */
 
@@ -140,6 +141,35 @@ microsleep (int us)
     return result;
 }
 
+/**
+ *  Sleeps until the given absolute time, using clock_nanosleep(2) with the
+ *  TIMER_ABSTIME flag on the same clock as microtime().  Unlike a relative
+ *  sleep, being interrupted or pre-empted does not add to the sleep time.
+ *
+ * \param deadline_us
+ *      The absolute microtime() value at which to wake up.  If it has already
+ *      passed, the function returns immediately.
+ *
+ * \return
+ *      Returns true if the sleep completed.
+ */
+
+bool
+microsleep_until (long deadline_us)
+{
+    struct timespec ts;
+    ts.tv_sec = deadline_us / 1000000;
+    ts.tv_nsec = (deadline_us % 1000000) * 1000;
+
+    int rc;
+    do
+    {
+        rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+
+    } while (rc == EINTR);
+    return rc == 0;
+}
+
 /**
  *  Gets the current system time in microseconds.
  *
@@ -213,6 +243,24 @@ microsleep (int us)
     return result;
 }
 
+/**
+ *  Windows has no absolute sleep on a monotonic clock, so we convert the
+ *  deadline to a relative sleep.
+ *
+ * \param deadline_us
+ *      The absolute microtime() value at which to wake up.
+ *
+ * \return
+ *      Returns true if the sleep completed.
+ */
+
+bool
+microsleep_until (long deadline_us)
+{
+    long us = deadline_us - microtime();
+    return us > 0 ? microsleep(int(us)) : true ;
+}
+
 /**
  *  Gets the current system time in microseconds.  Currently, we use
  *  millitime() and multiply by 1000, in effect what Seq32 does.
@@ -274,6 +322,142 @@ millitime ()
 
 #endif      // SEQ66_PLATFORM_LINUX, SEQ66_PLATFORM_WINDOWS
 
+/**
+ *  Creates the timer.  Call start() before using it.
+ *
+ * \param period_us
+ *      The distance between grid points in microseconds.
+ */
+
+cycletimer::cycletimer (long period_us) :
+    m_period_us         (period_us),
+    m_next_us           (0),
+    m_anticipation_us   (0),
+    m_max_anticipation_us (SEQ66_DEFAULT_WAKE_SPIN_US),
+    m_lateness_us       (0),
+    m_max_lateness_us   (0),
+    m_total_lateness_us (0),
+    m_wakeups           (0),
+    m_overruns          (0)
+{
+    // Empty body
+}
+
+/**
+ *  Starts a new grid, and clears the lateness record.  The anticipation
+ *  value is kept, since it reflects the system more than the grid.
+ *
+ * \param period_us
+ *      The distance between grid points in microseconds.
+ *
+ * \param now
+ *      The origin of the grid, normally the current time.  The first grid
+ *      point is one period later.
+ */
+
+void
+cycletimer::start (long period_us, long now)
+{
+    m_period_us = period_us > 0 ? period_us : 1 ;
+    m_next_us = now + m_period_us;
+    m_lateness_us = m_max_lateness_us = m_total_lateness_us = 0;
+    m_wakeups = m_overruns = 0;
+}
+
+/**
+ *  Sets the longest anticipation, which is the longest time sleep_until()
+ *  spends yielding.  A wakeup latency larger than this indicates a system
+ *  that is not set up for real-time work, and we do not want to burn the
+ *  processor yielding to make up for it.
+ *
+ * \param us
+ *      The limit in microseconds.  0 disables the yielding; negative values
+ *      are treated as 0.
+ */
+
+void
+cycletimer::max_anticipation_us (long us)
+{
+    m_max_anticipation_us = us > 0 ? us : 0 ;
+    if (m_anticipation_us > m_max_anticipation_us)
+        m_anticipation_us = m_max_anticipation_us;
+}
+
+/**
+ *  Sleeps until the given absolute deadline.  The kernel sleep ends
+ *  m_anticipation_us early, and the rest is spent yielding, so that the
+ *  wakeup lands close to the deadline.  The lateness of the wakeup is then
+ *  recorded.  The anticipation moves a quarter of the way toward the latency
+ *  the kernel sleep just showed, which tracks the load of the system.
+ *
+ * \param deadline_us
+ *      The absolute microtime() value at which to wake up.
+ *
+ * \return
+ *      Returns false if the deadline had already passed, and no sleep was
+ *      done.
+ */
+
+bool
+cycletimer::sleep_until (long deadline_us)
+{
+    long now = microtime();
+    bool result = now < deadline_us;
+    if (result)
+    {
+        long early = deadline_us - m_anticipation_us;
+        if (early > now)
+        {
+            (void) microsleep_until(early);
+            now = microtime();
+
+            long overshoot = now - early;       /* kernel wakeup latency    */
+            m_anticipation_us += (overshoot - m_anticipation_us) / 4;
+            if (m_anticipation_us < 0)
+                m_anticipation_us = 0;
+            else if (m_anticipation_us > m_max_anticipation_us)
+                m_anticipation_us = m_max_anticipation_us;
+        }
+        while (now < deadline_us)
+        {
+            (void) microsleep(0);               /* sched_yield()            */
+            now = microtime();
+        }
+        m_lateness_us = now - deadline_us;
+        m_total_lateness_us += m_lateness_us;
+        if (m_lateness_us > m_max_lateness_us)
+            m_max_lateness_us = m_lateness_us;
+
+        ++m_wakeups;
+    }
+    return result;
+}
+
+/**
+ *  Moves to the next grid point.  If the caller fell behind by more than a
+ *  period, the missed grid points are counted as overruns and skipped, so
+ *  that the grid keeps its phase instead of slipping.
+ *
+ * \param now
+ *      The current time, normally the default.
+ *
+ * \return
+ *      Returns the new grid point.
+ */
+
+long
+cycletimer::advance (long now)
+{
+    m_next_us += m_period_us;
+    if (m_next_us <= now)
+    {
+        long missed = (now - m_next_us) / m_period_us + 1;
+        m_overruns += missed;
+        m_next_us += missed * m_period_us;
+    }
+    return m_next_us;
+}
+
 }           // namespace seq66
 
 /*
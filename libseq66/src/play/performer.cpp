@@ -24,7 +24,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom and others
  * \date          2018-11-12
- * \updates       2020-10-05
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  Also read the comments in the Sequencer64 version of this module,
@@ -291,8 +291,9 @@
  */
 
 #include <algorithm>                    /* std::find() for std::vector      */
+#include <chrono>                       /* std::chrono::steady_clock        */
 #include <iostream>                     /* std::cout                        */
-#include <cmath>                        /* std::round()                     */
+#include <cmath>                        /* std::round(), std::ceil()        */
 #include <cstring>                      /* std::memset()                    */
 
 #include "cfg/cmdlineopts.hpp"          /* cmdlineopts::parse_mute_groups   */
@@ -303,6 +304,7 @@
 #include "midi/midifile.hpp"            /* seq66::read_midi_file()          */
 #include "play/notemapper.hpp"          /* seq66::notemapper                */
 #include "play/performer.hpp"           /* seq66::performer, this class     */
+#include "os/rtthread.hpp"              /* seq66::set_thread_policy(), etc. */
 #include "os/timing.hpp"                /* seq66::microsleep(), microtime() */
 #include "util/strfunctions.hpp"        /* seq66::shorten_file_spec()       */
 
@@ -319,6 +321,18 @@ namespace seq66
 
 static int c_thread_trigger_width_us = SEQ66_DEFAULT_TRIGWIDTH_MS;
 
+/**
+ *  Gets the nanoseconds elapsed since the given time, for the playback
+ *  statistics.
+ */
+
+static long
+elapsed_ns (std::chrono::steady_clock::time_point since)
+{
+    auto d = std::chrono::steady_clock::now() - since;
+    return long(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+}
+
 /**
  *  This constructor...
  *
@@ -333,6 +347,18 @@ static int c_thread_trigger_width_us = SEQ66_DEFAULT_TRIGWIDTH_MS;
 performer::performer (int ppqn, int rows, int columns) :
     m_error_pending         (false),
     m_play_set              (),
+    m_play_snapshot         (),
+    m_tempo_map             (),
+    m_tempo_map_active      (false),
+    m_play_stats            (),
+    m_cycle_counts          (),
+    m_engine_active         (false),
+    m_engine_play           (false),
+    m_engine_busy           (false),
+    m_engine_tick           (0.0),
+    m_engine_clock          (0.0),
+    m_engine_frames         (0),
+    m_engine_pending        (0),
     m_play_list             (),
     m_note_mapper           (new notemapper()),
     m_song_start_mode       (sequence::playback::live),
@@ -392,6 +418,7 @@ performer::performer (int ppqn, int rows, int columns) :
     m_right_tick            (0),
     m_starting_tick         (0),
     m_tick                  (0),
+    m_tick_us               (0),
     m_jack_tick             (0),
     m_usemidiclock          (false),            /* MIDI Clock support       */
     m_midiclockrunning      (false),
@@ -423,6 +450,7 @@ performer::performer (int ppqn, int rows, int columns) :
      */
 
     (void) populate_default_ops();
+    m_cycle_counts.reserve(size_t(c_busscount_max));
 }
 
 /**
@@ -435,6 +463,13 @@ performer::performer (int ppqn, int rows, int columns) :
 
 performer::~performer ()
 {
+    if (m_engine_active)
+    {
+        (void) m_master_bus->engine(nullptr, nullptr);
+        m_engine_play = false;
+        while (m_engine_busy)
+            std::this_thread::yield();
+    }
     m_io_active = m_is_running = false;
     reset_sequences();                      /* stop all output upon exit    */
     announce_exit();
@@ -444,6 +479,40 @@ performer::~performer ()
 
     if (m_in_thread_launched && m_in_thread.joinable())
         m_in_thread.join();
+
+    /*
+     *  The playback statistics are dumped to the "-o stats" file, if given,
+     *  or else to the console in verbose mode.
+     */
+
+    bool dump = ! usr().option_stats().empty();
+    if (! dump)
+        dump = rc().verbose() && m_play_stats.cycles() > 0;
+
+    if (dump)
+        (void) report_play_stats();
+}
+
+/**
+ *  Writes the playback statistics to the file given by the "-o stats"
+ *  option, or, if there is none, to the console.  Called at exit, and upon
+ *  a SIGUSR2 signal.
+ *
+ * \return
+ *      Returns false if the file could not be written.
+ */
+
+bool
+performer::report_play_stats () const
+{
+    const std::string & statsfile = usr().option_stats();
+    bool result = true;
+    if (statsfile.empty())
+        std::cout << m_play_stats.report() << std::flush;
+    else
+        result = m_play_stats.write(statsfile);
+
+    return result;
 }
 
 /**
@@ -521,7 +590,10 @@ performer::notify_sequence_change (seq::number seqno, change mod)
 
     seq::pointer s = get_sequence(seqno);
     if (mod == change::yes || redo)
+    {
+        build_tempo_map();
         modify();
+    }
 }
 
 /**
@@ -547,7 +619,10 @@ performer::notify_trigger_change (seq::number seqno, change mod)
         (void) notify->on_trigger_change(seqno);
 
     if (mod == change::yes)
+    {
+        build_tempo_map();
         modify();
+    }
     else if (mod == change::no)
     {
         const seq::pointer s = get_sequence(seqno);
@@ -699,7 +774,7 @@ performer::reload_mute_groups (std::string & errmessage)
  *  set_input() function passes the setting along to the input busarray.
  *
  * \param bus
- *      Provides the buss number, less than c_busscount_max (32).
+ *      Provides the buss number, less than c_busscount_max (64).
  *
  * \param active
  *      Indicates whether the buss or the user-interface feature is active or
@@ -709,7 +784,7 @@ performer::reload_mute_groups (std::string & errmessage)
 void
 performer::set_input_bus (bussbyte bus, bool active)
 {
-    if (bus < c_busscount_max)                          /* 32 busses max    */
+    if (bus < c_busscount_max)                          /* 64 busses max    */
     {
         if (m_master_bus->set_input(bus, active))
         {
@@ -735,7 +810,7 @@ performer::set_input_bus (bussbyte bus, bool active)
 void
 performer::set_clock_bus (bussbyte bus, e_clock clocktype)
 {
-    if (bus < c_busscount_max)                          /* 32 busses max    */
+    if (bus < c_busscount_max)                          /* 64 busses max    */
     {
         if (m_master_bus->set_clock(bus, clocktype))    /* checks bus index */
         {
@@ -989,7 +1064,7 @@ performer::install_sequence (sequence * s, seq::number seqno, bool fileload)
         if (! fileload)
             modify();
 
-        mapper().fill_play_set(m_play_set);
+        fill_play_set();
 
 #if defined USE_MIDI_CONTROL_OUT_ACTIVE                // not present
         midi_control_out().send_seq_event
@@ -1059,7 +1134,10 @@ performer::remove_sequence (seq::number seqno)
 {
     bool result = mapper().remove_sequence(seqno);
     if (result)
+    {
+        fill_play_set();                /* the output thread lets go of it  */
         modify();
+    }
 
     midi_control_out().send_seq_event(seqno, midicontrolout::seqaction::remove);
     return result;
@@ -1256,7 +1334,7 @@ performer::change_ppqn (int p)
 bool
 performer::change_all_busses (int b)
 {
-    bool result = b >= 0 && b <= SEQ66_OUTPUT_BUSS_MAX;
+    bool result = b >= 0 && b < c_busscount_max;
     if (result)
     {
         for (auto seqi : m_play_set)
@@ -1636,18 +1714,29 @@ performer::log_current_tempo ()
 
 /**
  *  Also calls mapper().set_playscreen(), and notifies any performer::callbacks
- *  subscribers.
+ *  subscribers.  The patterns of the old play-set are no longer played, so
+ *  the notes they left sounding are turned off before the new play-set is
+ *  filled.
  */
 
 screenset::number
 performer::set_playing_screenset (screenset::number setno)
 {
+    screenset::number oldsetno = mapper().playscreen_number();
     if (mapper().set_playing_screenset(setno))
     {
+        if (mapper().playscreen_number() != oldsetno)
+        {
+            for (auto & seqi : m_play_set)
+                seqi.get()->off_playing_notes();
+
+            if (m_master_bus)
+                m_master_bus->all_notes_off();      /* patterns cut short   */
+        }
         announce_exit(false);                       /* blank the device     */
         announce_playscreen();                      /* inform control-out   */
         unset_queued_replace();
-        mapper().fill_play_set(m_play_set);
+        fill_play_set();
         notify_set_change(setno, change::no);
     }
     return mapper().playscreen_number();
@@ -1753,6 +1842,7 @@ performer::clear_song ()
         set_have_redo(false);
         m_redo_vect.clear();
         mapper().reset();               /* clears and recreates empty set   */
+        fill_play_set();
         unmodify();                     /* new, we start afresh             */
         m_is_busy = false;
         set_needs_update();             /* tell all GUIs to refresh. BUG!   */
@@ -1765,8 +1855,9 @@ performer::clear_song ()
  *  For all active patterns/sequences, get its playing state, turn off the
  *  playing notes, set playing to false, zero the markers, and, if not in
  *  playback mode, restore the playing state.  Note that these calls are
- *  folded into one member function of the sequence class.  Finally, flush the
- *  master MIDI buss.
+ *  folded into one member function of the sequence class.  Finally, the
+ *  master MIDI buss turns off any note still sounding (for example, one
+ *  left by a pattern cut in the middle of a note), and flushes.
  *
  *  Could use a member function pointer to avoid having to code two loops.
  *  We did it.  Note that std::shared_ptr does not support operator::->*, so
@@ -1791,7 +1882,7 @@ performer::reset_sequences (bool pause)
         (seqi.get()->*f)(songmode);
 
     if (m_master_bus)
-        m_master_bus->flush();                          /* flush MIDI buss  */
+        m_master_bus->all_notes_off();                  /* and flush buss   */
 }
 
 /**
@@ -1872,6 +1963,10 @@ performer::set_song_mute (mutegroups::muting op)
  *  output port.  So how do we get the port-settings from the OS?  Probably
  *  at initialization time.  See the mastermidibus constructor for PortMidi.
  *
+ *  This function is public so that offline code, such as the Seqtool
+ *  playback benchmark, can create the buss without calling launch(), which
+ *  would start the I/O threads.
+ *
  * \return
  *      Returns true if the creation succeeded, or if the buss already exists.
  */
@@ -1931,6 +2026,12 @@ performer::launch (int ppqn)
         bool ok = activate();
         if (ok)
         {
+            if (rc().jack_engine())
+            {
+                m_engine_active = m_master_bus->engine(engine_callback, this);
+                if (! m_engine_active)
+                    warnprint("JACK engine unavailable, using output thread");
+            }
             launch_input_thread();
             launch_output_thread();
             (void) set_playing_screenset(0);    // ca 2020-08-11
@@ -2117,38 +2218,16 @@ performer::launch_output_thread ()
         unsigned num_cpus = std::thread::hardware_concurrency();
         infoprintf("%u CPUs detected", num_cpus);
     }
+    if (rc().lock_memory())
+        (void) lock_memory();
+
     m_out_thread = std::thread(&performer::output_func, this);
     m_out_thread_launched = true;
-    if (rc().priority())                        /* Not in MinGW RCB     */
-    {
-        struct sched_param schp;
-        memset(&schp, 0, sizeof(sched_param));
-        schp.sched_priority = 1;                /* Linux range: 1 to 99 */
-#if defined SEQ66_PLATFORM_PTHREADS
-        int rc = pthread_setschedparam
-        (
-            m_out_thread.native_handle(), SCHED_FIFO, &schp
-        );
-#else
-        int rc = sched_setscheduler
-        (
-            m_out_thread.native_handle(), SCHED_FIFO, &schp
-        );
-#endif
-        if (rc != 0)
-        {
-            errprint
-            (
-                "output_thread: couldn't set scheduler to FIFO, "
-                "need root priviledges."
-            );
-            pthread_exit(0);
-        }
-        else
-        {
-            infoprint("Output priority set to 1");
-        }
-    }
+    set_thread_scheduling
+    (
+        m_out_thread, "Output", rc().output_thread_policy(),
+        rc().output_thread_priority(), rc().output_thread_cpus()
+    );
 }
 
 /**
@@ -2161,36 +2240,38 @@ performer::launch_input_thread ()
 {
     m_in_thread = std::thread(&performer::input_func, this);
     m_in_thread_launched = true;
-    if (rc().priority())                        /* Not in MinGW RCB     */
+    set_thread_scheduling
+    (
+        m_in_thread, "Input", rc().input_thread_policy(),
+        rc().input_thread_priority(), rc().input_thread_cpus()
+    );
+}
+
+/**
+ *  Applies the [thread-scheduling] settings to a newly-launched thread.  The
+ *  legacy --priority option promotes a "normal" thread to SCHED_FIFO at
+ *  priority 1, as before.  A failure to raise the priority is reported, along
+ *  with the limit to change, but the thread keeps running normally.
+ */
+
+void
+performer::set_thread_scheduling
+(
+    std::thread & t,
+    const std::string & threadname,
+    const std::string & policyname,
+    int priority,
+    const std::string & cpus
+)
+{
+    threadpolicy policy = string_to_threadpolicy(policyname);
+    if (policy == threadpolicy::normal && rc().priority())  /* --priority   */
     {
-        struct sched_param schp;
-        memset(&schp, 0, sizeof(sched_param));
-        schp.sched_priority = 1;                /* Linux range: 1 to 99 */
-#if defined SEQ66_PLATFORM_PTHREADS
-        int rc = pthread_setschedparam
-        (
-            m_in_thread.native_handle(), SCHED_FIFO, &schp
-        );
-#else
-        int rc = sched_setscheduler
-        (
-            m_in_thread.native_handle(), SCHED_FIFO, &schp
-        );
-#endif
-        if (rc != 0)
-        {
-            errprint
-            (
-                "output_thread: couldn't set scheduler to FIFO, "
-                "need root priviledges."
-            );
-            pthread_exit(0);
-        }
-        else
-        {
-            infoprint("Input priority set to 1");
-        }
+        policy = threadpolicy::fifo;
+        priority = 1;
     }
+    (void) set_thread_policy(t, threadname, policy, priority);
+    (void) set_thread_affinity(t, threadname, cpus);
 }
 
 /**
@@ -2672,7 +2753,22 @@ performer::deinit_jack_transport ()
 void
 performer::position_jack (bool songmode, midipulse tick)
 {
-    m_jack_asst.position(songmode, tick);
+    position_jack(songmode, tick, tempo_map_active() ? &m_tempo_map : nullptr);
+}
+
+/**
+ *  The same, for the output thread, which must use the tempo map published
+ *  with the play-set snapshot it holds, rather than m_tempo_map.
+ *
+ * \param tmap
+ *      The tempo map to locate the pulse with, or null if Song mode does
+ *      not use one.
+ */
+
+void
+performer::position_jack (bool songmode, midipulse tick, const tempomap * tmap)
+{
+    m_jack_asst.position(songmode, tick, tmap);
 }
 #else
 void
@@ -2680,6 +2776,15 @@ performer::position_jack (bool /*songmode*/, midipulse /*tick*/)
 {
     // No code
 }
+
+void
+performer::position_jack
+(
+    bool /*songmode*/, midipulse /*tick*/, const tempomap * /*tmap*/
+)
+{
+    // No code
+}
 #endif
 
 /**
@@ -2772,6 +2877,7 @@ performer::output_func ()
         pad.js_ticks_converted = 0.0;
         pad.js_ticks_delta = 0.0;
         pad.js_delta_tick_frac = 0L;        /* seq24 0.9.3; long value      */
+        pad.js_tempo_map = nullptr;         /* set for each cycle           */
 
         /*
          *  See note 1 in the function banner.
@@ -2787,14 +2893,66 @@ performer::output_func ()
             set_orig_ticks(m_starting_tick);
         }
 
+        /*
+         *  The lookahead scheduler.  Events are rendered up to lookahead_us
+         *  past the current time and queued in the master buss, which sends
+         *  each one at its deadline.  We re-render every half-window.  The
+         *  scheduler is not used when slaved to incoming MIDI clock, since
+         *  then we cannot predict the time of future pulses.
+         */
+
+        long lookahead_us = long(rc().lookahead_ms()) * 1000;
+        long cycle_us = lookahead_us / 2;
+        if (cycle_us < 1000)
+            cycle_us = 1000;
+
+        m_master_bus->lookahead_us(lookahead_us);
+
+        /*
+         *  With the ALSA queue option, or a PortMidi latency, each event is
+         *  handed to the MIDI API up to one cycle before its deadline,
+         *  stamped with that deadline, so that the sleep jitter of this
+         *  thread does not reach the output.  The API checks its option.
+         */
+
+        bool timed = lookahead_us > 0 && ! m_engine_active;
+        (void) m_master_bus->deliver_ahead(timed ? cycle_us : 0);
+        if (m_engine_active)
+            engine_run(pad.js_current_tick);    /* returns at stop          */
+
         int ppqn = m_master_bus->get_ppqn();
         last = microtime();                     /* depends on OS            */
+
+        /*
+         *  The output cycles follow a fixed grid of absolute deadlines, so
+         *  that sleeping late in one cycle does not delay the next ones.
+         */
+
+        cycletimer timer;
+        timer.max_anticipation_us(rc().wake_spin_us());
+        timer.start(cycle_us, last);
+
+        /*
+         *  In Song mode with tempo changes, the pulses are advanced along the
+         *  tempo map instead of at the current tempo.  The fraction of a
+         *  pulse left over is carried to the next cycle.  The map is the
+         *  one published with the play-set snapshot, held for the whole
+         *  cycle, so an edit made while playing takes effect at the next
+         *  cycle without a lock.
+         */
+
+        double map_frac = 0.0;
+        m_master_bus->batch_output(true);       /* see end_cycle() below    */
         while (is_running())
         {
             /**
              *  See note 2 in the function banner.
              */
 
+            const playsnapshot::snapshot & ps = m_play_snapshot.acquire();
+            const tempomap * tmap = published_tempo_map(ps);
+            bool usemap = not_nullptr(tmap);
+            pad.js_tempo_map = tmap;
             current = microtime();
             delta = current - last;
             long delta_us = delta;
@@ -2809,6 +2967,16 @@ performer::output_func ()
 
             long delta_tick = long(delta_tick_num / 60000000LL);
             pad.js_delta_tick_frac = long(delta_tick_num % 60000000LL);
+            if (usemap)
+            {
+                double start = pad.js_current_tick + map_frac;
+                double dt = tmap->advance(start, delta_us) -
+                    pad.js_current_tick;
+
+                delta_tick = long(dt);
+                map_frac = dt - double(delta_tick);
+                bpm = tmap->bpm_at(pad.js_current_tick + dt);
+            }
             if (m_usemidiclock)
             {
                 delta_tick = m_midiclocktick;       /* int to double */
@@ -2920,7 +3088,7 @@ performer::output_func ()
                     {
                         if (is_jack_master() && ! jack_position_once)
                         {
-                            position_jack(true, m_left_tick);
+                            position_jack(true, m_left_tick, tmap);
                             jack_position_once = true;
                         }
                         double leftover_tick = pad.js_current_tick - rtick;
@@ -2954,6 +3122,45 @@ performer::output_func ()
                  * FF or RW.
                  */
 
+                /*
+                 * With the lookahead scheduler, the patterns are rendered
+                 * past the current tick, but never past the right marker
+                 * when looping, since the wrap-around above handles that.
+                 */
+
+                midipulse rendertick = c_null_midipulse;
+                if (m_master_bus->scheduling() && ! m_usemidiclock)
+                {
+                    midipulse curtick = midipulse(pad.js_current_tick);
+                    if (usemap)
+                    {
+                        m_master_bus->schedule_origin
+                        (
+                            pad.js_current_tick, current, bpm
+                        );
+                        rendertick = midipulse
+                        (
+                            tmap->advance(curtick, lookahead_us)
+                        );
+                    }
+                    else
+                    {
+                        m_master_bus->schedule_origin
+                        (
+                            pad.js_current_tick, current
+                        );
+                        rendertick = curtick + midipulse
+                        (
+                            delta_time_us_to_ticks(lookahead_us, bpm, ppqn)
+                        );
+                    }
+                    if (perfloop)
+                    {
+                        midipulse rtick = get_right_tick();
+                        if (rendertick >= rtick)
+                            rendertick = rtick - 1;
+                    }
+                }
                 if (is_jack_running())
                 {
 #if defined SEQ66_JACK_SUPPORT
@@ -2961,14 +3168,18 @@ performer::output_func ()
                     {
 #endif
                         midipulse jackrtick = pad.js_current_tick;
-                        play(midipulse(jackrtick));
+                        auto before = std::chrono::steady_clock::now();
+                        play(midipulse(jackrtick), rendertick);
+                        m_play_stats.play_duration(elapsed_ns(before));
 #if defined SEQ66_JACK_SUPPORT
                     }
 #endif
                 }
                 else
                 {
-                    play (midipulse(pad.js_current_tick));
+                    auto before = std::chrono::steady_clock::now();
+                    play(midipulse(pad.js_current_tick), rendertick);
+                    m_play_stats.play_duration(elapsed_ns(before));
                 }
 
                 /*
@@ -2977,8 +3188,27 @@ performer::output_func ()
                  */
 
                 set_jack_tick(pad.js_current_tick);
-                m_master_bus->emit_clock(midipulse(pad.js_clock_tick));
+
+                /*
+                 * The MIDI clock is queued as far ahead as the patterns, at
+                 * the same offset from the current pulse.
+                 */
+
+                midipulse clockhorizon = c_null_midipulse;
+                if (rendertick != c_null_midipulse)
+                {
+                    midipulse ahead = rendertick -
+                        midipulse(pad.js_current_tick);
+
+                    if (ahead > 0)
+                        clockhorizon = midipulse(pad.js_clock_tick) + ahead;
+                }
+                m_master_bus->emit_clock(pad.js_clock_tick, clockhorizon);
+                m_tick_us = current;            /* when m_tick was current  */
             }
+            m_master_bus->end_cycle();          /* one drain for the cycle  */
+            pad.js_tempo_map = nullptr;
+            m_play_snapshot.release();
 
             /**
              *  Figure out how much time we need to sleep, and do it.
@@ -3006,15 +3236,72 @@ performer::output_func ()
             double next_clock_delta_us =
                 next_clock_delta * pulse_length_us(bpm, m_ppqn);
 
-            if (next_clock_delta_us < (c_thread_trigger_width_us * 2.0))
+            bool clockwake =
+                next_clock_delta_us < (c_thread_trigger_width_us * 2.0);
+
+            if (clockwake)
                 delta_us = long(next_clock_delta_us);
 
-            if (delta_us > 0)
-                (void) microsleep(delta_us);            /* timing.hpp       */
+            if (m_master_bus->scheduling())
+            {
+                /*
+                 * Send the queued events as their deadlines arrive, until it
+                 * is time to render the next cycle.
+                 */
+
+                long wake = timer.next_us();
+                for (;;)
+                {
+                    long now = microtime();
+                    long next = m_master_bus->dispatch(now);
+                    if (now >= wake)
+                        break;
+
+                    if (next == 0 || next > wake)
+                        next = wake;
 
+                    if (timer.sleep_until(next))        /* absolute time    */
+                        m_play_stats.wake_lateness(timer.lateness_us());
+                }
+                (void) timer.advance();
+            }
+            else
+            {
+                /*
+                 * Wake at the next grid point, so that lateness does not
+                 * build up from cycle to cycle.  At very fast tempos the
+                 * MIDI clock needs an earlier wakeup; it is taken off the
+                 * grid, which then stays where it is.
+                 */
+
+                long wake = timer.next_us();
+                bool early = clockwake && delta_us < wake - current;
+                if (early)
+                    wake = current + delta_us;
+
+                if (timer.sleep_until(wake))            /* absolute time    */
+                    m_play_stats.wake_lateness(timer.lateness_us());
+
+                if (! early)
+                    (void) timer.advance();
+            }
+
+            int scheduled = m_master_bus->cycle_counts(m_cycle_counts);
+            m_play_stats.cycle(m_cycle_counts, scheduled);
             if (pad.js_jack_stopped)
                 inner_stop();
         }
+        if (rc().verbose() && timer.wakeups() > 0)
+        {
+            msgprintf
+            (
+                msg_level::info,
+                "Output wakeups: %ld, lateness avg %ld us, max %ld us, "
+                "missed cycles %ld",
+                timer.wakeups(), timer.average_lateness_us(),
+                timer.max_lateness_us(), timer.overruns()
+            );
+        }
 
         /*
          * Disabling this setting allows all of the progress bars (seqroll,
@@ -3024,16 +3311,19 @@ performer::output_func ()
          * play tick that displays the progress bar.
          */
 
+        const playsnapshot::snapshot & ps = m_play_snapshot.acquire();
+        const tempomap * tmap = published_tempo_map(ps);
         if (song_mode())
         {
             if (is_jack_master())                       // running Song Master
-                position_jack(song_mode(), m_left_tick);
+                position_jack(song_mode(), m_left_tick, tmap);
         }
         else
         {
             if (is_jack_master())                       // running Live Master
-                position_jack(song_mode(), 0);
+                position_jack(song_mode(), 0, tmap);
         }
+        m_play_snapshot.release();
         if (! m_usemidiclock)                           // stop by MIDI event?
         {
             if (! is_jack_running())
@@ -3047,14 +3337,216 @@ performer::output_func ()
 
         /*
          * This means we leave m_tick at stopped location if in slave mode or
-         * if m_usemidiclock == true.
+         * if m_usemidiclock == true.  Pending Note Offs from the lookahead
+         * window are sent now; pending Note Ons are dropped.
          */
 
+        m_tick_us = 0;
+        m_master_bus->batch_output(false);
+        m_master_bus->flush_scheduled();
         m_master_bus->flush();
         m_master_bus->stop();
     }
 }
 
+/**
+ *  How often the output thread checks for the end of playback in engine
+ *  mode.  The lookahead scheduler is also given this window, if it is not
+ *  already active; the window does not matter in engine mode, where the
+ *  rendering runs one period at a time.
+ */
+
+static const int c_engine_poll_us = 10000;
+
+/**
+ *  The playback loop of the output thread in engine mode (see launch()).
+ *  The JACK process callback does the work, in engine_cycle(), so this
+ *  function just starts the engine at the given pulse and waits until
+ *  playback stops.  Then it makes sure that the last cycle is finished
+ *  before output_func() flushes the busses.
+ *
+ *  The events are still rendered through the lookahead scheduler of the
+ *  master buss, which holds those that fall into the next period, so it
+ *  must be active.  Its time base is the frame count of the engine.
+ *
+ * \param tick
+ *      The pulse at which to start playback.
+ */
+
+void
+performer::engine_run (double tick)
+{
+    if (! m_master_bus->scheduling())
+        m_master_bus->lookahead_us(c_engine_poll_us);
+
+    m_master_bus->schedule_fixed(true);         /* no growth in JACK thread */
+    m_engine_tick = m_engine_clock = tick;
+    m_engine_frames = m_engine_pending = 0;
+    m_master_bus->init_clock(midipulse(tick));
+    m_engine_play = true;
+    while (is_running())
+        (void) microsleep(c_engine_poll_us);
+
+    m_engine_play = false;
+    while (m_engine_busy)
+        std::this_thread::yield();
+
+    m_master_bus->schedule_fixed(false);
+}
+
+/**
+ *  The engine function given to the master buss; see engine_cycle().
+ */
+
+void
+performer::engine_callback (void * arg, unsigned nframes, unsigned rate)
+{
+    performer * self = reinterpret_cast<performer *>(arg);
+    if (not_nullptr(self))
+        self->engine_cycle(nframes, rate);
+}
+
+/**
+ *  Advances playback by exactly one JACK period.  Called at the start of
+ *  each JACK process callback, before the output ports are serviced, so
+ *  that the events due in the period are written to the port buffers at
+ *  their frame offsets in the same callback.  The pulse position is derived
+ *  from the frame count, not from the system clock, so it cannot drift from
+ *  the audio, and the output latency is one period.
+ *
+ *  As in output_func(), the tempo map paces Song mode, and the song wraps
+ *  to the left marker when looping.  MIDI clock slave mode and JACK
+ *  transport are not supported in this mode.
+ *
+ *  This function runs in the JACK real-time thread, so it does not wait
+ *  for a lock:
+ *
+ *      -   The master buss is tried once (see mastermidibase ::
+ *          engine_begin()) and held for the whole period.  If another
+ *          thread holds it, such as the user-interface, MIDI thru, or a
+ *          SysEx send, nothing is rendered; the period is rendered with the
+ *          next one, and its events go out at the start of that period,
+ *          one period late.
+ *      -   A pattern whose mutex is held, for example by an edit that
+ *          rebuilds its playback events, is skipped, and plays the skipped
+ *          events in the next period (see sequence::play_queue()).
+ *      -   The scheduler does not grow past its reserved size; events that
+ *          do not fit are dropped.
+ *
+ *  Each of these is counted in the playback statistics.  Some costs remain:
+ *  a pattern whose playback events are stale (only after append_event())
+ *  rebuilds them here, which allocates, and the MIDI API sends the events
+ *  with its own locking, if any.
+ *
+ * \param nframes
+ *      The length of the period in frames.
+ *
+ * \param rate
+ *      The frame rate of the JACK server.
+ */
+
+void
+performer::engine_cycle (unsigned nframes, unsigned rate)
+{
+    m_engine_busy = true;
+    if (m_engine_play && rate > 0)
+    {
+        m_engine_pending += nframes;
+        if (m_master_bus->engine_begin())
+        {
+            engine_render(nframes, rate);
+            m_master_bus->engine_end();
+        }
+        else
+            m_play_stats.deferred_period();
+    }
+    m_engine_busy = false;
+}
+
+/**
+ *  Renders the frames not yet rendered, the current period plus any that
+ *  were deferred, and sends the events due in the current period.  Called
+ *  only by engine_cycle(), which holds the master buss.
+ *
+ * \param nframes
+ *      The length of the current period in frames.
+ *
+ * \param rate
+ *      The frame rate of the JACK server.
+ */
+
+void
+performer::engine_render (unsigned nframes, unsigned rate)
+{
+    auto before = std::chrono::steady_clock::now();
+    double framesperus = double(rate) / 1000000.0;
+    long long frames = m_engine_pending;
+    long startus = long(double(m_engine_frames) / framesperus);
+    m_engine_frames += frames;
+    m_engine_pending = 0;
+
+    long periodus = long(double(m_engine_frames - nframes) / framesperus);
+    long endus = long(double(m_engine_frames) / framesperus);
+    int ppqn = m_master_bus->get_ppqn();
+    midibpm bpm = m_master_bus->get_beats_per_minute();
+    double tick0 = m_engine_tick;
+    double tick1;
+    const playsnapshot::snapshot & ps = m_play_snapshot.acquire();
+    const tempomap * tmap = published_tempo_map(ps);
+    if (not_nullptr(tmap))
+    {
+        bpm = tmap->bpm_at(tick0);
+        tick1 = tmap->advance(tick0, endus - startus);
+    }
+    else
+        tick1 = tick0 + double(frames) * bpm * ppqn / (60.0 * rate);
+
+    double clock0 = m_engine_clock;
+    m_engine_clock += tick1 - tick0;
+    m_master_bus->schedule_origin(tick0, startus, bpm);
+    m_master_bus->emit_clock                    /* clocks of this period    */
+    (
+        clock0, midipulse(std::ceil(m_engine_clock)) - 1
+    );
+
+    bool perfloop = m_looping;
+    if (perfloop)
+        perfloop = song_mode() || start_from_perfedit();
+
+    midipulse rtick = get_right_tick();
+    if (perfloop && tick1 >= double(rtick))
+    {
+        /*
+         * Render the end of the loop, then restart the pulses at the
+         * left marker from the frame at which the right marker falls.
+         */
+
+        double fraction = tick1 > tick0 ?
+            (double(rtick) - tick0) / (tick1 - tick0) : 0.0 ;
+
+        if (fraction < 0.0)
+            fraction = 0.0;
+
+        long wrapus = startus + long(fraction * double(endus - startus));
+        midipulse ltick = get_left_tick();
+        play(midipulse(tick0), rtick - 1, true);
+        set_orig_ticks(ltick);
+        tick1 = double(ltick) + (tick1 - double(rtick));
+        tick0 = double(ltick);
+        m_master_bus->schedule_origin(tick0, wrapus, bpm);
+    }
+    play(midipulse(tick0), midipulse(std::ceil(tick1)) - 1, true);
+    m_play_snapshot.release();
+    m_engine_tick = m_current_tick = tick1;
+    set_jack_tick(midipulse(tick1));
+    m_master_bus->engine_dispatch(periodus, endus, framesperus);
+    m_play_stats.play_duration(elapsed_ns(before));
+
+    int scheduled = m_master_bus->cycle_counts(m_cycle_counts);
+    m_play_stats.cycle(m_cycle_counts, scheduled);
+    m_play_stats.dropped_events(m_master_bus->dropped_events());
+}
+
 /**
  *  This function is called by input_thread_func().  It handles certain MIDI
  *  input events.
@@ -3193,6 +3685,33 @@ performer::input_func ()
     }
 }
 
+/**
+ *  Gets the pulse at which to record the input event just read.  If the MIDI
+ *  API stamped the event with its arrival time, the pulse is calculated from
+ *  the time elapsed between the last output cycle and the arrival, so that
+ *  the delay of the input thread does not shift the event.  Otherwise, the
+ *  current tick is used, as before.
+ *
+ * \return
+ *      Returns the pulse of the event.
+ */
+
+midipulse
+performer::input_tick ()
+{
+    long origin = m_tick_us;
+    midipulse result = get_tick();
+    long us = m_master_bus->input_time_us();
+    if (origin > 0 && us > 0)
+    {
+        double pulses = double(us - origin) * m_bpm * m_ppqn / 60000000.0;
+        result += midipulse(pulses);
+        if (result < 0)
+            result = 0;
+    }
+    return result;
+}
+
 /**
  *  A helper function for input_func().
  */
@@ -3221,7 +3740,7 @@ performer::poll_cycle ()
                         }
                         else
                         {
-                            ev.set_timestamp(get_tick());
+                            ev.set_timestamp(input_tick());
 #if defined SEQ66_PLATFORM_DEBUG
                             if (rc().verbose())
                                 ev.print_note();
@@ -3373,6 +3892,7 @@ performer::start_playing (bool songmode)
     songmode = songmode || song_mode();
     if (songmode)
     {
+        build_tempo_map();
        /*
         * Allow to start at key-p position if set; for cosmetic reasons,
         * to stop transport line flicker on start, position to the left
@@ -3541,23 +4061,225 @@ performer::auto_stop ()
  * \param tick
  *      Provides the tick at which to start playing.  This value is also
  *      copied to m_tick.
+ *
+ * \param rendertick
+ *      If not c_null_midipulse, the patterns are played up to this tick,
+ *      which is a lookahead window past \a tick.  The events are then held
+ *      by the master buss until their deadlines.  The progress tick, m_tick,
+ *      is still set to \a tick, so that recording and the user-interface
+ *      follow the audible position.
+ *
+ * \param nowait
+ *      If true, a pattern that is locked by another thread is skipped, and
+ *      plays its events in the next call.  Used in engine mode; see
+ *      engine_cycle().
  */
 
 void
-performer::play (midipulse tick)
+performer::play (midipulse tick, midipulse rendertick, bool nowait)
 {
     set_tick(tick);
+    if (is_null_midipulse(rendertick) || rendertick < tick)
+        rendertick = tick;
+
     bool songmode = song_mode();
-    for (auto seqi : m_play_set)
-        seqi->play_queue(tick, songmode, resume_note_ons());
+    bool resume = resume_note_ons();
+    int skipped = 0;
+    const playsnapshot::snapshot & ps = m_play_snapshot.acquire();
+    for (auto seqi : ps.sequences())
+    {
+        if (! seqi->play_queue(rendertick, songmode, resume, nowait))
+            ++skipped;
+    }
+    m_play_snapshot.release();
+    m_play_stats.skipped_patterns(skipped);
 
     if (not_nullptr(m_master_bus))
         m_master_bus->flush();                      /* flush MIDI buss  */
 }
 
 /**
- *  For all active patterns/sequences, turn off its playing notes.
- *  Then flush the master MIDI buss.
+ *  Refills the play-set from the playing screenset, and publishes a snapshot
+ *  of it for the output thread.  See the playsnapshot class.  Called only
+ *  from the control side.
+ */
+
+void
+performer::fill_play_set ()
+{
+    mapper().fill_play_set(m_play_set);
+    m_play_snapshot.publish(m_play_set);
+    build_tempo_map();
+}
+
+/**
+ *  Gathers the tempo events of the play-set, placed by the triggers of each
+ *  pattern, into the tempo map.  The tempo before the first change is the
+ *  current tempo.  A copy of the map is then published for the output
+ *  thread.  Called only from the control side.
+ */
+
+void
+performer::build_tempo_map ()
+{
+    tempomap::changes list;
+    for (auto seqi : m_play_set)
+        (void) seqi->get_tempo_changes(list);
+
+    m_tempo_map.rebuild(m_bpm, m_ppqn, list);
+    m_tempo_map_active = m_tempo_map.active();
+    m_play_snapshot.publish(m_tempo_map);
+}
+
+/**
+ *  Gets the tempo map of a play-set snapshot, if Song mode uses it.  Called
+ *  only by the output thread (or the JACK engine cycle), which holds the
+ *  snapshot.
+ *
+ * \param ps
+ *      The snapshot obtained from m_play_snapshot.acquire().
+ *
+ * \return
+ *      Returns a pointer to the map, or null if it is not in use.
+ */
+
+const tempomap *
+performer::published_tempo_map (const playsnapshot::snapshot & ps) const
+{
+    bool usemap = song_mode() && ! m_usemidiclock && ps.tempo_map().active();
+    return usemap ? &ps.tempo_map() : nullptr ;
+}
+
+/**
+ *  Renders the playing screenset offline ("bounces" it) into a midicapture
+ *  object, as fast as the CPU allows.  The master buss diverts its output to
+ *  the capture, and performer::play() is driven by a virtual clock that steps
+ *  in the same increments the output thread would use.  So the result
+ *  matches what live playback sends to the busses, including mutes, queueing,
+ *  and Note Offs sent at the end.  In Song mode the tempo map provides the
+ *  timing; in Live mode, tempo events are followed as they play.
+ *
+ *  This calls play() from the caller's thread, which is safe only because
+ *  the output thread is idle while the performer is not running; the
+ *  playsnapshot has a single reader.
+ *
+ * \param cap
+ *      Receives the events and tempo changes.  It is cleared first.
+ *
+ * \param endtick
+ *      The pulse at which to stop.  If c_null_midipulse, the end of the last
+ *      trigger is used in Song mode, and the length of the longest pattern in
+ *      Live mode.
+ *
+ * \param [out] errmsg
+ *      Holds the reason for a failure.
+ *
+ * \return
+ *      Returns true if the render ran and captured at least one event.
+ */
+
+bool
+performer::bounce (midicapture & cap, midipulse endtick, std::string & errmsg)
+{
+    if (is_running())
+    {
+        errmsg = "Cannot render while playing";
+        return false;
+    }
+    if (is_nullptr(m_master_bus))
+    {
+        errmsg = "No master buss";
+        return false;
+    }
+
+    bool songmode = song_mode();
+    midipulse starttick = 0;
+    fill_play_set();                            /* also rebuilds tempo map  */
+    if (is_null_midipulse(endtick))
+    {
+        if (songmode)
+        {
+            endtick = get_max_trigger();
+        }
+        else
+        {
+            endtick = 0;
+            for (auto seqi : m_play_set)
+            {
+                if (seqi->get_length() > endtick)
+                    endtick = seqi->get_length();
+            }
+        }
+    }
+    if (endtick <= starttick)
+    {
+        errmsg = "Nothing to render";
+        return false;
+    }
+
+    midibpm savedbpm = m_bpm;
+    bool usemap = tempo_map_active();
+    long cycle_us = long(rc().lookahead_ms()) * 500;    /* half a window    */
+    if (cycle_us < 1000)
+        cycle_us = 1000;
+
+    tempomap::changes tempos;
+    if (usemap)
+        tempos = m_tempo_map.segments();
+
+    m_master_bus->capture(&cap);
+    reset_sequences();
+    cap.clear();
+    set_orig_ticks(starttick);
+
+    double tick = double(starttick);
+    midibpm lastbpm = 0.0;
+    while (tick < double(endtick))
+    {
+        midipulse t = midipulse(tick);
+        m_master_bus->capture_tick(t);
+        play(t);
+        if (usemap)
+        {
+            tick = m_tempo_map.advance(tick, cycle_us);
+        }
+        else
+        {
+            if (m_bpm != lastbpm)               /* live-mode tempo events   */
+            {
+                tempochange tc;
+                tc.tc_tick = t;
+                tc.tc_bpm = lastbpm = m_bpm;
+                tempos.push_back(tc);
+            }
+            tick += delta_time_us_to_ticks(cycle_us, m_bpm, m_ppqn);
+        }
+    }
+    m_master_bus->capture_tick(endtick);
+    play(endtick);
+    reset_sequences();                          /* captures final Note Offs */
+    m_master_bus->capture(nullptr);
+    for (const auto & tc : tempos)
+        cap.add_tempo(tc.tc_tick, tc.tc_bpm);
+
+    cap.sort();
+    if (m_bpm != savedbpm)
+        set_beats_per_minute(savedbpm);
+
+    midipulse home = songmode ? m_left_tick : 0 ;
+    set_tick(home);
+    set_orig_ticks(home);
+    if (cap.empty())
+    {
+        errmsg = "No events were rendered";
+        return false;
+    }
+    return true;
+}
+
+/**
+ *  For all active patterns/sequences, turn off its playing notes.  Then the
+ *  master MIDI buss turns off the notes still sounding, and flushes.
  */
 
 void
@@ -3565,7 +4287,7 @@ performer::all_notes_off ()
 {
     mapper().all_notes_off();
     if (m_master_bus)
-        m_master_bus->flush();                      /* flush MIDI buss  */
+        m_master_bus->all_notes_off();              /* leftovers, flush */
 }
 
 /**
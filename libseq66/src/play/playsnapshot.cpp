@@ -0,0 +1,228 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playsnapshot.cpp
+ *
+ *  This module defines the play-set snapshot publisher.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-23
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  See the playsnapshot.hpp module for an overview.  All atomic operations
+ *  use the default (sequentially-consistent) ordering, which the hazard
+ *  pointer check in acquire() and reclaim() depends on.
+ */
+
+#include "play/playsnapshot.hpp"        /* seq66::playsnapshot              */
+#include "play/sequence.hpp"            /* seq66::sequence                  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  Creates a snapshot from the current play-set and tempo map.
+ *
+ * \param generation
+ *      The publication number.
+ *
+ * \param p
+ *      The play-set, a vector of shared sequence pointers.
+ *
+ * \param tm
+ *      The tempo map to copy.
+ */
+
+playsnapshot::snapshot::snapshot
+(
+    unsigned long generation,
+    const screenset::playset & p,
+    const tempomap & tm
+) :
+    m_generation    (generation),
+    m_sequences     (),
+    m_owners        (p),
+    m_tempo_map     (tm)
+{
+    m_sequences.reserve(p.size());
+    for (const auto & sp : p)
+        m_sequences.push_back(sp.get());
+}
+
+/**
+ *  Starts with an empty snapshot, so that the reader never sees a null
+ *  pointer.
+ */
+
+playsnapshot::playsnapshot () :
+    m_current       (new snapshot(0, screenset::playset(), tempomap())),
+    m_in_use        (nullptr),
+    m_depth         (0),
+    m_retired       (),
+    m_generation    (0),
+    m_mutex         ()
+{
+    // Empty body
+}
+
+/**
+ *  Deletes all the snapshots.  The output thread must be stopped by now.
+ */
+
+playsnapshot::~playsnapshot ()
+{
+    for (auto sp : m_retired)
+        delete sp;
+
+    delete m_current.load();
+}
+
+/**
+ *  Publishes a new play-set, with the tempo map already published.  Called
+ *  by the control side whenever the performer refills its play-set.
+ *
+ * \threadsafe
+ *
+ * \param p
+ *      The new play-set.
+ */
+
+void
+playsnapshot::publish (const screenset::playset & p)
+{
+    automutex locker(m_mutex);
+    snapshot * fresh = new snapshot
+    (
+        ++m_generation, p, m_current.load()->tempo_map()
+    );
+    snapshot * old = m_current.exchange(fresh);
+    if (not_nullptr(old))
+        m_retired.push_back(old);
+
+    reclaim();
+}
+
+/**
+ *  Publishes a new tempo map, with the play-set already published.  Called
+ *  by the control side whenever the performer rebuilds its tempo map.
+ *
+ * \threadsafe
+ *
+ * \param tm
+ *      The new tempo map.
+ */
+
+void
+playsnapshot::publish (const tempomap & tm)
+{
+    automutex locker(m_mutex);
+    snapshot * fresh = new snapshot
+    (
+        ++m_generation, m_current.load()->m_owners, tm
+    );
+    snapshot * old = m_current.exchange(fresh);
+    if (not_nullptr(old))
+        m_retired.push_back(old);
+
+    reclaim();
+}
+
+/**
+ *  Deletes the retired snapshots that the output thread is not using.  Since
+ *  the current snapshot was swapped before this check, the reader can pick up
+ *  a retired snapshot only if it had already marked it as in use, in which
+ *  case we keep it for a later call.
+ */
+
+void
+playsnapshot::reclaim ()
+{
+    snapshot * inuse = m_in_use.load();
+    auto sp = m_retired.begin();
+    while (sp != m_retired.end())
+    {
+        if (*sp == inuse)
+        {
+            ++sp;
+        }
+        else
+        {
+            delete *sp;
+            sp = m_retired.erase(sp);
+        }
+    }
+}
+
+/**
+ *  Gets the current snapshot for the output thread, and marks it as in use.
+ *  The pointer is re-read after marking, in case a publish() slipped in
+ *  between.  No locking and no reference counting.  Must be paired with
+ *  release(), and used only by the output thread.  A nested call returns
+ *  the snapshot already in use, so that it stays the same until the
+ *  outermost release().
+ *
+ * \return
+ *      Returns a reference to the snapshot to iterate.
+ */
+
+const playsnapshot::snapshot &
+playsnapshot::acquire ()
+{
+    if (m_depth++ > 0)
+        return *m_in_use.load();
+
+    snapshot * sp = m_current.load();
+    for (;;)
+    {
+        m_in_use.store(sp);
+
+        snapshot * check = m_current.load();
+        if (check == sp)
+            break;
+
+        sp = check;
+    }
+    return *sp;
+}
+
+/**
+ *  Tells the control side that the output thread is done with the snapshot
+ *  obtained by the outermost acquire().
+ */
+
+void
+playsnapshot::release ()
+{
+    if (m_depth > 0 && --m_depth == 0)
+        m_in_use.store(nullptr);
+}
+
+}           // namespace seq66
+
+/*
+ * playsnapshot.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,315 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq66 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq66; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playstats.cpp
+ *
+ *  This module defines the timing statistics kept by the output thread.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       GNU GPLv2 or above
+ *
+ *  See the playstats.hpp module for an overview.  The report is plain text,
+ *  one line per histogram:
+ *
+\verbatim
+        Wake lateness (us): count 24000 avg 41 p50 32 p99 256 max 870
+\endverbatim
+ *
+ *  The percentiles are the upper bounds of the buckets that hold them, so
+ *  they are accurate only to within a factor of 2.
+ */
+
+#include <cstdio>                       /* std::snprintf()                  */
+#include <fstream>                      /* std::ofstream                    */
+
+#include "play/playstats.hpp"           /* seq66::playstats, histogram      */
+#include "util/basic_macros.hpp"        /* seq66::file_error()              */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/*
+ * histogram
+ */
+
+histogram::histogram () :
+    m_buckets   (),
+    m_count     (0),
+    m_total     (0),
+    m_maximum   (0)
+{
+    clear();
+}
+
+/**
+ *  Adds a value.  Negative values are counted as 0.  Only the maximum needs
+ *  a load and a store, which is safe because there is only one writer.
+ *
+ * \param value
+ *      The value to add.
+ */
+
+void
+histogram::add (long value)
+{
+    if (value < 0)
+        value = 0;
+
+    int bucket = 0;
+    for (unsigned long v = (unsigned long) value; v > 0; v >>= 1)
+        ++bucket;
+
+    if (bucket >= c_bucket_count)
+        bucket = c_bucket_count - 1;
+
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(value, std::memory_order_relaxed);
+    if (value > m_maximum.load(std::memory_order_relaxed))
+        m_maximum.store(value, std::memory_order_relaxed);
+}
+
+/**
+ *  Zeroes the histogram.  If the writer is adding a value at the same time,
+ *  that value might be partly counted, which does not matter for a report.
+ */
+
+void
+histogram::clear ()
+{
+    for (auto & b : m_buckets)
+        b.store(0, std::memory_order_relaxed);
+
+    m_count.store(0, std::memory_order_relaxed);
+    m_total.store(0, std::memory_order_relaxed);
+    m_maximum.store(0, std::memory_order_relaxed);
+}
+
+/**
+ *  Estimates a percentile.
+ *
+ * \param fraction
+ *      The fraction of the values, such as 0.99.
+ *
+ * \return
+ *      Returns the upper bound of the bucket holding the percentile, but
+ *      never more than the maximum.  Returns 0 if the histogram is empty.
+ */
+
+long
+histogram::percentile (double fraction) const
+{
+    unsigned long c = count();
+    long result = 0;
+    if (c > 0)
+    {
+        unsigned long target = (unsigned long)(double(c) * fraction);
+        unsigned long sum = 0;
+        for (int b = 0; b < c_bucket_count; ++b)
+        {
+            sum += m_buckets[b].load(std::memory_order_relaxed);
+            if (sum > target || b == c_bucket_count - 1)
+            {
+                result = b == 0 ? 0 : (1L << b) - 1 ;
+                break;
+            }
+        }
+        if (result > maximum())
+            result = maximum();
+    }
+    return result;
+}
+
+/**
+ * \return
+ *      Returns a line of text summarizing the histogram.
+ */
+
+std::string
+histogram::report
+(
+    const std::string & name,
+    const std::string & units
+) const
+{
+    char temp[160];
+    std::string label = units.empty() ? name : name + " (" + units + ")" ;
+    (void) std::snprintf
+    (
+        temp, sizeof temp,
+        "%s: count %lu avg %ld p50 %ld p99 %ld max %ld",
+        label.c_str(), count(), average(), percentile(0.50),
+        percentile(0.99), maximum()
+    );
+    return std::string(temp);
+}
+
+/*
+ * playstats
+ */
+
+playstats::playstats () :
+    m_wake_lateness     (),
+    m_play_duration     (),
+    m_cycle_events      (),
+    m_bus_events        (),
+    m_scheduler_fill    (),
+    m_bus_count         (0),
+    m_deferred_periods  (0),
+    m_skipped_patterns  (0),
+    m_dropped_events    (0)
+{
+    // Empty body
+}
+
+/**
+ *  Records the end of an output cycle.
+ *
+ * \param buscounts
+ *      The number of events sent on each buss during the cycle.
+ *
+ * \param scheduled
+ *      The number of events left in the lookahead scheduler.
+ */
+
+void
+playstats::cycle (const std::vector<int> & buscounts, int scheduled)
+{
+    int total = 0;
+    int busses = int(buscounts.size());
+    if (busses > c_busscount_max)
+        busses = c_busscount_max;
+
+    for (int bus = 0; bus < busses; ++bus)
+    {
+        int c = buscounts[bus];
+        if (c > 0)
+        {
+            total += c;
+            if (bus >= m_bus_count.load(std::memory_order_relaxed))
+                m_bus_count.store(bus + 1, std::memory_order_relaxed);
+        }
+        m_bus_events[bus].add(c);
+    }
+    m_cycle_events.add(total);
+    m_scheduler_fill.add(scheduled);
+}
+
+void
+playstats::clear ()
+{
+    m_wake_lateness.clear();
+    m_play_duration.clear();
+    m_cycle_events.clear();
+    for (auto & h : m_bus_events)
+        h.clear();
+
+    m_scheduler_fill.clear();
+    m_bus_count.store(0, std::memory_order_relaxed);
+    m_deferred_periods.store(0, std::memory_order_relaxed);
+    m_skipped_patterns.store(0, std::memory_order_relaxed);
+    m_dropped_events.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * \return
+ *      Returns the report, one histogram per line.  Busses that have not
+ *      sent anything are skipped, as are the engine-mode counts if they
+ *      are all 0.
+ */
+
+std::string
+playstats::report () const
+{
+    std::string result = "Output cycles: ";
+    result += std::to_string(cycles());
+    result += "\n";
+    result += m_wake_lateness.report("Wake lateness", "us");
+    result += "\n";
+    result += m_play_duration.report("Play duration", "ns");
+    result += "\n";
+    result += m_cycle_events.report("Events per cycle", "");
+    result += "\n";
+
+    int busses = m_bus_count.load(std::memory_order_relaxed);
+    for (int bus = 0; bus < busses; ++bus)
+    {
+        std::string name = "  Buss " + std::to_string(bus);
+        result += m_bus_events[bus].report(name, "events");
+        result += "\n";
+    }
+    result += m_scheduler_fill.report("Scheduler fill", "events");
+    result += "\n";
+
+    unsigned long deferred = m_deferred_periods.load(std::memory_order_relaxed);
+    unsigned long skipped = m_skipped_patterns.load(std::memory_order_relaxed);
+    unsigned long dropped = m_dropped_events.load(std::memory_order_relaxed);
+    if (deferred > 0 || skipped > 0 || dropped > 0)
+    {
+        result += "Engine: deferred periods ";
+        result += std::to_string(deferred);
+        result += ", skipped patterns ";
+        result += std::to_string(skipped);
+        result += ", dropped events ";
+        result += std::to_string(dropped);
+        result += "\n";
+    }
+    return result;
+}
+
+/**
+ *  Writes the report to a file, replacing its contents.
+ *
+ * \param filename
+ *      The full path to the file.
+ *
+ * \return
+ *      Returns true if the file could be written.
+ */
+
+bool
+playstats::write (const std::string & filename) const
+{
+    std::ofstream file(filename, std::ios::out | std::ios::trunc);
+    bool result = file.is_open();
+    if (result)
+    {
+        file << report();
+        result = file.good();
+    }
+    if (! result)
+        (void) file_error("Write failed", filename);
+
+    return result;
+}
+
+}           // namespace seq66
+
+/*
+ * playstats.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
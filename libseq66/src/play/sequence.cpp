@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2020-09-24
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  The functionality of this class also includes handling some of the
@@ -48,6 +48,7 @@
  *      point, and add better locking coverage if necessary.
  */
 
+#include <algorithm>                    /* std::lower_bound()               */
 #include <cstring>                      /* std::memset()                    */
 
 #include "cfg/scales.hpp"               /* seq66 scales functions           */
@@ -134,6 +135,7 @@ sequence::sequence (int ppqn)
     m_bus                       (0),
     m_song_mute                 (false),
     m_transposable              (true),
+    m_transform                 (),
     m_notes_on                  (0),
     m_master_bus                (nullptr),
     m_playing_notes             (),             // an array
@@ -167,6 +169,10 @@ sequence::sequence (int ppqn)
     m_last_tick                 (0),
     m_queued_tick               (0),
     m_trigger_offset            (0),
+    m_play_cursor_valid         (false),
+    m_play_index                (0),
+    m_play_base                 (0),
+    m_play_count                (0),
     m_maxbeats                  (c_maxbeats),
     m_ppqn                      (choose_ppqn(ppqn)),
     m_seq_number                (unassigned()),
@@ -185,7 +191,10 @@ sequence::sequence (int ppqn)
     m_musical_key               (c_key_of_C),
     m_musical_scale             (c_scales_off),
     m_background_sequence       (sequence::limit()),
-    m_mutex                     ()
+    m_mutex                     (),
+    m_play_events               (),
+    m_play_stale                (false),
+    m_play_event                ()
 {
     m_events.set_length(m_length);
     m_triggers.set_ppqn(int(m_ppqn));
@@ -215,11 +224,19 @@ sequence::~sequence ()
  *  Note that now we don't call performer::modify(), now we call its
  *  notification function for sequence-changes, which notifies all subscribers
  *  and also calls modify().
+ *
+ * \param eventschanged
+ *      If true (the default), the events were edited, and the playback
+ *      events are rebuilt.  Changes to the buss, channel, and similar
+ *      settings pass false.
  */
 
 void
-sequence::modify ()
+sequence::modify (bool eventschanged)
 {
+    if (eventschanged)
+        update_play_events();
+
     set_dirty();
 
     /*
@@ -263,6 +280,7 @@ sequence::partial_assign (const sequence & rhs)
         m_midi_channel              = rhs.m_midi_channel;
         m_bus                       = rhs.m_bus;
         m_transposable              = rhs.m_transposable;
+        m_transform                 = rhs.m_transform;
         m_master_bus                = rhs.m_master_bus;     /* a pointer    */
         m_was_playing               = false;
         m_playing                   = false;
@@ -295,6 +313,7 @@ sequence::partial_assign (const sequence & rhs)
             p = 0;
 
         m_last_tick = 0;                            /* reset to tick 0      */
+        reset_play_cursor();
         verify_and_link();                          /* NoteOn <---> NoteOff */
         modify();                                   /* ca 2020-07-30        */
     }
@@ -887,29 +906,37 @@ sequence::play
              */
         }
     }
-    if (playing())                          /* play notes in frame          */
+    if (m_play_stale)                       /* see append_event()       */
+        update_play_events();
+
+    if (playing() && ! m_play_events.empty())       /* play notes in frame  */
     {
-        midipulse offset = get_length() - m_trigger_offset;
+        midipulse length = get_length();
+        midipulse offset = length - m_trigger_offset;
         midipulse start_tick_offset = start_tick + offset;
         midipulse end_tick_offset = end_tick + offset;
-        midipulse times_played = m_last_tick / get_length();
-        midipulse offset_base = times_played * get_length();
-        int transpose = transposable() ? m_parent->get_transpose() : 0 ;
-        auto e = m_events.begin();
-        while (e != m_events.end())
+        size_t count = m_play_events.size();
+        size_t index;
+        midipulse offset_base;
+        if (play_cursor_check(start_tick_offset))
         {
-            event & er = eventlist::dref(e);
-            midipulse stamp = er.timestamp() + offset_base;
-            if (stamp >= start_tick_offset && stamp <= end_tick_offset)
+            index = m_play_index;                   /* resume where we were */
+            offset_base = m_play_base;
+        }
+        else
+            play_cursor_locate(start_tick_offset, index, offset_base);
+
+        for (;;)
+        {
+            const playevent & pe = m_play_events[index];
+            midipulse stamp = pe.pe_timestamp + offset_base;
+            if (stamp > end_tick_offset)
+                break;                              /* frame is done        */
+
+            if (stamp >= start_tick_offset)
             {
 
 #if defined SEQ66_PLATFORM_DEBUG_TMI
-                /*
-                 * When we've reach the play state, we always find that start =
-                 * stamp = end, and offset is a constant equal to the first
-                 * stamp found (at least for awhile).
-                 */
-
                 printf
                 (
                     "start = %ld <= %ld <= end = %ld; offset = %ld, base = %ld\n",
@@ -917,51 +944,46 @@ sequence::play
                     offset_base
                 );
 #endif
-                if (transpose != 0 && er.is_note()) /* includes Aftertouch  */
+                midipulse playtick = stamp - offset;    /* global pulse     */
+                if ((pe.pe_flags & c_playevent_tempo) != 0)
                 {
-                    er.transpose_note(transpose);
-                    put_event_on_bus(er);
+                    /*
+                     * In Song mode, the performer's tempo map already
+                     * accounts for this event.
+                     */
+
+                    if (not_nullptr(m_parent))
+                    {
+                        bool usemap = playback_mode &&
+                            m_parent->tempo_map_active();
+
+                        if (! usemap)
+                        {
+                            midibpm bpm = m_play_events.tempo(pe);
+                            m_parent->set_beats_per_minute(bpm);
+                        }
+                    }
                 }
                 else
                 {
-                    if (er.is_tempo())
-                    {
-                        if (not_nullptr(m_parent))
-                            m_parent->set_beats_per_minute(er.tempo());
-                    }
-                    else if (! er.is_ex_data())
-                    {
-                        put_event_on_bus(er);       /* frame still going    */
-                    }
+                    m_play_events.fill(pe, m_play_event);
+                    put_event_on_bus(m_play_event, playtick);
                 }
             }
-            else if (stamp > end_tick_offset)
-                break;                              /* frame is done        */
-
-            ++e;                                    /* go to next event     */
-            if (e == m_events.end())                /* did we hit the end ? */
+            if (++index == count)                   /* did we hit the end ? */
             {
-                e = m_events.begin();               /* yes, start over      */
-                offset_base += get_length();        /* for another go at it */
-
-                /*
-                 * Putting this sleep here doesn't reduce the total CPU load,
-                 * but it does prevent one CPU from being hammered at 100%.
-                 * However, it also makes the live-grid progress bar jittery
-                 * when unmuted, for shorter patterns, which play()
-                 * relentlessly here.
-                 *
-                 *      millisleep(1);
-                 *
-                 * Another possible criteria is note_count(), but currently
-                 * that is a looping (time-eating) function.
-                 */
-
-                if (measure_threshold())
-                    (void) microsleep(1);
+                index = 0;                          /* yes, start over      */
+                offset_base += length;              /* for another go at it */
             }
         }
+        m_play_index = index;
+        m_play_base = offset_base;
+        m_play_count = int(count);
+        m_play_cursor_valid = true;
     }
+    else
+        reset_play_cursor();
+
     if (trigger_turning_off)                        /* triggers: "turn off" */
     {
         set_playing(false);
@@ -970,6 +992,100 @@ sequence::play
     m_was_playing = m_playing;
 }
 
+/**
+ *  Checks that the play cursor saved by the previous play() call is still
+ *  exactly where a scan of the playback events would start.  Besides the
+ *  explicit resets, we make sure that the number of events is unchanged,
+ *  that the event under the cursor is not before the start of the frame,
+ *  and that the event just before the cursor is.  This catches trigger-offset
+ *  changes in Song mode.  Assumes the caller holds the mutex and that
+ *  m_play_events is current.
+ *
+ * \param start_tick_offset
+ *      The (offset) start of the frame to be played.
+ *
+ * \return
+ *      Returns true if m_play_index and m_play_base can be used.
+ */
+
+bool
+sequence::play_cursor_check (midipulse start_tick_offset)
+{
+    size_t count = m_play_events.size();
+    bool result = m_play_cursor_valid && size_t(m_play_count) == count;
+    if (result)
+        result = m_play_index < count;
+
+    if (result)
+    {
+        const playevent & pe = m_play_events[m_play_index];
+        midipulse stamp = pe.pe_timestamp + m_play_base;
+        result = stamp >= start_tick_offset;
+        if (result)
+        {
+            midipulse base = m_play_base;
+            size_t prev = m_play_index;
+            if (prev == 0)
+            {
+                prev = count;
+                base -= get_length();
+            }
+            --prev;
+            stamp = m_play_events[prev].pe_timestamp + base;
+            result = stamp < start_tick_offset;
+        }
+    }
+    return result;
+}
+
+/**
+ *  Finds the first event at or after the start of the frame, using a binary
+ *  search of each loop pass instead of the linear scan that play() used to
+ *  do.  The first pass starts at the multiple of the length containing
+ *  m_last_tick.  Assumes the caller holds the mutex and that m_play_events
+ *  is not empty.
+ *
+ * \param start_tick_offset
+ *      The (offset) start of the frame to be played.
+ *
+ * \param [out] index
+ *      The index of the first event to examine.
+ *
+ * \param [out] offset_base
+ *      The pulse offset of the loop pass holding that event.
+ */
+
+void
+sequence::play_cursor_locate
+(
+    midipulse start_tick_offset,
+    size_t & index,
+    midipulse & offset_base
+)
+{
+    midipulse length = get_length();
+    midipulse base = (m_last_tick / length) * length;
+    auto earlier = [] (const playevent & pe, midipulse t)
+    {
+        return pe.pe_timestamp < t;
+    };
+    for (;;)
+    {
+        auto e = std::lower_bound
+        (
+            m_play_events.begin(), m_play_events.end(),
+            start_tick_offset - base, earlier
+        );
+        if (e != m_play_events.end())
+        {
+            index = size_t(e - m_play_events.begin());
+            offset_base = base;
+            break;
+        }
+        base += length;
+    }
+}
+
 /**
  *  This function verifies state: all note-ons have a note-off, and it links
  *  note-offs with their note-ons.
@@ -982,6 +1098,40 @@ sequence::verify_and_link ()
 {
     automutex locker(m_mutex);
     m_events.verify_and_link(get_length());
+    update_play_events();
+}
+
+/**
+ *  Rebuilds the compact array of events scanned by play(), after an edit of
+ *  the event list.  This is done by the thread that makes the edit, so that
+ *  the output thread does not have to.  The sequence mutex keeps play() out
+ *  while the array is rebuilt.
+ *
+ * \threadsafe
+ */
+
+void
+sequence::update_play_events ()
+{
+    automutex locker(m_mutex);
+    m_play_events.build(m_events);
+    m_play_stale = false;
+    reset_play_cursor();
+}
+
+/**
+ *  Sorts the events, after a series of append_event() calls, and rebuilds
+ *  the playback events.
+ *
+ * \threadsafe
+ */
+
+void
+sequence::sort_events ()
+{
+    automutex locker(m_mutex);
+    m_events.sort();
+    update_play_events();
 }
 
 /**
@@ -1038,7 +1188,7 @@ sequence::remove (event::buffer::iterator evi)
         event & er = eventlist::dref(evi);
         if (er.is_note_off() && m_playing_notes[er.get_note()] > 0)
         {
-            master_bus()->play(m_bus, &er, m_midi_channel);
+            send_to_bus(er, m_midi_channel, c_null_midipulse);
             --m_playing_notes[er.get_note()];                   // ugh
         }
         if (m_events.remove(evi))
@@ -1082,6 +1232,7 @@ sequence::remove_all ()
     automutex locker(m_mutex);
     m_events.clear();
     m_events.unmodify();
+    update_play_events();
 }
 
 #endif  // defined USE_SEQUENCE_REMOVE_EVENTS
@@ -1699,6 +1850,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
     midibyte data[2];
     midibyte datitem;
     int datidx = 0;
+    bool changed = false;
     automutex locker(m_mutex);
     for (auto & e : m_events)
     {
@@ -1724,8 +1876,11 @@ sequence::adjust_data_handle (midibyte status, int adata)
 
             data[datidx] = datitem;
             e.set_data(data[0], data[1]);
+            changed = true;
         }
     }
+    if (changed)
+        update_play_events();
 }
 
 /**
@@ -1752,6 +1907,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
 void
 sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
 {
+    bool changed = false;
     automutex locker(m_mutex);
     for (auto & er : m_events)
     {
@@ -1761,8 +1917,12 @@ sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
                 er.increment_data2();
             else if (event::is_one_byte_msg(astat))
                 er.increment_data1();
+
+            changed = true;
         }
     }
+    if (changed)
+        update_play_events();
 }
 
 /**
@@ -1791,6 +1951,7 @@ sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
 void
 sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
 {
+    bool changed = false;
     automutex locker(m_mutex);
     for (auto & er : m_events)
     {
@@ -1802,9 +1963,13 @@ sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
                     er.decrement_data2();
                 else if (event::is_one_byte_msg(astat))
                     er.decrement_data1();
+
+                changed = true;
             }
         }
     }
+    if (changed)
+        update_play_events();
 }
 
 /**
@@ -2098,7 +2263,8 @@ sequence::change_event_data_range
             if (er.is_tempo())
             {
                 midibpm tempo = note_value_to_tempo(midibyte(newdata));
-                result = er.set_tempo(tempo);
+                if (er.set_tempo(tempo))
+                    result = true;
             }
             else
             {
@@ -2110,10 +2276,11 @@ sequence::change_event_data_range
                 er.set_data(d0, d1);
                 result = true;
             }
-            if (result)
-                modify();
         }
     }
+    if (result)
+        modify();                               /* one rebuild for the lot  */
+
     return result;
 }
 
@@ -2225,9 +2392,11 @@ sequence::change_event_data_relative
 
             er.set_data(d0, d1);
             result = true;
-            modify();
         }
     }
+    if (result)
+        modify();                               /* one rebuild for the lot  */
+
     return result;
 }
 
@@ -2281,6 +2450,7 @@ sequence::change_event_data_lfo
     double dlength = double(get_length());
     double dbw = double(m_time_beat_width);
     bool have_selection = m_events.any_selected_events(status, cc);
+    bool changed = false;
     if (get_length() == 0)                  /* should never happen, though  */
         dlength = double(m_ppqn);
 
@@ -2330,8 +2500,11 @@ sequence::change_event_data_lfo
                 d0 = newdata;
 
             e.set_data(d0, d1);
+            changed = true;
         }
     }
+    if (changed)
+        update_play_events();
 }
 
 /**
@@ -2605,6 +2778,7 @@ bool
 sequence::append_event (const event & er)
 {
     automutex locker(m_mutex);
+    m_play_stale = true;            /* rebuilt by sort_events(), etc.   */
     return m_events.append(er);     /* does *not* sort, too time-consuming */
 }
 
@@ -2752,6 +2926,7 @@ sequence::stream_event (event & ev)
         {
             loop_reset(false);
             m_events.clear();                   /* vice remove_all()        */
+            update_play_events();
             set_dirty();
         }
         ev.set_status(ev.get_status());         /* clear the channel nybble */
@@ -3501,6 +3676,57 @@ sequence::get_max_trigger () const
     return m_triggers.get_maximum();
 }
 
+/**
+ *  Adds the song position of each Set Tempo event of this pattern, for every
+ *  repetition of the pattern inside every trigger, to a tempo-map list.  The
+ *  position follows play(): an event at timestamp \a ts in a trigger with
+ *  offset \a o plays at the song pulses ts + o + n * length that lie within
+ *  the trigger.  A song-muted pattern does not play, and adds nothing.
+ *
+ * \param [out] list
+ *      The list to which the tempo changes are appended.
+ *
+ * \return
+ *      Returns the number of tempo changes added.
+ */
+
+int
+sequence::get_tempo_changes (tempomap::changes & list) const
+{
+    automutex locker(m_mutex);
+    int result = 0;
+    midipulse length = get_length();
+    if (m_song_mute || length <= 0)
+        return result;
+
+    for (auto cev = m_events.cbegin(); cev != m_events.cend(); ++cev)
+    {
+        const event & er = eventlist::cdref(cev);
+        if (! er.is_tempo())
+            continue;
+
+        for (const auto & t : triggerlist())
+        {
+            midipulse tick = er.timestamp() + t.offset();
+            midipulse start = t.tick_start();
+            if (tick < start)
+                tick += ((start - tick + length - 1) / length) * length;
+            else
+                tick -= ((tick - start) / length) * length;
+
+            for ( ; tick <= t.tick_end(); tick += length)
+            {
+                tempochange tc;
+                tc.tc_tick = tick;
+                tc.tc_bpm = er.tempo();
+                list.push_back(tc);
+                ++result;
+            }
+        }
+    }
+    return result;
+}
+
 /**
  *  Checks the list of triggers against the given tick.  If any
  *  trigger is found to bracket that tick, then true is returned.
@@ -4189,6 +4415,7 @@ sequence::set_last_tick (midipulse tick)
 {
     automutex locker(m_mutex);
     m_last_tick = tick;
+    reset_play_cursor();                    /* a reposition                 */
 }
 
 /**
@@ -4235,7 +4462,7 @@ sequence::set_midi_bus (char mb, bool user_change)
         off_playing_notes();            /* off notes except initial         */
         m_bus = mb;
         if (user_change)
-            modify();                   /* no easy way to undo this, though */
+            modify(false);              /* no easy way to undo this, though */
 
         /*
          * TODO: add a recreate flag
@@ -4319,6 +4546,8 @@ sequence::set_length (midipulse len, bool adjust_triggers, bool verify)
     else
         len = get_length();
 
+    reset_play_cursor();
+
     /*
      * We should set the measures count here.
      */
@@ -4715,7 +4944,7 @@ sequence::set_midi_channel (midibyte ch, bool user_change)
             m_midi_channel = ch;
 
         if (user_change)
-            modify();                   /* no easy way to undo this, though */
+            modify(false);              /* no easy way to undo this, though */
 
         set_dirty();                    /* this is for display updating     */
     }
@@ -4764,16 +4993,22 @@ sequence::print_triggers () const
 /**
  *  Takes an event that this sequence is holding, and places it on the MIDI
  *  buss.  This function does not bother checking if m_master_bus is a null
- *  pointer.
+ *  pointer.  The event itself is never changed; see send_to_bus().
  *
  * \param ev
  *      The event to put on the buss.
  *
+ * \param tick
+ *      The global pulse at which the event is meant to sound.  If provided
+ *      (i.e. not c_null_midipulse), the event goes to the master buss's
+ *      lookahead scheduler, if active.  Otherwise, the event is sent and
+ *      flushed immediately.
+ *
  * \threadsafe
  */
 
 void
-sequence::put_event_on_bus (event & ev)
+sequence::put_event_on_bus (event & ev, midipulse tick)
 {
     midibyte note = ev.get_note();
     bool skip = false;
@@ -4790,8 +5025,67 @@ sequence::put_event_on_bus (event & ev)
     if (! skip)
     {
         midibyte channel = m_no_channel ? ev.channel() : m_midi_channel ;
-        master_bus()->play(m_bus, &ev, channel);
-        master_bus()->flush();
+        send_to_bus(ev, channel, tick);
+        if (is_null_midipulse(tick))
+            master_bus()->flush();
+    }
+}
+
+/**
+ *  Sends an event through the output transform stage: the transpose of the
+ *  performer (if the pattern is transposable), then m_transform.  These are
+ *  applied to a copy of the event, so the pattern data stays untouched
+ *  while it plays.  If no transform is in force, the event is sent as is.
+ *  The Note Offs of off_playing_notes() also come through here, so they
+ *  match the transformed Note Ons.
+ *
+ * \param ev
+ *      The event to send.
+ *
+ * \param channel
+ *      The channel on which to send the event, before any remapping.
+ *
+ * \param tick
+ *      The global pulse of the event, or c_null_midipulse to send it right
+ *      away.  In that case, the caller flushes the buss.
+ *
+ * \param ending
+ *      If true, the event is a Note Off that ends a note of this pattern,
+ *      sent right away.  A matching Note On still waiting in the lookahead
+ *      scheduler is then dropped.  See mastermidibase::play_off().
+ */
+
+void
+sequence::send_to_bus
+(
+    event & ev, midibyte channel, midipulse tick, bool ending
+)
+{
+    int transpose = 0;
+    if (transposable() && not_nullptr(m_parent))
+        transpose = m_parent->get_transpose();
+
+    auto send = [this, tick, ending] (event & e, midibyte ch)
+    {
+        if (ending)
+            master_bus()->play_off(m_bus, &e, ch);
+        else if (is_null_midipulse(tick))
+            master_bus()->play(m_bus, &e, ch);
+        else
+            master_bus()->play_at(m_bus, &e, ch, tick);
+    };
+    if (transpose == 0 && m_transform.identity())
+    {
+        send(ev, channel);
+    }
+    else
+    {
+        event copy(ev);
+        if (transpose != 0 && copy.is_note())   /* includes Aftertouch      */
+            copy.transpose_note(transpose);
+
+        m_transform.apply(copy, channel);
+        send(copy, channel);
     }
 }
 
@@ -4813,7 +5107,7 @@ sequence::off_playing_notes ()
         while (m_playing_notes[x] > 0)
         {
             e.set_data(x, midibyte(0));               /* or is 127 better?  */
-            master_bus()->play(m_bus, &e, m_midi_channel);
+            send_to_bus(e, m_midi_channel, c_null_midipulse, true);
             if (m_playing_notes[x] > 0)
                 --m_playing_notes[x];
         }
@@ -4969,6 +5263,7 @@ sequence::shift_notes (midipulse ticks)
     if (result)
     {
         m_events.sort();
+        update_play_events();
         set_dirty();                            /* seqedit to update    */
     }
 }
@@ -4993,6 +5288,7 @@ sequence::apply_song_transpose ()
             if (er.is_note())                       /* also aftertouch      */
                 er.transpose_note(transpose);
         }
+        update_play_events();
         set_dirty();
     }
 }
@@ -5009,11 +5305,28 @@ void
 sequence::set_transposable (bool flag)
 {
     if (flag != m_transposable)
-        modify();
+        modify(false);
 
     m_transposable = flag;
 }
 
+/**
+ *  Sets the output transform of the pattern.  The notes now sounding are
+ *  turned off first, since their Note Offs would no longer match once the
+ *  transform changes.  This is not a modification of the pattern.
+ *
+ * \param ot
+ *      The new transform.
+ */
+
+void
+sequence::transform (const outtransform & ot)
+{
+    automutex locker(m_mutex);
+    off_playing_notes();
+    m_transform = ot;
+}
+
 /**
  *  Quantizes the currently-selected set of events that match the type of
  *  event specified.  This function first marks the selected events.  Then it
@@ -5059,7 +5372,10 @@ sequence::quantize_events
 
     bool result = m_events.quantize_events(status, cc, snap(), divide, fixlink);
     if (result)
+    {
+        update_play_events();
         set_dirty();
+    }
 
     return result;
 }
@@ -5279,11 +5595,34 @@ sequence::set_parent (performer * p)
  *
  * \param resumenoteons
  *      Indicates if we are to resume Note Ons.  Used by performer::play().
+ *
+ * \param nowait
+ *      If true, the pattern is not played if another thread holds its
+ *      mutex, such as an edit that rebuilds the playback events.  Since
+ *      m_last_tick is then left alone, the next call plays the events that
+ *      were skipped, a little late.  Used by the JACK process callback in
+ *      engine mode, which must not block.
+ *
+ * \return
+ *      Returns false if the pattern was skipped.
  */
 
-void
-sequence::play_queue (midipulse tick, bool playbackmode, bool resumenoteons)
+bool
+sequence::play_queue
+(
+    midipulse tick, bool playbackmode, bool resumenoteons, bool nowait
+)
 {
+    if (nowait)
+    {
+        bool result = m_mutex.try_lock();
+        if (result)
+        {
+            (void) play_queue(tick, playbackmode, resumenoteons);
+            m_mutex.unlock();
+        }
+        return result;
+    }
     if (check_queued_tick(tick))
     {
         play(get_queued_tick() - 1, playbackmode, resumenoteons);
@@ -5296,6 +5635,7 @@ sequence::play_queue (midipulse tick, bool playbackmode, bool resumenoteons)
         (void) toggle_queued(); /* queue it to mute it again after one play */
     }
     play(tick, playbackmode, resumenoteons);
+    return true;
 }
 
 /**
@@ -25,7 +25,7 @@
  * \library       clinsmanager application
  * \author        Chris Ahlstrom
  * \date          2020-08-31
- * \updates       2020-11-18
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This object also works if there is no session manager in the build.  It
@@ -36,7 +36,7 @@
 #include "cfg/notemapfile.hpp"          /* seq66::notemapfile               */
 #include "cfg/playlistfile.hpp"         /* seq66::playlistfile class        */
 #include "cfg/settings.hpp"             /* seq66::usr() and seq66::rc()     */
-#include "midi/midifile.hpp"            /* seq66::write_midi_file()         */
+#include "midi/midifile.hpp"            /* seq66::write_midi_file(), etc.   */
 #include "os/daemonize.hpp"             /* seq66::pid_exists()              */
 #include "os/timing.hpp"                /* seq66::microsleep()              */
 #include "play/playlist.hpp"            /* seq66::playlist class            */
@@ -289,12 +289,33 @@ clinsmanager::save_session (std::string & msg, bool ok)
 /**
  *  This function is useful in the command-line version of the application.
  *  For the Qt version, see the qt5nsmanager class.
+ *
+ *  If the "-o bounce=filename" option was given, the song is rendered
+ *  offline to that file, and the function returns without running the
+ *  session loop.
  */
 
 bool
 clinsmanager::run ()
 {
     bool result = false;
+    const std::string & bouncefile = usr().option_bounce();
+    if (! bouncefile.empty())
+    {
+        std::string msg;
+        result = not_nullptr(perf());
+        if (result)
+        {
+            result = bounce_midi_file
+            (
+                *perf(), bouncefile, usr().option_bounce_format(), msg
+            );
+        }
+        if (! result)
+            file_error(msg, bouncefile);
+
+        return result;
+    }
     session_setup();
     while (! session_close())
     {
@@ -308,6 +329,9 @@ clinsmanager::run ()
                 file_error(msg, "CLI");
             }
         }
+        if (session_stats() && not_nullptr(perf()))
+            (void) perf()->report_play_stats();
+
         microsleep(1000);                       /* 1 ms */
     }
     return true;
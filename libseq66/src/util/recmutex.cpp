@@ -24,7 +24,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2020-07-16
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  Seq66 needs a mutex for sequencer operations. We have finally, after a
@@ -103,6 +103,25 @@ recmutex::lock () const
 #endif
 }
 
+/**
+ *  Locks the recmutex if no other thread holds it, without waiting.  Used
+ *  by the JACK process callback in engine mode, which must not block.
+ *
+ * \return
+ *      Returns true if the mutex was locked, and must then be unlocked.
+ */
+
+bool
+recmutex::try_lock () const
+{
+    bool result = pthread_mutex_trylock(&m_mutex_lock) == 0;
+#if defined SEQ66_USE_MUTEX_UNLOCKED_FLAG
+    if (result)
+        m_is_locked = true;
+#endif
+    return result;
+}
+
 /**
  *  Unlocks the recmutex.
  */
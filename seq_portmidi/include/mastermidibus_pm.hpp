@@ -27,7 +27,7 @@
  * \library       sequencer66 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2019-03-10
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This mastermidibus module is the Windows (and Linux now!) version of the
@@ -56,9 +56,25 @@ class mastermidibus : public mastermidibase
 private:
 
     /*
-     *  All members have been moved into the new base class.
+     *  Most members have been moved into the new base class.
      */
 
+    /**
+     *  The output latency, in milliseconds, with which the output ports are
+     *  opened.  PortMidi sends each event at its timestamp plus this
+     *  latency.  If 0, the timestamps are ignored.  Read from the 'rc' file
+     *  by api_init().
+     */
+
+    PmTimestamp m_latency;
+
+    /**
+     *  The PortTime, in milliseconds, at which the events written next are
+     *  to be sent.  Set by api_deliver_at(); 0 means as soon as possible.
+     */
+
+    PmTimestamp m_deliver_ms;
+
 public:
 
     mastermidibus
@@ -69,17 +85,26 @@ public:
     virtual ~mastermidibus ();
     virtual bool activate ();
 
+    PmTimestamp latency () const
+    {
+        return m_latency;
+    }
+
+    PmTimestamp timestamp () const;
+
 protected:
 
     virtual void api_init (int ppqn, midibpm /*bpm*/);
     virtual bool api_get_midi_event (event * in);
     virtual void api_set_ppqn (int ppqn);
     virtual void api_set_beats_per_minute (midibpm bpm);
+    virtual void api_flush ();
+    virtual bool api_timed_output (bool flag);
+    virtual void api_deliver_at (long us);
 
     /*
      * Are these necessary?
      *
-    virtual void api_flush ();
     virtual void api_start ();
     virtual void api_stop ();
     virtual void api_continue_from (midipulse tick);
@@ -27,7 +27,7 @@
  * \library       sequencer66 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2019-03-10
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This midibus module is the Windows (PortMidi) version of the midibus
@@ -45,6 +45,7 @@
 namespace seq66
 {
     class event;
+    class mastermidibus;
 
 /**
  *  This class implements with Windows version of the midibus object.
@@ -66,6 +67,34 @@ private:
 
     PortMidiStream * m_pms;
 
+    /**
+     *  The master buss, which provides the timestamp of the events written
+     *  next.  Null if the buss is not part of a master buss.
+     */
+
+    const mastermidibus * m_master;
+
+    /**
+     *  The most messages kept before they are written with one Pm_Write()
+     *  call.
+     */
+
+    static const int c_batch_max = 64;
+
+    /**
+     *  The messages written since the last flush.  They go out together
+     *  when api_flush() is called, at the end of each output cycle, or when
+     *  the array is full.
+     */
+
+    PmEvent m_batch[c_batch_max];
+
+    /**
+     *  The number of messages in m_batch.
+     */
+
+    int m_batch_count;
+
 public:
 
     /*
@@ -77,7 +106,8 @@ public:
         int index,
         int bus_id,
         int port_id,
-        const std::string & client_name
+        const std::string & client_name,
+        const mastermidibus * master = nullptr
     );
 
     virtual ~midibus ();
@@ -92,6 +122,11 @@ protected:
     virtual void api_stop ();
     virtual void api_clock (midipulse tick);
     virtual void api_play (event * e24, midibyte channel);
+    virtual void api_flush ();
+
+private:
+
+    void write (PmMessage message);
 
     /*
      * Functions not implemented in PortMIDI.  For example, the "sub"
@@ -105,10 +140,6 @@ protected:
      * We should be able to implement this in a "sysex_fix" branch:
      *
      * virtual void api_sysex (event * e24);
-     *
-     * This function should be able to be implemented in Windows and ALSA:
-     *
-     * virtual void api_flush ();
      */
 
 };          // class midibus (portmidi)
@@ -25,19 +25,21 @@
  * \library       sequencer66 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2019-08-12
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This file provides a Windows-only implementation of the mastermidibus
  *  class.  There is a lot of common code between these two versions!
  */
 
+#include "cfg/settings.hpp"             /* seq66::rc() configuration object */
 #include "midi/event.hpp"               /* seq66::event                     */
 #include "mastermidibus_pm.hpp"         /* seq66::mastermidibus, PortMIDI   */
 #include "midibus_pm.hpp"               /* seq66::midibus, PortMIDI         */
 #include "portmidi.h"                   /* external PortMidi header file    */
 #include "porttime.h"                   /* Pt_Time_To_Pulses()              */
 #include "pmutil.h"                     /* Pm_Dequeue()                     */
+#include "os/timing.hpp"                /* seq66::microtime()               */
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -60,7 +62,9 @@ namespace seq66
 
 mastermidibus::mastermidibus (int ppqn, midibpm bpm)
  :
-    mastermidibase      (ppqn, bpm)
+    mastermidibase      (ppqn, bpm),
+    m_latency           (0),
+    m_deliver_ms        (0)
 {
     /**
      * New features. Turn off exiting upon errors so that the application
@@ -121,6 +125,8 @@ mastermidibus::activate ()
 void
 mastermidibus::api_init (int ppqn, midibpm /*bpm*/)
 {
+    m_latency = PmTimestamp(rc().portmidi_latency());
+
     int num_devices = Pm_device_count();    /* Pm_CountDevices()    */
     int numouts = 0;
     int numins = 0;
@@ -135,7 +141,10 @@ mastermidibus::api_init (int ppqn, midibpm /*bpm*/)
              * hmmmmm), the port ID, and the client name.
              */
 
-            midibus * m = new midibus(numouts, numouts, i, dev_info->name);
+            midibus * m = new midibus
+            (
+                numouts, numouts, i, dev_info->name, this
+            );
             m->is_input_port(false);
             m->is_virtual_port(false);
             m_outbus_array.add(m, clock(numouts));      /* not i    */
@@ -277,6 +286,84 @@ mastermidibus::api_set_beats_per_minute (midibpm /*bpm*/)
     // no code
 }
 
+/**
+ *  Writes the messages batched in each output buss.  Called once at the end
+ *  of each output cycle, so that each port gets one Pm_Write() call.
+ */
+
+void
+mastermidibus::api_flush ()
+{
+    int count = m_outbus_array.count();
+    for (int b = 0; b < count; ++b)
+        m_outbus_array.bus(bussbyte(b))->flush();
+}
+
+/**
+ *  Enables the timestamps of the output events, if the output ports were
+ *  opened with a latency.
+ *
+ * \param flag
+ *      True to enable timed output.
+ *
+ * \return
+ *      Returns true if timed output is enabled.
+ */
+
+bool
+mastermidibus::api_timed_output (bool flag)
+{
+    m_deliver_ms = 0;
+    return flag && m_latency > 0;
+}
+
+/**
+ *  Converts the delivery time of the events written next from microtime()
+ *  to PortTime.  The conversion is made against the current time of each
+ *  clock, so that it does not depend on their origins.
+ *
+ * \param us
+ *      The delivery time in microseconds, or 0 to send as soon as possible.
+ */
+
+void
+mastermidibus::api_deliver_at (long us)
+{
+    if (us > 0 && m_latency > 0)
+    {
+        long ahead_us = us - microtime();
+        m_deliver_ms = Pt_Time() + PmTimestamp((ahead_us + 500) / 1000);
+    }
+    else
+        m_deliver_ms = 0;
+}
+
+/**
+ *  Provides the timestamp of the events written next.  PortMidi sends an
+ *  event at its timestamp plus the latency, so the latency is taken off
+ *  here, and an event is sent at its deadline.  An event that is due now,
+ *  or is late, is stamped so that it is sent right away.
+ *
+ * \return
+ *      Returns the PortTime timestamp, or 0 if the latency is 0, in which
+ *      case PortMidi ignores the timestamps.
+ */
+
+PmTimestamp
+mastermidibus::timestamp () const
+{
+    PmTimestamp result = 0;
+    if (m_latency > 0)
+    {
+        PmTimestamp now = Pt_Time();
+        result = m_deliver_ms > now ? m_deliver_ms : now ;
+        result -= m_latency;
+        if (result == 0)
+            result = -1;                /* 0 would mean "now plus latency" */
+    }
+    return result;
+}
+
 }           // namespace seq66
 
 /*
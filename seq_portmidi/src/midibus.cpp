@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2020-07-15
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This file provides a Windows-only implementation of the midibus class.
@@ -43,6 +43,7 @@
 
 #include "cfg/settings.hpp"             /* seq66::rc_settings               */
 #include "midi/event.hpp"               /* seq66::event and macros          */
+#include "mastermidibus_pm.hpp"         /* seq66::mastermidibus, PortMIDI   */
 #include "midibus_pm.hpp"               /* seq66::midibus for PortMIDI      */
 
 /*
@@ -58,18 +59,25 @@ namespace seq66
  *  There's a little confusion with the port ID parameter(s).  Also, the
  *  default values of queue, ppqn, bpm, and makevirtual are passed to the
  *  midibase constructor.  PortMidi does not support those constructs.
+ *
+ *  The master buss, if given, supplies the output latency and the
+ *  timestamps of the events.
  */
 
 midibus::midibus
 (
-    int index, int bus_id, int port_id, const std::string & clientname
+    int index, int bus_id, int port_id, const std::string & clientname,
+    const mastermidibus * master
 ) :
     midibase
     (
         rc().application_name(), "PortMidi", clientname, index,
         bus_id, port_id, port_id                /* PM uses 'queue' still */
     ),
-    m_pms           (nullptr)
+    m_pms           (nullptr),
+    m_master        (master),
+    m_batch         (),
+    m_batch_count   (0)
 {
     // Empty body
 }
@@ -122,6 +130,12 @@ midibus::api_poll_for_midi ()
  *  If there is an error, we set the clocking to e_clock::disable to indicate
  *  we should not bother to use the port.
  *
+ *  The port is opened with the same buffer size (100 messages) as before,
+ *  and with the latency of the master buss.  If the latency is 0, PortMidi
+ *  ignores the timestamps and sends each message right away.  Note that the
+ *  buffer size also sizes the SysEx and stream buffers of the Windows MME
+ *  driver.
+ *
  * \return
  *      Returns true if the output port was successfully opened.
  */
@@ -129,9 +143,10 @@ midibus::api_poll_for_midi ()
 bool
 midibus::api_init_out ()
 {
+    PmTimestamp latency = not_nullptr(m_master) ? m_master->latency() : 0 ;
     PmError err = Pm_OpenOutput
     (
-        &m_pms, queue_number(), NULL, 100, NULL, NULL, 0
+        &m_pms, queue_number(), NULL, 100, NULL, NULL, latency
     );
 
 #if defined USE_ERROR_TEST_CODE
@@ -173,8 +188,46 @@ midibus::api_init_in ()
 }
 
 /**
- *  Takes a native event, and encodes to a Windows message, and writes it to
- *  the queue.  It fills a small byte buffer, sets the MIDI channel, make a
+ *  Adds a message to the batch, stamped with the delivery time given by the
+ *  master buss.  If the batch is full, it is written first.
+ *
+ * \param message
+ *      The PortMidi message to send.
+ */
+
+void
+midibus::write (PmMessage message)
+{
+    if (not_nullptr(m_pms))
+    {
+        if (m_batch_count == c_batch_max)
+            api_flush();
+
+        PmEvent & pme = m_batch[m_batch_count++];
+        pme.message = message;
+        pme.timestamp = not_nullptr(m_master) ? m_master->timestamp() : 0 ;
+    }
+}
+
+/**
+ *  Writes the batched messages with one Pm_Write() call.
+ */
+
+void
+midibus::api_flush ()
+{
+    if (m_batch_count > 0)
+    {
+        PmError err = Pm_Write(m_pms, m_batch, m_batch_count);
+        m_batch_count = 0;
+        if (err != pmNoError)
+            errprintf("Pm_Write(): %s\n", Pm_GetErrorText(err));
+    }
+}
+
+/**
+ *  Takes a native event, and encodes to a Windows message, and adds it to
+ *  the batch.  It fills a small byte buffer, sets the MIDI channel, make a
  *  message of it, and writes the message.
  *
  * \question
@@ -196,11 +249,7 @@ midibus::api_play (event * e24, midibyte channel)
     buffer[0] = e24->get_status();
     buffer[0] += (channel & 0x0F);
     e24->get_data(buffer[1], buffer[2]);
-
-    PmEvent event;
-    event.timestamp = 0;
-    event.message = Pm_Message(buffer[0], buffer[1], buffer[2]);
-    /* PmError err = */ Pm_Write(m_pms, &event, 1);
+    write(Pm_Message(buffer[0], buffer[1], buffer[2]));
 }
 
 /**
@@ -218,20 +267,18 @@ midibus::api_play (event * e24, midibyte channel)
 void
 midibus::api_continue_from (midipulse /* tick */, midipulse beats)
 {
-    PmEvent event;
-    event.timestamp = 0;
-    event.message = Pm_Message(EVENT_MIDI_CONTINUE, 0, 0);
-    Pm_Write(m_pms, &event, 1);
-    event.message = Pm_Message
+    write(Pm_Message(EVENT_MIDI_CONTINUE, 0, 0));
+    write
     (
-        EVENT_MIDI_SONG_POS, (beats & 0x3F80 >> 7), (beats & 0x7F)
+        Pm_Message(EVENT_MIDI_SONG_POS, (beats & 0x3F80 >> 7), (beats & 0x7F))
     );
-    Pm_Write(m_pms, &event, 1);
+    api_flush();
 }
 
 /**
  *  Sets the MIDI clock a-runnin', if the clock type is not e_clock::off.
- *  This function is called by midibase::start().
+ *  This function is called by midibase::start().  Transport messages are
+ *  not part of an output cycle, so they are written right away.
  */
 
 void
@@ -239,10 +286,8 @@ midibus::api_start ()
 {
     if (not_nullptr(m_pms) && ! port_disabled())
     {
-        PmEvent event;
-        event.timestamp = 0;
-        event.message = Pm_Message(EVENT_MIDI_START, 0, 0);
-        Pm_Write(m_pms, &event, 1);
+        write(Pm_Message(EVENT_MIDI_START, 0, 0));
+        api_flush();
     }
 }
 
@@ -256,10 +301,8 @@ midibus::api_stop ()
 {
     if (not_nullptr(m_pms) && ! port_disabled())
     {
-        PmEvent event;
-        event.timestamp = 0;
-        event.message = Pm_Message(EVENT_MIDI_STOP, 0, 0);
-        Pm_Write(m_pms, &event, 1);
+        write(Pm_Message(EVENT_MIDI_STOP, 0, 0));
+        api_flush();
     }
 }
 
@@ -280,12 +323,7 @@ void
 midibus::api_clock (midipulse /* tick */)
 {
     if (not_nullptr(m_pms) && ! port_disabled())
-    {
-        PmEvent event;
-        event.timestamp = 0;                /* WHY NOT use 'tick' here? */
-        event.message = Pm_Message(EVENT_MIDI_CLOCK, 0, 0);
-        Pm_Write(m_pms, &event, 1);
-    }
+        write(Pm_Message(EVENT_MIDI_CLOCK, 0, 0));
 }
 
 }           // namespace seq66
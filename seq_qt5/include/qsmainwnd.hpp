@@ -27,7 +27,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2018-01-01
- * \updates       2020-11-13
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  The main window is known as the "Patterns window" or "Patterns
@@ -374,6 +374,7 @@ private slots:
     void show_open_list_dialog ();
     void showqsabout ();
     void showqsbuildinfo ();
+    void showplaystats ();
     void tabWidgetClicked (int newindex);
     void refresh ();                        /* redraw certain GUI elements  */
     void load_editor (int seqid);
@@ -24,7 +24,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2018-01-01
- * \updates       2020-11-19
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  The main window is known as the "Patterns window" or "Patterns
@@ -59,6 +59,7 @@
  *  Quit/Exit       quit()                  Normal Qt application closing
  *  Help            showqsabout()           Show Help About (version info)
  *                  showqsbuildinfo()       Show features of the build
+ *                  showplaystats()         Show output timing statistics
  *
  */
 
@@ -455,6 +456,11 @@ qsmainwnd::qsmainwnd
         ui->actionBuildInfo, SIGNAL(triggered(bool)),
         this, SLOT(showqsbuildinfo())
     );
+    connect
+    (
+        ui->actionPlayStats, SIGNAL(triggered(bool)),
+        this, SLOT(showplaystats())
+    );
 
     /*
      * Edit Menu.  First connect the preferences dialog to the main window's
@@ -1407,6 +1413,8 @@ qsmainwnd::refresh ()
     {
         save_file();
     }
+    if (session_stats())
+        (void) perf().report_play_stats();
 
     int active_screenset = int(perf().playscreen_number());
     std::string b = std::to_string(active_screenset);
@@ -1914,6 +1922,21 @@ qsmainwnd::showqsbuildinfo ()
         m_dialog_build_info->show();
 }
 
+/**
+ *  Shows the timing statistics of the output thread, as collected since the
+ *  application started.
+ */
+
+void
+qsmainwnd::showplaystats ()
+{
+    std::string report = perf().play_stats().report();
+    QMessageBox::information
+    (
+        this, tr("Playback Statistics"), QString::fromStdString(report)
+    );
+}
+
 /**
  *  Loads the older Kepler34 pattern editor (qseqeditframe) for the selected
  *  sequence into the "Edit" tab.
@@ -28,7 +28,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2019-02-09
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This mastermidibus module is the Linux (and, soon, JACK) version of the
@@ -115,6 +115,31 @@ protected:
         m_midi_master.api_flush();
     }
 
+    virtual bool api_engine (engine_callback cb, void * arg) override
+    {
+        return m_midi_master.api_engine(cb, arg);
+    }
+
+    virtual void api_frame_offset (int offset) override
+    {
+        m_midi_master.api_frame_offset(offset);
+    }
+
+    virtual bool api_timed_output (bool flag) override
+    {
+        return m_midi_master.api_timed_output(flag);
+    }
+
+    virtual void api_deliver_at (long us) override
+    {
+        m_midi_master.api_deliver_at(us);
+    }
+
+    virtual long api_input_time () override
+    {
+        return m_midi_master.api_input_time();
+    }
+
     virtual void api_port_start (mastermidibus & masterbus, int bus, int port)
     {
         m_midi_master.api_port_start(masterbus, bus, port);
@@ -27,7 +27,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2016-12-18
- * \updates       2017-06-02
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  The midi_alsa module is the Linux version of the midi_alsa module.
@@ -52,6 +52,7 @@
 namespace seq66
 {
     class event;
+    class midi_alsa_info;
     class midibus;
 
 /**
@@ -103,6 +104,13 @@ private:
 
     const std::string m_input_port_name;
 
+    /**
+     *  The ALSA information object, which schedules the output events.  Not
+     *  owned.  Null if the master information object is not an ALSA one.
+     */
+
+    const midi_alsa_info * m_alsa_info;
+
 public:
 
     /*
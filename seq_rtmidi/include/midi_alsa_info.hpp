@@ -9,7 +9,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2016-12-04
- * \updates       2020-08-04
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *    We need to have a way to get all of the ALSA information of
@@ -72,6 +72,44 @@ private:
 
     struct pollfd * m_poll_descriptors;
 
+    /**
+     *  True if the global queue has been started, for timed output or for
+     *  timestamped input.
+     */
+
+    bool m_queue_running;
+
+    /**
+     *  The microtime() value at which the real time of the running global
+     *  queue was 0.  Used to convert output deadlines to queue timestamps,
+     *  and input timestamps to microtime().  Measured again each time timed
+     *  output is enabled.
+     */
+
+    long m_queue_origin_us;
+
+    /**
+     *  The delivery time of the events being sent, in microtime()
+     *  microseconds, or 0 to send them directly.  Set by api_deliver_at().
+     */
+
+    long m_deliver_us;
+
+    /**
+     *  True if the input subscriptions ask ALSA to stamp each event with
+     *  the real time of the global queue at its arrival.  Set from the
+     *  "alsa_input_time" option, if the queue could be started.
+     */
+
+    bool m_input_stamped;
+
+    /**
+     *  The arrival time, in microtime() microseconds, of the event last
+     *  read by api_get_midi_event(), or 0 if it was not stamped.
+     */
+
+    long m_input_us;
+
 public:
 
     midi_alsa_info
@@ -101,11 +139,30 @@ public:
         mastermidibus & masterbus, int bus, int port
     ) override;
     virtual void api_flush () override;
+    virtual bool api_timed_output (bool flag) override;
+
+    virtual void api_deliver_at (long us) override
+    {
+        m_deliver_us = us;
+    }
+
+    virtual long api_input_time () override
+    {
+        return m_input_us;
+    }
+
+    bool input_stamped () const
+    {
+        return m_input_stamped;
+    }
+
+    void schedule (snd_seq_event_t & ev) const;
 
 private:
 
     virtual int get_all_port_info () override;
 
+    bool start_queue ();
     void get_poll_descriptors ();
     void remove_poll_descriptors ();
     bool check_port_type (snd_seq_port_info_t * pinfo) const;
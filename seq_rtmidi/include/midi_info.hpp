@@ -9,7 +9,7 @@
  * \library       seq66 application
  * \author        Gary P. Scavone; refactoring by Chris Ahlstrom
  * \date          2016-12-05
- * \updates       2020-08-04
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *      We need to have a way to get all of the API information from each
@@ -401,6 +401,54 @@ public:
         // Empty body
     }
 
+    /**
+     *  Used only in the midi_jack_info class, which can call the engine
+     *  function from its process callback.
+     */
+
+    virtual bool api_engine (rtmidi_engine_t /* cb */, void * /* arg */)
+    {
+        return false;
+    }
+
+    /**
+     *  Used only in the midi_jack_info class.
+     */
+
+    virtual void api_frame_offset (int /* offset */)
+    {
+        // Empty body
+    }
+
+    /**
+     *  Used only in the midi_alsa_info class, which can deliver events
+     *  through a timestamped ALSA queue.
+     */
+
+    virtual bool api_timed_output (bool /* flag */)
+    {
+        return false;
+    }
+
+    /**
+     *  Used only in the midi_alsa_info class.
+     */
+
+    virtual void api_deliver_at (long /* us */)
+    {
+        // Empty body
+    }
+
+    /**
+     *  Used only in the midi_alsa_info class.  Returns the arrival time of
+     *  the last input event, or 0 if the API did not stamp it.
+     */
+
+    virtual long api_input_time ()
+    {
+        return 0;
+    }
+
     virtual bool api_get_midi_event (event * inev) = 0;
     virtual int api_poll_for_midi () = 0;       /* disposable??? */
     virtual void api_flush () = 0;
@@ -9,7 +9,7 @@
  * \library       seq66 application
  * \author        Gary P. Scavone; severe refactoring by Chris Ahlstrom
  * \date          2016-11-14
- * \updates       2019-12-11
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *    In this refactoring, we've stripped out most of the original RtMidi
@@ -183,7 +183,7 @@ protected:
 private:
 
     void send_byte (midibyte evbyte);
-    bool send_message (const midi_message & message);
+    bool send_message (const midibyte * data, int nbytes, int offset = -1);
     bool set_virtual_name (int portid, const std::string & portname);
 
 };          // class midi_jack
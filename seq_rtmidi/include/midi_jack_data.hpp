@@ -9,7 +9,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2017-01-02
- * \updates       2019-02-09
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *  GitHub issue #165: enabled a build and run with no JACK support.
@@ -29,6 +29,19 @@
 namespace seq66
 {
 
+/**
+ *  Precedes each output message in the m_jack_buffsize ring-buffer.  The
+ *  bytes of the message are in the m_jack_buffmessage ring-buffer.  The frame
+ *  is the JACK frame time at which the message is meant to sound; the
+ *  process callback turns it into an offset into the current period.
+ */
+
+struct midi_jack_header
+{
+    jack_nframes_t mjh_frame;   /**< Target frame time of the message.      */
+    int mjh_size;               /**< Number of bytes in the message.        */
+};
+
 /**
  *  Contains the JACK MIDI API data as a kind of scratchpad for this object.
  *  This guy needs a constructor taking parameters for an rtmidi_in_data
@@ -57,8 +70,9 @@ struct midi_jack_data
     jack_port_t * m_jack_port;
 
     /**
-     *  Holds the size of data for communicating between the client
-     *  ring-buffer and the JACK port's internal buffer.
+     *  Holds the size and target frame (a midi_jack_header) of each message
+     *  for communicating between the client ring-buffer and the JACK port's
+     *  internal buffer.
      */
 
     jack_ringbuffer_t * m_jack_buffsize;
@@ -70,6 +84,29 @@ struct midi_jack_data
 
     jack_ringbuffer_t * m_jack_buffmessage;
 
+    /**
+     *  The number of bytes of the first message in the ring-buffers that
+     *  the process callback has already written to the port buffer.  Non-zero
+     *  only while a message too large for one period's buffer, such as a
+     *  SysEx dump, is being sent over several process cycles.
+     */
+
+    size_t m_jack_partial;
+
+    /**
+     *  The index of this port in the input or output table of the
+     *  midi_jack_info object, or -1 if it is not in a table.
+     */
+
+    int m_jack_slot;
+
+    /**
+     *  Set by the output process callback if it wrote to the port buffer in
+     *  the current period.
+     */
+
+    bool m_jack_written;
+
     /**
      *  The last time-stamp obtained.  Use for calculating the delta time, I
      *  would imagine.
@@ -93,6 +130,9 @@ struct midi_jack_data
         m_jack_port         (nullptr),
         m_jack_buffsize     (nullptr),
         m_jack_buffmessage  (nullptr),
+        m_jack_partial      (0),
+        m_jack_slot         (-1),
+        m_jack_written      (false),
         m_jack_lasttime     (0),
         m_jack_rtmidiin     (nullptr)
     {
@@ -9,7 +9,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2017-01-01
- * \updates       2019-10-18
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *    We need to have a way to get all of the JACK information of
@@ -26,6 +26,9 @@
 #include "midi_info.hpp"                /* seq66::midi_port_info etc.       */
 #include "midi/midibus.hpp"             /* seq66::midibus                   */
 
+#include <atomic>                       /* std::atomic<> engine pointer     */
+#include <cstdint>                      /* std::uint64_t port bitmasks      */
+#include <semaphore.h>                  /* sem_t, sem_post(), etc.          */
 #include <jack/jack.h>
 #include "midi_jack_data.hpp"           /* seq66::midi_jack_data            */
 
@@ -51,14 +54,71 @@ private:
 
     using portlist = std::vector<midi_jack *>;
 
+    /**
+     *  The most ports the process callback can service, enough for the
+     *  maximum number of input and output busses.
+     */
+
+    static const int c_jack_ports_max = 2 * c_busscount_max;
+
+    /**
+     *  The number of 64-bit words in a bitmask of the output ports.
+     */
+
+    static const int c_jack_mask_words = (c_jack_ports_max + 63) / 64;
+
     /**
      *  Holds the port data.  Not for use with the multi-client option.
-     *  This list is iterated in the input and output portions of the JACK
-     *  process callback.  This class does not own the pointers.
+     *  This list is used outside of the JACK process callback.  This class
+     *  does not own the pointers.
      */
 
     portlist m_jack_ports;
 
+    /**
+     *  The data of the input ports, and of the output ports, in contiguous
+     *  tables that the process callback walks without touching the
+     *  midi_jack objects.  An entry is filled before its count is
+     *  published, and entries are never removed.
+     */
+
+    midi_jack_data * m_input_table[c_jack_ports_max];
+    midi_jack_data * m_output_table[c_jack_ports_max];
+    std::atomic<int> m_input_count;
+    std::atomic<int> m_output_count;
+
+    /**
+     *  One bit for each output port that has messages queued.  Set by
+     *  midi_jack::send_message() and cleared by the process callback, so
+     *  that idle ports cost nothing in a period.
+     */
+
+    std::atomic<std::uint64_t> m_output_pending[c_jack_mask_words];
+
+    /**
+     *  One bit for each output port whose buffer was written in the last
+     *  period; that buffer must still be cleared once.  Used only by the
+     *  process callback.
+     */
+
+    std::uint64_t m_output_dirty[c_jack_mask_words];
+
+    /**
+     *  The process callback indexes m_output_table with the bit numbers of
+     *  the mask words, so every bit must name a table entry, and every
+     *  entry must have a bit.
+     */
+
+    static_assert
+    (
+        c_busscount_max % 64 == 0, "c_busscount_max must be a multiple of 64"
+    );
+    static_assert
+    (
+        c_jack_mask_words * 64 == c_jack_ports_max,
+        "output port masks must cover m_output_table exactly"
+    );
+
     /**
      *  Holds the JACK sequencer client pointer so that it can be used
      *  by the midibus objects.  This is actually an opaque pointer; there is
@@ -78,6 +138,46 @@ private:
 
     jack_client_t * m_jack_client_2;
 
+    /**
+     *  Posted by the JACK process callback when it has queued input, so that
+     *  api_poll_for_midi() can block until there is input, instead of
+     *  sleeping and polling.  A POSIX semaphore is used because sem_post()
+     *  neither locks nor allocates, so it is safe in the real-time thread.
+     */
+
+    sem_t m_input_signal;
+
+    /**
+     *  True if m_input_signal was created.  If not, api_poll_for_midi()
+     *  falls back to sleeping.
+     */
+
+    bool m_input_signal_ok;
+
+    /**
+     *  The engine function called at the start of each process callback,
+     *  before the ports are serviced, so that the sequencer can render the
+     *  events of the period into the output ports.  Null (the default) if
+     *  the performer's output thread drives playback.  Set by api_engine().
+     */
+
+    std::atomic<rtmidi_engine_t> m_engine;
+
+    /**
+     *  The first parameter of the engine function.  Set before m_engine is
+     *  published.
+     */
+
+    void * m_engine_arg;
+
+    /**
+     *  The offset, in frames from the start of the current period, at which
+     *  the events sent next are placed.  Set through api_frame_offset() by
+     *  the engine while it runs in the process callback; -1 otherwise.
+     */
+
+    int m_frame_offset;
+
 public:
 
     midi_jack_info
@@ -108,6 +208,33 @@ public:
         mastermidibus & masterbus, int bus, int port
     ) override;
     virtual void api_flush () override;
+    virtual bool api_engine (rtmidi_engine_t cb, void * arg) override;
+
+    virtual void api_frame_offset (int offset) override
+    {
+        m_frame_offset = offset;
+    }
+
+    /**
+     * \getter m_frame_offset
+     *      Used by midi_jack::api_play() to place an event in the period.
+     */
+
+    int frame_offset () const
+    {
+        return m_frame_offset;
+    }
+
+    /**
+     *  True if the process callback drives the sequencer.  Then the output
+     *  thread must not wait for the process callback while it holds the
+     *  master buss, which the engine also locks.
+     */
+
+    bool engine_active () const
+    {
+        return m_engine.load() != nullptr;
+    }
 
 private:
 
@@ -125,6 +252,20 @@ private:
 
     jack_client_t * connect ();
     void disconnect ();
+    int input_count ();
+    bool wait_for_input (int ms);
+
+    /**
+     *  Wakes up the thread waiting in api_poll_for_midi().  Called from the
+     *  JACK process callback.
+     */
+
+    void signal_input ()
+    {
+        if (m_input_signal_ok)
+            (void) sem_post(&m_input_signal);
+    }
+
     void extract_names
     (
         const std::string & fullname,
@@ -134,14 +275,22 @@ private:
 
 private:
 
+    bool add (midi_jack & mj);
+
     /**
-     *  Adds a pointer to a JACK port.
+     *  Flags an output port as having messages for the process callback.
+     *
+     * \param slot
+     *      The index of the port in m_output_table.  Ignored if negative.
      */
 
-    bool add (midi_jack & mj)
+    void output_pending (int slot)
     {
-        m_jack_ports.push_back(&mj);
-        return true;
+        if (slot >= 0)
+        {
+            std::uint64_t bit = std::uint64_t(1) << (slot % 64);
+            m_output_pending[slot / 64].fetch_or(bit);
+        }
     }
 
 };          // midi_jack_info
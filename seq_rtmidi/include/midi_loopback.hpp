@@ -0,0 +1,227 @@
+#if ! defined SEQ66_MIDI_LOOPBACK_HPP
+#define SEQ66_MIDI_LOOPBACK_HPP
+
+/**
+ * \file          midi_loopback.hpp
+ *
+ *    An in-memory MIDI API for testing and benchmarking.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       See the rtexmidi.lic file.  Too big for a header file.
+ *
+ *    The loopback API is a third rtmidi API, next to ALSA and JACK.  It
+ *    needs no sequencer or server, so the whole performer, including its
+ *    output and input threads, can run on a headless machine.
+ *
+ *    -   Each output port records what is sent to it, with a microtime()
+ *        timestamp, in a lock-free single-producer/single-consumer ring.
+ *        The producer is the master buss, which already serializes output.
+ *        The consumer is the test or benchmark, via loopback_read().
+ *    -   Each input port has a ring of its own, filled by loopback_inject().
+ *        An injected message can be given a delay, so that a script of
+ *        timed input can be queued up front.  The input thread sees a
+ *        message only when it is due.  Messages for one port must be
+ *        injected in time order.
+ *
+ *    SysEx is not recorded or injected.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <vector>                       /* std::vector                      */
+
+#include "midi_api.hpp"                 /* seq66::midi_api                  */
+#include "midi_loopback_info.hpp"       /* seq66::midi_loopback_info        */
+
+/*
+ * Do not document the namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+    class midibus;
+
+/**
+ *  The number of messages each loopback port can hold before messages are
+ *  dropped.  Must be a power of 2.
+ */
+
+const unsigned c_loopback_ring_size = 8192;
+
+/**
+ *  A message sent to or injected into a loopback port.
+ */
+
+struct loopback_message
+{
+    long lm_timestamp;          /**< microtime() when sent, or when due.    */
+    int lm_count;               /**< The number of bytes, 1 to 3.           */
+    midibyte lm_bytes[3];       /**< The status and data bytes.             */
+};
+
+/**
+ *  A fixed-size lock-free ring for one producer and one consumer.  The
+ *  indices run freely; their difference is the number of messages held.
+ */
+
+class loopback_ring
+{
+
+private:
+
+    std::vector<loopback_message> m_ring;
+    unsigned m_mask;
+    std::atomic<unsigned> m_head;       /**< Next slot to write.            */
+    std::atomic<unsigned> m_tail;       /**< Next slot to read.             */
+    std::atomic<unsigned> m_dropped;    /**< Messages lost to a full ring.  */
+
+public:
+
+    loopback_ring (unsigned size = c_loopback_ring_size);
+
+    bool push (const loopback_message & msg);
+    bool front (loopback_message & msg) const;
+    bool pop (loopback_message & msg);
+
+    int count () const
+    {
+        return int(m_head.load(std::memory_order_acquire) -
+            m_tail.load(std::memory_order_acquire));
+    }
+
+    unsigned dropped () const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+};          // class loopback_ring
+
+/**
+ *  The base class for loopback input and output ports.
+ */
+
+class midi_loopback : public midi_api
+{
+
+    friend class midi_loopback_info;
+
+protected:
+
+    /**
+     *  The master information object, which registers this port.
+     */
+
+    midi_loopback_info & m_loopback_info;
+
+    /**
+     *  Sent messages for an output port, injected messages for an input
+     *  port.
+     */
+
+    loopback_ring m_ring;
+
+private:
+
+    midi_loopback ();
+
+public:
+
+    midi_loopback (midibus & parentbus, midi_info & masterinfo);
+    virtual ~midi_loopback ();
+
+    loopback_ring & ring ()
+    {
+        return m_ring;
+    }
+
+protected:
+
+    virtual bool api_init_out () override;
+    virtual bool api_init_in () override;
+    virtual bool api_init_out_sub () override;
+    virtual bool api_init_in_sub () override;
+    virtual bool api_deinit_in () override;
+
+    virtual bool api_get_midi_event (event *) override
+    {
+        return false;
+    }
+
+    virtual int api_poll_for_midi () override
+    {
+        return 0;
+    }
+
+    virtual void api_play (event * e24, midibyte channel) override;
+    virtual void api_sysex (event * e24) override;
+    virtual void api_flush () override;
+    virtual void api_continue_from (midipulse tick, midipulse beats) override;
+    virtual void api_start () override;
+    virtual void api_stop () override;
+    virtual void api_clock (midipulse tick) override;
+    virtual void api_set_ppqn (int ppqn) override;
+    virtual void api_set_beats_per_minute (midibpm bpm) override;
+
+private:
+
+    void send_byte (midibyte evbyte);
+
+};          // class midi_loopback
+
+/**
+ *  A loopback input port.  The input thread reads the injected messages.
+ */
+
+class midi_in_loopback final : public midi_loopback
+{
+
+public:
+
+    midi_in_loopback (midibus & parentbus, midi_info & masterinfo);
+    virtual ~midi_in_loopback ();
+
+    virtual int api_poll_for_midi () override;
+    virtual bool api_get_midi_event (event *) override;
+
+};          // class midi_in_loopback
+
+/**
+ *  A loopback output port.  The test or benchmark reads what was sent.
+ */
+
+class midi_out_loopback final : public midi_loopback
+{
+
+public:
+
+    midi_out_loopback (midibus & parentbus, midi_info & masterinfo);
+    virtual ~midi_out_loopback ();
+
+};          // class midi_out_loopback
+
+/*
+ * Free functions in the seq66 namespace, for test and benchmark code.
+ */
+
+extern bool loopback_read (int port, loopback_message & msg);
+extern int loopback_pending (int port);
+extern unsigned loopback_dropped (int port);
+extern bool loopback_inject
+(
+    int port,
+    const midibyte * bytes,
+    int count,
+    long delay_us = 0
+);
+
+}           // namespace seq66
+
+#endif      // SEQ66_MIDI_LOOPBACK_HPP
+
+/*
+ * midi_loopback.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
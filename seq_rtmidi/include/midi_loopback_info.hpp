@@ -0,0 +1,89 @@
+#if ! defined SEQ66_MIDI_LOOPBACK_INFO_HPP
+#define SEQ66_MIDI_LOOPBACK_INFO_HPP
+
+/**
+ * \file          midi_loopback_info.hpp
+ *
+ *    A class for enumerating the ports of the in-memory loopback MIDI API.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       See the rtexmidi.lic file.  Too big for a header file.
+ *
+ *    The loopback API needs no system services.  Its "system" consists of
+ *    the number of input and output ports given by the "-o loopback=i:o"
+ *    option.  See the midi_loopback module.
+ */
+
+#include <vector>                       /* std::vector                      */
+
+#include "mastermidibus_rm.hpp"
+#include "midi_info.hpp"                /* seq66::midi_port_info etc.       */
+#include "midi/midibus.hpp"             /* seq66::midibus                   */
+
+/*
+ * Do not document the namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+    class mastermidibus;
+    class midi_loopback;
+
+/**
+ *  The class for handling loopback MIDI port enumeration.
+ */
+
+class midi_loopback_info final : public midi_info
+{
+    friend class midi_loopback;
+
+private:
+
+    using portlist = std::vector<midi_loopback *>;
+
+    /**
+     *  Holds the ports that have been created, so that test and benchmark
+     *  code can find them by direction and index.  This class does not own
+     *  the pointers.
+     */
+
+    portlist m_loopback_ports;
+
+public:
+
+    midi_loopback_info
+    (
+        const std::string & appname,
+        int ppqn    = SEQ66_DEFAULT_PPQN,       /* 192    */
+        midibpm bpm = SEQ66_DEFAULT_BPM         /* 120.0  */
+    );
+    virtual ~midi_loopback_info ();
+
+    static midi_loopback_info * instance ();
+    midi_loopback * find_port (bool input, int index);
+
+    virtual bool api_get_midi_event (event * inev) override;
+    virtual int api_poll_for_midi () override;
+    virtual void api_flush () override;
+
+private:
+
+    virtual int get_all_port_info () override;
+
+    bool add (midi_loopback & ml);
+    void remove (midi_loopback & ml);
+
+};          // midi_loopback_info
+
+}           // namespace seq66
+
+#endif      // SEQ66_MIDI_LOOPBACK_INFO_HPP
+
+/*
+ * midi_loopback_info.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
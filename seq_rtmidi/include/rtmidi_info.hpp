@@ -9,7 +9,7 @@
  * \library       seq66 application
  * \author        Refactoring by Chris Ahlstrom
  * \date          2016-12-08
- * \updates       2017-03-21
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  * \license       GNU GPLv2 or above
  *
@@ -273,6 +273,31 @@ public:
         return get_api_info()->api_poll_for_midi();
     }
 
+    bool api_engine (rtmidi_engine_t cb, void * arg)
+    {
+        return get_api_info()->api_engine(cb, arg);
+    }
+
+    void api_frame_offset (int offset)
+    {
+        get_api_info()->api_frame_offset(offset);
+    }
+
+    bool api_timed_output (bool flag)
+    {
+        return get_api_info()->api_timed_output(flag);
+    }
+
+    void api_deliver_at (long us)
+    {
+        get_api_info()->api_deliver_at(us);
+    }
+
+    long api_input_time ()
+    {
+        return get_api_info()->api_input_time();
+    }
+
     /**
      *  Returns a list of all the ports as an ASCII string.
      */
@@ -9,7 +9,7 @@
  * \library       seq66 application
  * \author        Gary P. Scavone; severe refactoring by Chris Ahlstrom
  * \date          2016-11-20
- * \updates       2019-02-09
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *  The lack of hiding of these types within a class is a little to be
@@ -17,6 +17,7 @@
  *  refactor and partition, and slightly easier to read.
  */
 
+#include <atomic>                           /* std::atomic<> for midi_queue */
 #include <string>                           /* std::string                  */
 #include <vector>                           /* std::vector container        */
 
@@ -41,10 +42,26 @@
 #define SEQ66_NO_INDEX          (-1)        /* good values start at 0       */
 
 /**
- *  Default size of the MIDI queue.
+ *  Default size of the MIDI queue, in records.  A record is small and holds
+ *  no pointers, so the queue can be a lot deeper than it was when it held
+ *  midi_message objects.
  */
 
-#define SEQ66_DEFAULT_QUEUE_SIZE    100
+#define SEQ66_DEFAULT_QUEUE_SIZE    1024
+
+/**
+ *  Default size of the spill area of the MIDI queue, in bytes.  It holds the
+ *  SysEx messages (and any other message) too long to fit in a record.
+ */
+
+#define SEQ66_DEFAULT_SPILL_SIZE    65536
+
+/**
+ *  The number of message bytes that a midi_record holds itself.  Enough for
+ *  any channel message or system common message.
+ */
+
+#define SEQ66_MIDI_RECORD_BYTES     8
 
 /*
  * Do not document the namespace; it breaks Doxygen.
@@ -64,6 +81,7 @@ enum rtmidi_api
     RTMIDI_API_UNSPECIFIED,     /**< Search for a working compiled API.     */
     RTMIDI_API_LINUX_ALSA,      /**< Advanced Linux Sound Architecture API. */
     RTMIDI_API_UNIX_JACK,       /**< JACK Low-Latency MIDI Server API.      */
+    RTMIDI_API_LOOPBACK,        /**< In-memory ports, for testing.          */
 
 #if defined USE_RTMIDI_API_ALL
 
@@ -183,6 +201,16 @@ public:
         return m_bytes.size() > 0 ? event::is_sysex_msg(m_bytes[0]) : false ;
     }
 
+    /**
+     *  Empties the message, but keeps its storage, so that a message object
+     *  can be reused without allocating.
+     */
+
+    void clear ()
+    {
+        m_bytes.clear();
+    }
+
     void show () const;
 
 };          // class midi_message
@@ -201,9 +229,51 @@ using rtmidi_callback_t = void (*)
 );
 
 /**
- *  Provides a queue of midi_message structures.  This entity used to be a
- *  plain structure nested in the midi_in_api class.  We made it a class to
+ *  The engine function called once per period by a process callback (only
+ *  JACK's at present), with the period length and frame rate.  Matches
+ *  seq66::mastermidibase::engine_callback.
+ */
+
+using rtmidi_engine_t = void (*)
+(
+    void * userdata,
+    unsigned nframes,
+    unsigned rate
+);
+
+/**
+ *  One message in the midi_queue.  It is plain data, so that the producer
+ *  (e.g. the JACK process callback) can fill it without allocating.  Short
+ *  messages are held in mr_bytes.  Longer messages are copied to the spill
+ *  area of the queue, starting at mr_spill.
+ */
+
+struct midi_record
+{
+    double mr_timestamp;        /**< Timestamp of the message.              */
+    unsigned mr_count;          /**< Number of bytes in the message.        */
+    unsigned mr_spill;          /**< Spill offset, if not in mr_bytes.      */
+    unsigned mr_spill_end;      /**< Spill counter after this message.      */
+    midibyte mr_bytes[SEQ66_MIDI_RECORD_BYTES];     /**< Short message.     */
+};
+
+/**
+ *  Provides a queue of MIDI messages.  This entity used to be a plain
+ *  structure nested in the midi_in_api class.  We made it a class to
  *  encapsulate some common operations to save a burden on the callers.
+ *
+ *  The queue is a preallocated ring of midi_record structures plus a
+ *  preallocated byte ring, the spill area, for long messages.  Adding a
+ *  message neither allocates nor locks, so it can be done in a real-time
+ *  callback.
+ *
+ *  There must be exactly one producer thread (the one calling add()) and one
+ *  consumer thread (the one calling front(), bytes(), and pop()).  The
+ *  producer owns m_back and m_spill_back, the consumer owns m_front and
+ *  m_spill_front.  Each side publishes its counter with a release store, and
+ *  reads the other side's counter with an acquire load, so that a record (and
+ *  its spill bytes) is complete before the consumer can see it, and is no
+ *  longer in use before the producer can reuse it.
  */
 
 class midi_queue
@@ -211,41 +281,107 @@ class midi_queue
 
 private:
 
-    unsigned m_front;
-    unsigned m_back;
-    unsigned m_size;
+    /**
+     *  The read and write counters.  They only grow (and wrap around at
+     *  2^32); the index of a record is its counter modulo m_ring_size, and
+     *  the number of records queued is m_back - m_front.
+     */
+
+    std::atomic<unsigned> m_front;
+    std::atomic<unsigned> m_back;
     unsigned m_ring_size;
-    midi_message * m_ring;
+    midi_record * m_ring;
+
+    /**
+     *  The spill area.  m_spill_front and m_spill_back are byte counters
+     *  that work like m_front and m_back; the offset of a byte in the area
+     *  is its counter modulo m_spill_size.  pop() moves the front to the end
+     *  of the popped message.
+     */
+
+    std::atomic<unsigned> m_spill_front;
+    unsigned m_spill_back;
+    unsigned m_spill_size;
+    midibyte * m_spill;
+
+    /**
+     *  Counts the messages dropped because the queue was full.  The producer
+     *  cannot report them itself, since printing allocates.
+     */
+
+    std::atomic<unsigned> m_dropped;
 
 public:
 
     midi_queue ();
     ~midi_queue ();
 
+    midi_queue (const midi_queue &) = delete;
+    midi_queue & operator = (const midi_queue &) = delete;
+
     bool empty () const
     {
-        return m_size == 0;
+        return count() == 0;
     }
 
     int count () const
     {
-        return int(m_size);
+        return int
+        (
+            m_back.load(std::memory_order_acquire) -
+            m_front.load(std::memory_order_acquire)
+        );
     }
 
     bool full () const
     {
-        return m_size == m_ring_size;
+        return unsigned(count()) >= m_ring_size;
     }
 
-    const midi_message & front () const
+    /**
+     *  The number of messages ever added.  Can be compared before and after
+     *  a call to the producer, to see if it added anything.
+     */
+
+    unsigned added () const
+    {
+        return m_back.load(std::memory_order_acquire);
+    }
+
+    /**
+     *  Gets the number of messages dropped since the last call, and restarts
+     *  the count.  For the consumer, which can report it.
+     */
+
+    unsigned take_dropped ()
+    {
+        return m_dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    const midi_record & front () const
+    {
+        return m_ring[m_front.load(std::memory_order_relaxed) % m_ring_size];
+    }
+
+    /**
+     *  Gets the bytes of a record obtained from front().
+     */
+
+    const midibyte * bytes (const midi_record & mr) const
     {
-        return m_ring[m_front];
+        return mr.mr_count > SEQ66_MIDI_RECORD_BYTES ?
+            &m_spill[mr.mr_spill] : &mr.mr_bytes[0] ;
     }
 
+    bool add (const midibyte * mbytes, int count, double timestamp);
     bool add (const midi_message & mmsg);
     void pop ();
     midi_message pop_front ();
-    void allocate (unsigned queuesize = SEQ66_DEFAULT_QUEUE_SIZE);
+    void allocate
+    (
+        unsigned queuesize = SEQ66_DEFAULT_QUEUE_SIZE,
+        unsigned spillsize = SEQ66_DEFAULT_SPILL_SIZE
+    );
     void deallocate ();
 
 };          // class midi_queue
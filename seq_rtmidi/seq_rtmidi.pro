@@ -47,6 +47,8 @@ HEADERS += \
  include/midi_jack.hpp \
  include/midi_jack_data.hpp \
  include/midi_jack_info.hpp \
+ include/midi_loopback.hpp \
+ include/midi_loopback_info.hpp \
  include/midi_probe.hpp \
  include/rterror.hpp \
  include/rtmidi.hpp \
@@ -65,6 +67,8 @@ SOURCES += \
  src/midi_info.cpp \
  src/midi_jack.cpp \
  src/midi_jack_info.cpp \
+ src/midi_loopback.cpp \
+ src/midi_loopback_info.cpp \
  src/midi_probe.cpp \
  src/rtmidi.cpp \
  src/rtmidi_info.cpp \
@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2020-10-25
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This file provides a Windows-only implementation of the mastermidibus
@@ -69,7 +69,9 @@ mastermidibus::mastermidibus (int ppqn, midibpm bpm)
     mastermidibase      (ppqn, bpm),
     m_midi_master
     (
-        rc().with_jack_midi() ? RTMIDI_API_UNIX_JACK : RTMIDI_API_LINUX_ALSA,
+        rc().with_loopback_midi() ? RTMIDI_API_LOOPBACK :
+            rc().with_jack_midi() ? RTMIDI_API_UNIX_JACK :
+                RTMIDI_API_LINUX_ALSA,
         rc().application_name(), ppqn, bpm
     ),
     m_use_jack_polling  (rc().with_jack_midi())
@@ -280,7 +282,17 @@ mastermidibus::activate ()
  *  primitive poll, which exits when some data is obtained, or sleeps a
  *  millisecond in note data is obtained.
  *
- *  For JACK polling, call the base-class implementation:
+ *  For JACK polling, when the JACK API is the one in use, the call sequence
+ *  is:
+ *
+ *      -   rtmidi_info::api_poll_for_midi()
+ *      -   midi_jack_info::api_poll_for_midi(), which blocks until the JACK
+ *          process callback has queued input (or a short timeout expires),
+ *          and returns the number of messages queued on the enabled input
+ *          ports.  The events are then fetched via the input busses.
+ *
+ *  If JACK polling was requested but JACK could not be used, call the
+ *  base-class implementation:
  *
  *      -   mastermidibase::api_poll_for_midi()
  *      -   busarray::poll_for_midi()
@@ -309,7 +321,12 @@ mastermidibus::api_poll_for_midi ()
 {
 #if defined SEQ66_USE_JACK_POLLING_FLAG
     if (m_use_jack_polling)                             /* run-time option  */
-        return mastermidibase::api_poll_for_midi();     /* inbus-array poll */
+    {
+        if (rtmidi_info::selected_api() == RTMIDI_API_UNIX_JACK)
+            return m_midi_master.api_poll_for_midi();   /* waits for JACK   */
+        else
+            return mastermidibase::api_poll_for_midi(); /* inbus-array poll */
+    }
     else
         return m_midi_master.api_poll_for_midi();       /* ALSA poll        */
 #else
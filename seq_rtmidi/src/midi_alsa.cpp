@@ -25,7 +25,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2016-12-18
- * \updates       2020-08-02
+ * \updates       2020-11-24
  * \license       GNU GPLv2 or above
  *
  *  This file provides a Linux-only implementation of ALSA MIDI support.
@@ -89,6 +89,7 @@
 #include "midi/event.hpp"               /* seq66::event (MIDI event)        */
 #include "midibus_rm.hpp"               /* seq66::midibus for rtmidi        */
 #include "midi_alsa.hpp"                /* seq66::midi_alsa for ALSA        */
+#include "midi_alsa_info.hpp"           /* seq66::midi_alsa_info            */
 #include "midi_info.hpp"                /* seq66::midi_info                 */
 #include "util/calculations.hpp"        /* clock_ticks_from_ppqn()          */
 
@@ -142,7 +143,8 @@ midi_alsa::midi_alsa (midibus & parentbus, midi_info & masterinfo)
     m_dest_addr_port    (parentbus.port_id()),
     m_local_addr_client (snd_seq_client_id(m_seq)),     /* our client ID    */
     m_local_addr_port   (-1),
-    m_input_port_name   (rc().app_client_name() + " in")
+    m_input_port_name   (rc().app_client_name() + " in"),
+    m_alsa_info         (dynamic_cast<const midi_alsa_info *>(&masterinfo))
 {
     set_bus_id(m_local_addr_client);
     set_name(SEQ66_CLIENT_NAME, bus_name(), port_name());
@@ -291,12 +293,16 @@ midi_alsa::api_init_in ()
     snd_seq_port_subscribe_set_dest(subs, &dest);       /* local              */
 
     /*
-     * Use the master queue, and get ticks, then subscribe.
+     * Use the master queue, and get ticks, then subscribe.  If the queue is
+     * running for input timestamps, get its real time instead, so that the
+     * arrival time of each event can be converted to microtime().
      */
 
     int queue = parent_bus().queue_number();
     snd_seq_port_subscribe_set_queue(subs, queue);
     snd_seq_port_subscribe_set_time_update(subs, 1);
+    if (not_nullptr(m_alsa_info) && m_alsa_info->input_stamped())
+        snd_seq_port_subscribe_set_time_real(subs, 1);
     result = snd_seq_subscribe_port(m_seq, subs);
     if (result < 0)
     {
@@ -446,6 +452,25 @@ midi_alsa::api_init_in_sub ()
         set_virtual_name(result, portname);
         set_port_open();
 
+        /*
+         * Other clients connect to a virtual port, so the timestamps are
+         * requested on the port itself.  See api_init_in().
+         */
+
+        if (not_nullptr(m_alsa_info) && m_alsa_info->input_stamped())
+        {
+            snd_seq_port_info_t * pinfo;
+            snd_seq_port_info_alloca(&pinfo);
+            if (snd_seq_get_port_info(m_seq, result, pinfo) >= 0)
+            {
+                int queue = parent_bus().queue_number();
+                snd_seq_port_info_set_timestamping(pinfo, 1);
+                snd_seq_port_info_set_timestamp_real(pinfo, 1);
+                snd_seq_port_info_set_timestamp_queue(pinfo, queue);
+                (void) snd_seq_set_port_info(m_seq, result, pinfo);
+            }
+        }
+
 #if defined SEQ66_SHOW_API_CALLS
         printf("virtual WRITE/input port 'seq66 in' created; port %d\n", result);
 #endif
@@ -548,18 +573,78 @@ midi_in_alsa::api_poll_for_midi ()
 #endif  // defined USE_MIDI_ALSA_POLL
 
 /**
- *  Defines the size of the MIDI event buffer, which should be large enough to
- *  accomodate the largest MIDI message to be encoded.
- *  A local define for visibility.
+ *  Fills in an ALSA sequencer event from the bytes of a channel message.
+ *  This replaces the snd_midi_event_t encoder, which had to be created and
+ *  freed for each event.
+ *
+ * \param ev
+ *      The cleared event to be filled in.
+ *
+ * \param status
+ *      The status byte, including the channel.
+ *
+ * \param d0
+ *      The first data byte.
+ *
+ * \param d1
+ *      The second data byte, if applicable.
+ *
+ * \return
+ *      Returns false if the status is not that of a channel message.
  */
 
-#define SEQ66_MIDI_EVENT_SIZE_MAX   10
+static bool
+set_channel_event
+(
+    snd_seq_event_t & ev, midibyte status, midibyte d0, midibyte d1
+)
+{
+    bool result = true;
+    int channel = status & 0x0F;
+    switch (status & 0xF0)
+    {
+    case EVENT_NOTE_OFF:
+        snd_seq_ev_set_noteoff(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_NOTE_ON:
+        snd_seq_ev_set_noteon(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_AFTERTOUCH:
+        snd_seq_ev_set_keypress(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_CONTROL_CHANGE:
+        snd_seq_ev_set_controller(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_PROGRAM_CHANGE:
+        snd_seq_ev_set_pgmchange(&ev, channel, d0);
+        break;
+
+    case EVENT_CHANNEL_PRESSURE:
+        snd_seq_ev_set_chanpress(&ev, channel, d0);
+        break;
+
+    case EVENT_PITCH_WHEEL:
+        snd_seq_ev_set_pitchbend(&ev, channel, ((int(d1) << 7) | d0) - 8192);
+        break;
+
+    default:
+        result = false;
+        break;
+    }
+    return result;
+}
 
 /**
- *  This play() function takes a native event, encodes it to an ALSA MIDI
- *  sequencer event, sets the broadcasting to the subscribers, sets the
- *  direct-passing mode to send the event without queueing, and puts it in the
- *  queue.
+ *  This play() function takes a native event, converts it to an ALSA MIDI
+ *  sequencer event, and sets the broadcasting to the subscribers.  The event
+ *  is then scheduled on the ALSA queue, if the master buss has handed it
+ *  over ahead of its deadline, or else set to direct-passing mode, to send
+ *  it without queueing.  Finally it is put in the output buffer.  Nothing is
+ *  allocated.
  *
  * \threadsafe
  *
@@ -574,18 +659,15 @@ midi_in_alsa::api_poll_for_midi ()
 void
 midi_alsa::api_play (event * e24, midibyte channel)
 {
-    midibyte buffer[4];                             /* temp for MIDI data   */
-    buffer[0] = e24->get_status();                  /* fill buffer          */
-    buffer[0] += (channel & 0x0F);
-    e24->get_data(buffer[1], buffer[2]);            /* set MIDI data        */
-
-    snd_midi_event_t * midi_ev;                     /* ALSA MIDI parser     */
-    snd_midi_event_new(SEQ66_MIDI_EVENT_SIZE_MAX, &midi_ev);
+    midibyte status = e24->get_status() + (channel & 0x0F);
+    midibyte d0, d1;
+    e24->get_data(d0, d1);
 
     snd_seq_event_t ev;
     snd_seq_ev_clear(&ev);                          /* clear event          */
-    snd_midi_event_encode(midi_ev, buffer, 3, &ev); /* encode 3 raw bytes   */
-    snd_midi_event_free(midi_ev);                   /* free the parser      */
+    if (! set_channel_event(ev, status, d0, d1))
+        return;
+
     snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
 
 #if defined SEQ66_SHOW_API_CALLS_TMI                /* Too Much Information */
@@ -593,7 +675,11 @@ midi_alsa::api_play (event * e24, midibyte channel)
 #endif
 
     snd_seq_ev_set_subs(&ev);
-    snd_seq_ev_set_direct(&ev);                     /* it is immediate      */
+    if (not_nullptr(m_alsa_info))
+        m_alsa_info->schedule(ev);                  /* queued or direct     */
+    else
+        snd_seq_ev_set_direct(&ev);                 /* it is immediate      */
+
     snd_seq_event_output(m_seq, &ev);               /* pump into the queue  */
 }
 
@@ -773,7 +859,9 @@ midi_alsa::api_stop ()
 
 /**
  *  Generates the MIDI clock, starting at the given tick value.
- *  Also sets the event tag to 127 so the sequences won't remove it.
+ *  Also sets the event tag to 127 so the sequences won't remove it.  Like
+ *  api_play(), the clock is stamped with the delivery time, if the master
+ *  buss has set one, so that a clock queued ahead goes out on time.
  *
  * \threadsafe
  *
@@ -800,7 +888,11 @@ midi_alsa::api_clock (midipulse tick)
     snd_seq_ev_set_priority(&ev, 1);
     snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
     snd_seq_ev_set_subs(&ev);
-    snd_seq_ev_set_direct(&ev);                     /* it's immediate       */
+    if (not_nullptr(m_alsa_info))
+        m_alsa_info->schedule(ev);                  /* queued or direct     */
+    else
+        snd_seq_ev_set_direct(&ev);                 /* it's immediate       */
+
     snd_seq_event_output(m_seq, &ev);               /* pump it into queue   */
 }
 
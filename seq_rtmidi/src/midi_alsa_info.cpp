@@ -6,7 +6,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2016-11-14
- * \updates       2020-08-04
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big.
  *
  *  API information found at:
@@ -59,7 +59,7 @@
 #include "midi/event.hpp"               /* seq66::event and other tokens    */
 #include "midi/midibus_common.hpp"      /* from the libseq66 sub-project    */
 #include "midi_alsa_info.hpp"           /* seq66::midi_alsa_info            */
-#include "os/timing.hpp"                /* seq66::microsleep()              */
+#include "os/timing.hpp"                /* seq66::microsleep(), microtime() */
 #include "util/calculations.hpp"        /* seq66::tempo_us_from_bpm()       */
 #include "util/basic_macros.hpp"        /* C++ version of easy macros       */
 
@@ -121,7 +121,12 @@ midi_alsa_info::midi_alsa_info
     midi_info               (appname, ppqn, bpm),
     m_alsa_seq              (nullptr),
     m_num_poll_descriptors  (0),            /* from ALSA mastermidibus      */
-    m_poll_descriptors      (nullptr)       /* ditto                        */
+    m_poll_descriptors      (nullptr),      /* ditto                        */
+    m_queue_running         (false),
+    m_queue_origin_us       (0),
+    m_deliver_us            (0),
+    m_input_stamped         (false),
+    m_input_us              (0)
 {
     snd_seq_t * seq;                        /* point to member              */
     int result = snd_seq_open               /* set up ALSA sequencer client */
@@ -145,6 +150,18 @@ midi_alsa_info::midi_alsa_info
         snd_seq_set_client_name(m_alsa_seq, rc().application_name().c_str());
         global_queue(snd_seq_alloc_queue(m_alsa_seq));
         get_poll_descriptors();
+
+        /*
+         *  The output of a whole cycle is drained at once, so a dense cycle
+         *  can need more than the default pool of the kernel.
+         */
+
+        int pool = rc().alsa_pool();
+        if (pool > 0 && snd_seq_set_client_pool_output(m_alsa_seq, pool) < 0)
+            errprint("cannot set the ALSA output pool size");
+
+        if (rc().alsa_input_time())
+            m_input_stamped = start_queue();    /* see midi_alsa::api_init_in */
     }
 }
 
@@ -337,6 +354,92 @@ midi_alsa_info::get_all_port_info ()
     return count;
 }
 
+/**
+ *  Starts the global queue, if not already done, and measures the offset
+ *  between its real time and microtime().  The queue is left running until
+ *  the destructor stops it; it costs nothing.
+ *
+ * \return
+ *      Returns true if the queue is running and the offset is known.
+ */
+
+bool
+midi_alsa_info::start_queue ()
+{
+    int queue = global_queue();
+    bool result = not_nullptr(m_alsa_seq) && queue >= 0;
+    if (result && ! m_queue_running)
+    {
+        result = snd_seq_start_queue(m_alsa_seq, queue, nullptr) >= 0;
+        if (result)
+        {
+            (void) snd_seq_drain_output(m_alsa_seq);
+            m_queue_running = true;
+        }
+        else
+            errprint("cannot start the ALSA queue");
+    }
+    if (result)
+    {
+        snd_seq_queue_status_t * status;
+        snd_seq_queue_status_alloca(&status);
+        result = snd_seq_get_queue_status(m_alsa_seq, queue, status) >= 0;
+        if (result)
+        {
+            const snd_seq_real_time_t * rt =
+                snd_seq_queue_status_get_real_time(status);
+
+            long queueus =
+                long(rt->tv_sec) * 1000000 + long(rt->tv_nsec / 1000);
+
+            m_queue_origin_us = microtime() - queueus;
+        }
+    }
+    return result;
+}
+
+/**
+ *  Starts the global queue, so that output events can be scheduled on it
+ *  with real-time timestamps.  Used only if the "alsa_queue" option is set.
+ *
+ * \param flag
+ *      True to enable timed output.
+ *
+ * \return
+ *      Returns true if timed output is enabled.
+ */
+
+bool
+midi_alsa_info::api_timed_output (bool flag)
+{
+    m_deliver_us = 0;
+    return flag && rc().alsa_queue() ? start_queue() : false ;
+}
+
+/**
+ *  Sets up an output event for sending.  If a delivery time has been set by
+ *  api_deliver_at(), the event is scheduled on the global queue at that
+ *  time; otherwise it is sent directly.
+ *
+ * \param ev
+ *      The event to be sent.
+ */
+
+void
+midi_alsa_info::schedule (snd_seq_event_t & ev) const
+{
+    long us = m_deliver_us - m_queue_origin_us;
+    if (m_deliver_us > 0 && us > 0)
+    {
+        snd_seq_real_time_t rt;
+        rt.tv_sec = unsigned(us / 1000000);
+        rt.tv_nsec = unsigned(us % 1000000) * 1000;
+        snd_seq_ev_schedule_real(&ev, global_queue(), 0, &rt);
+    }
+    else
+        snd_seq_ev_set_direct(&ev);
+}
+
 /**
  *  Flushes our local queue events out into ALSA.  This is also a midi_alsa
  *  function.
@@ -737,6 +840,14 @@ midi_alsa_info::api_get_midi_event (event * inev)
         }
 #endif
         result = inev->set_midi_event(ev->time.tick, buffer, bytes);
+        m_input_us = 0;
+        if (m_input_stamped && snd_seq_ev_is_real(ev))
+        {
+            long us = long(ev->time.time.tv_sec) * 1000000 +
+                long(ev->time.time.tv_nsec / 1000);
+
+            m_input_us = m_queue_origin_us + us;
+        }
         if (result)
         {
             bussbyte b = input_ports().get_port_index
@@ -6,7 +6,7 @@
  * \library       seq66 application
  * \author        Gary P. Scavone; severe refactoring by Chris Ahlstrom
  * \date          2016-11-14
- * \updates       2020-08-25
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *  Written primarily by Alexander Svetalkin, with updates for delta time by
@@ -164,6 +164,30 @@
 
 #define JACK_RINGBUFFER_SIZE 16384      /* default size for ringbuffer  */
 
+/**
+ *  The largest piece of a SysEx message written to the ringbuffer at once.
+ *  A larger message is written in several pieces, as the process callback
+ *  makes room, so that it need not fit in the ringbuffer.
+ */
+
+static const int c_jack_sysex_chunk = JACK_RINGBUFFER_SIZE / 4;
+
+/**
+ *  How long api_sysex() waits, in milliseconds, for the process callback to
+ *  make room in the ringbuffer, before giving up on the rest of a message.
+ *  It polls once per millisecond, so this is also the number of polls.  The
+ *  count restarts whenever a piece is written, so this bounds each stall,
+ *  not the whole message.  A message that JACK never drains blocks the
+ *  caller for about this long, then its remainder is dropped.
+ *
+ *  The caller is mastermidibase::sysex(), which holds the master buss lock.
+ *  It is called by the input thread to pass SysEx through, and never by
+ *  the output thread.  So a stall delays the output thread only when it
+ *  needs the master buss lock.
+ */
+
+static const int c_jack_sysex_wait_ms = 1000;
+
 /*
  * Do not document the namespace; it breaks Doxygen.
  */
@@ -179,17 +203,22 @@ namespace seq66
  *  to our application's input port:
  *
  *      -#  Get the JACK port buffer and the MIDI event-count in this buffer.
- *      -#  For each MIDI event, get the event from JACK and push it into a
- *          local midi_message object.
+ *      -#  For each MIDI event, get the event from JACK.
  *      -#  Get the event time, converting it to a delta time if possible.
  *      -#  If it is not a SysEx continuation, then:
- *          -#  If we're using a callback, pass the data to that callback.  Do
- *              we need this callback to interface with the midibus-based
- *              code?
- *          -#  Otherwise, add the midi_message container to the rtmidi input
- *              queue.  One can then grab this data in a midibase ::
- *              poll_for_midi() call.  We still ought to check the add
- *              success.
+ *          -#  If we're using a callback, copy the bytes into the reusable
+ *              midi_message of the rtmidi_in_data object, and pass it to
+ *              that callback.  Do we need this callback to interface with the
+ *              midibus-based code?
+ *          -#  Otherwise, copy the bytes straight from the JACK buffer into
+ *              the rtmidi input queue, which is a preallocated ring of
+ *              fixed-size records (long messages such as SysEx go to its
+ *              preallocated spill area).  One can then grab this data in a
+ *              midibase :: poll_for_midi() call.
+ *
+ *  Nothing here allocates or locks, since it runs in the JACK real-time
+ *  thread.  (The reusable midi_message can grow the first few times it is
+ *  used in callback mode, and then keeps its storage.)
  *
  *  The ALSA code polls for events, and that model is also available here.
  *  We're still working exactly how it will work best.
@@ -254,11 +283,6 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
             int rc = jack_midi_event_get(&jmevent, buff, j);
             if (rc == 0)
             {
-                midi_message message;
-                int eventsize = int(jmevent.size);
-                for (int i = 0; i < eventsize; ++i)
-                    message.push(jmevent.buffer[i]);
-
                 jack_time_t delta_jtime;
                 jtime = jack_get_time();            /* compute delta time   */
                 if (rtindata->first_message())
@@ -271,17 +295,29 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
                     jtime -= jackdata->m_jack_lasttime;
                     delta_jtime = jack_time_t(jtime * 0.000001);
                 }
-                message.timestamp(delta_jtime);
                 jackdata->m_jack_lasttime = jtime;
                 if (! rtindata->continue_sysex())
                 {
+                    int eventsize = int(jmevent.size);
                     if (rtindata->using_callback())
                     {
+                        midi_message & message = rtindata->message();
+                        message.clear();
+                        for (int i = 0; i < eventsize; ++i)
+                            message.push(jmevent.buffer[i]);
+
+                        message.timestamp(delta_jtime);
+
                         rtmidi_callback_t callback = rtindata->user_callback();
                         callback(message, rtindata->user_data());
                     }
                     else
-                        (void) rtindata->queue().add(message);
+                    {
+                        (void) rtindata->queue().add
+                        (
+                            jmevent.buffer, eventsize, double(delta_jtime)
+                        );
+                    }
                 }
             }
             else
@@ -311,20 +347,38 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
  *      -#  Loop while the number of bytes available for reading [via
  *          jack_ringbuffer_read_space()] is non-zero.  Note that the second
  *          parameter is where the data is copied.
- *      -#  Get the size of each event, and allocate space for an event to be
- *          written to an event port buffer (the JACK "reserve" function).
- *      -#  Read the data from the ringbuffer into this port buffer.  JACK
- *          should then send it to the remote port.
+ *      -#  Peek at the header of each event, which holds its size and its
+ *          target frame.  If the target frame falls in a later period, stop;
+ *          the event stays in the ringbuffer for the next callback.
+ *      -#  Convert the target frame to an offset into this period, relative
+ *          to jack_last_frame_time().  An event that is late goes at the
+ *          offset of the previous event, since JACK refuses events that are
+ *          out of order.
+ *      -#  Allocate space for an event to be written to an event port buffer
+ *          (the JACK "reserve" function), and read the data from the
+ *          ringbuffer into this port buffer.  JACK should then send it to the
+ *          remote port.
+ *      -#  If the message does not fit in the room left in the port buffer,
+ *          it waits for the next callback.  If it does not even fit in an
+ *          empty port buffer (a large SysEx message), as much as fits is
+ *          written, and the rest follows in the next callbacks.  The count
+ *          of bytes already written is kept in midi_jack_data::m_jack_partial.
  *
  *  Since this is an output port, "buff" is the area to which we can write
  *  data, to send it to the "remote" (i.e. outside our application) port.  The
  *  data is written to the ringbuffer in api_init_out(), and here we read the
  *  ring buffer and pass it to the output buffer.
  *
- *  We were wondering if, like the JACK midiseq example program, we need to
- *  wrap the out-process in a for-loop over the number of frames.  In our
- *  tests, we are getting 1024 frames, and the code seems to work without that
- *  loop.
+ *  The target frame is set by send_message() to the frame time of the
+ *  message plus one period.  So every message is delayed by exactly one
+ *  period, instead of landing at frame 0 of the next period no matter when
+ *  it was queued, and the spacing between messages is kept to the sample.
+ *  In engine mode, the target frame lies in the current period instead.
+ *
+ *  The process callback calls this function only for a port that has
+ *  messages queued, or that was written in the previous period, so
+ *  midi_jack_data::m_jack_written is set to tell it whether the port buffer
+ *  must be cleared next time.
  *
  * \param nframes
  *    The frame number to be processed.
@@ -339,7 +393,6 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
 int
 jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
 {
-    static size_t s_offset = 0;
     midi_jack_data * jackdata = reinterpret_cast<midi_jack_data *>(arg);
 
 #ifdef SEQ66_USE_DEBUG_OUTPUT
@@ -375,48 +428,82 @@ jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
     );
 #endif
 
-    /*
-     * A for-loop over the number of nframes?  See discussion above.
-     * Why are we reading here?  That's where our app has dumped the next set
-     * of MIDI events to output.
-     */
-
-    while (jack_ringbuffer_read_space(jackdata->m_jack_buffsize) > 0)
+    jack_nframes_t lastframe = jack_last_frame_time(jackdata->m_jack_client);
+    jack_nframes_t offset = 0;
+    bool written = false;
+    midi_jack_header header;
+    while
+    (
+        jack_ringbuffer_read_space(jackdata->m_jack_buffsize) >= sizeof header
+    )
     {
-        int space;
-        (void) jack_ringbuffer_read
+        (void) jack_ringbuffer_peek
         (
-            jackdata->m_jack_buffsize, (char *) &space, sizeof space
+            jackdata->m_jack_buffsize, (char *) &header, sizeof header
         );
 
         /*
-         * s_offset is always zero. Using nframes instead of s_offset = 0
-         * causes notes not to be played.  Probably because this is a write
-         * operation?
+         * The signed difference copes with the wrap-around of the frame
+         * counter.  A negative value means the message is late (e.g. after
+         * an xrun).  The rest of a partly-sent message goes first.
          */
 
-        jack_midi_data_t * md = jack_midi_event_reserve(buf, s_offset, space);
+        size_t partial = jackdata->m_jack_partial;
+        if (partial == 0)
+        {
+            int32_t delta = int32_t(header.mjh_frame - lastframe);
+            if (delta >= int32_t(nframes))
+                break;                              /* due in a later cycle */
+
+            if (delta > int32_t(offset))
+                offset = jack_nframes_t(delta);
+        }
+
+        size_t left = size_t(header.mjh_size) - partial;
+        size_t space = left;
+        size_t room = jack_midi_max_event_size(buf);
+        if (left > room)
+        {
+            if (written || room == 0)
+                break;                              /* back-pressure        */
+
+            space = room;                           /* split the message    */
+        }
+
+        jack_midi_data_t * md = jack_midi_event_reserve(buf, offset, space);
         if (not_nullptr(md))
         {
             char * mididata = reinterpret_cast<char *>(md);
             (void) jack_ringbuffer_read         /* copy into mididata */
             (
-                jackdata->m_jack_buffmessage, mididata, size_t(space)
+                jackdata->m_jack_buffmessage, mididata, space
             );
 
 #ifdef SEQ66_SHOW_API_CALLS_TMI
-            printf("%d bytes read: ", space);
-            for (int i = 0; i < space; ++i)
+            printf("%d bytes read at %u: ", int(space), unsigned(offset));
+            for (size_t i = 0; i < space; ++i)
                 printf("%x ", (unsigned char)(mididata[i]));
 
             printf("\n");
 #endif
+            written = true;
         }
         else
         {
+            space = left;                           /* drop the rest        */
+            jack_ringbuffer_read_advance(jackdata->m_jack_buffmessage, space);
             errprint("jack_midi_event_reserve() returned a null pointer");
         }
+        partial += space;
+        if (partial < size_t(header.mjh_size))
+        {
+            jackdata->m_jack_partial = partial;     /* more next cycle      */
+            break;
+        }
+        jackdata->m_jack_partial = 0;
+        jack_ringbuffer_read_advance(jackdata->m_jack_buffsize, sizeof header);
     }
+    jackdata->m_jack_written = written;
     return 0;
 }
 
@@ -733,25 +820,24 @@ midi_jack::api_deinit_in ()
 }
 
 /**
- *  We could push the bytes of the event into a midibyte vector, as done in
- *  send_message().  The ALSA code (seq_alsamidi/src/midibus.cpp) sticks the
- *  event bytes in an array, which might be a little faster than using
- *  push_back(), but let's try the vector first.  The rtmidi code here is from
- *  midi_out_jack::send_message().
+ *  Sends the bytes of the event, held in a small array as in the ALSA code
+ *  (seq_alsamidi/src/midibus.cpp), so that nothing is allocated.  This
+ *  matters when the JACK process callback drives the sequencer, and this
+ *  function is called in the real-time thread.  In that case, the event is
+ *  placed at the frame offset set by the engine.
  */
 
 void
 midi_jack::api_play (event * e24, midibyte channel)
 {
-    midibyte status = e24->get_status() + (channel & 0x0F);
+    midibyte buffer[3];
     midibyte d0, d1;
     e24->get_data(d0, d1);
+    buffer[0] = e24->get_status() + (channel & 0x0F);
+    buffer[1] = d0;
+    buffer[2] = d1;
 
-    midi_message message;
-    message.push(status);
-    message.push(d0);
-    if (e24->is_two_bytes())                    /* \change ca 2017-04-26 */
-        message.push(d1);
+    int nbytes = e24->is_two_bytes() ? 3 : 2 ;  /* \change ca 2017-04-26 */
 
 #ifdef SEQ66_SHOW_API_CALLS_TMI
     printf("midi_jack::play()\n");
@@ -759,7 +845,7 @@ midi_jack::api_play (event * e24, midibyte channel)
 
     if (m_jack_data.valid_buffer())
     {
-        if (! send_message(message))
+        if (! send_message(buffer, nbytes, m_jack_info.frame_offset()))
         {
             errprint("JACK api_play failed");
         }
@@ -767,11 +853,30 @@ midi_jack::api_play (event * e24, midibyte channel)
 }
 
 /**
- *  Sends a JACK MIDI output message.  It writes the full message size and
- *  the message itself to the JACK ring buffer.
+ *  Sends a JACK MIDI output message.  It writes the message itself, then a
+ *  header holding its size and its target frame, to the JACK ring buffers.
+ *  The header is written last, so that the process callback never sees a
+ *  header without its bytes.  Nothing is written unless both fit, so that a
+ *  full buffer drops the message instead of mixing up the two buffers.
+ *
+ *  By default, the target frame is the current frame time plus one period.
+ *  jack_frame_time() is an estimate of the frame being played now, within
+ *  the period being processed; the message will be picked up by the next
+ *  process callback, and placed at the same offset into that period.
+ *
+ *  When the engine runs in the process callback, it gives the offset of the
+ *  event in the current period instead, and the message is picked up later
+ *  in the same callback.
+ *
+ * \param data
+ *      Provides the bytes to send.
  *
- * \param message
- *      Provides the MIDI message object, which contains the bytes to send.
+ * \param nbytes
+ *      The number of bytes to send.
+ *
+ * \param offset
+ *      If not negative, the frame offset from the start of the period being
+ *      processed.  Valid only in the JACK process callback.
  *
  * \return
  *      Returns true if the buffer message and buffer size seem to be written
@@ -779,38 +884,102 @@ midi_jack::api_play (event * e24, midibyte channel)
  */
 
 bool
-midi_jack::send_message (const midi_message & message)
+midi_jack::send_message (const midibyte * data, int nbytes, int offset)
 {
-    int nbytes = message.count();
     bool result = nbytes > 0;
     if (result)
     {
-#ifdef SEQ66_PLATFORM_DEBUG_TMI
-        message.show();
-#endif
-        int count1 = jack_ringbuffer_write
-        (
-            m_jack_data.m_jack_buffmessage, message.array(), message.count()
-        );
-        int count2 = jack_ringbuffer_write
-        (
-            m_jack_data.m_jack_buffsize, (char *) &nbytes, sizeof nbytes
-        );
-        apiprint("send_message", "jack");
-        result = (count1 > 0) && (count2 > 0);
+        midi_jack_header header;
+        jack_ringbuffer_t * rbmessage = m_jack_data.m_jack_buffmessage;
+        jack_ringbuffer_t * rbsize = m_jack_data.m_jack_buffsize;
+        result =
+            jack_ringbuffer_write_space(rbmessage) >= size_t(nbytes) &&
+            jack_ringbuffer_write_space(rbsize) >= sizeof header;
+
+        if (result)
+        {
+            jack_client_t * client = client_handle();
+            if (offset >= 0)
+            {
+                header.mjh_frame = jack_last_frame_time(client) +
+                    jack_nframes_t(offset);
+            }
+            else
+            {
+                header.mjh_frame =
+                    jack_frame_time(client) + jack_get_buffer_size(client);
+            }
+            header.mjh_size = nbytes;
+            (void) jack_ringbuffer_write
+            (
+                rbmessage, (const char *) data, size_t(nbytes)
+            );
+            (void) jack_ringbuffer_write
+            (
+                rbsize, (const char *) &header, sizeof header
+            );
+            m_jack_info.output_pending(m_jack_data.m_jack_slot);
+            apiprint("send_message", "jack");
+        }
     }
     return result;
 }
 
 /**
- * \todo
- *      Flesh out this routine.
+ *  Sends a SysEx message.  The message is written to the ringbuffer in
+ *  pieces of at most c_jack_sysex_chunk bytes.  When the ringbuffer is full,
+ *  this function waits for the process callback to empty it, so that a
+ *  large patch dump is not lost.  The process callback sends each piece as
+ *  one JACK MIDI event, split over several periods if it does not fit in
+ *  the port buffer.
+ *
+ *  In engine mode, the process callback does not render while the master
+ *  buss is locked, as it is while this function runs (see performer ::
+ *  engine_cycle()), so waiting would hold up playback; there is no
+ *  waiting, and what does not fit in the ringbuffer is dropped, with an
+ *  error message.  The only test is engine_active(); no test is needed for
+ *  the output thread, which never sends SysEx.  See c_jack_sysex_wait_ms
+ *  for the bound on the wait.
+ *
+ * \param e24
+ *      The SysEx event to send.
  */
 
 void
-midi_jack::api_sysex (event * /* e24 */)
+midi_jack::api_sysex (event * e24)
 {
-    // Will put this one off until later....
+    event::sysex & data = e24->get_sysex();
+    int datasize = e24->get_sysex_size();
+    if (datasize <= 0 || ! m_jack_data.valid_buffer())
+        return;
+
+    bool canwait = ! m_jack_info.engine_active();
+    int waited = 0;
+    int offset = 0;
+    while (offset < datasize)
+    {
+        int left = datasize - offset;
+        int chunk = left < c_jack_sysex_chunk ? left : c_jack_sysex_chunk ;
+        if (send_message(&data[offset], chunk))
+        {
+            offset += chunk;
+            waited = 0;
+        }
+        else if (canwait && waited < c_jack_sysex_wait_ms)
+        {
+            (void) microsleep(1000);                /* let JACK catch up    */
+            ++waited;
+        }
+        else
+        {
+            msgprintf
+            (
+                msg_level::error,
+                "JACK SysEx: %d of %d bytes dropped", left, datasize
+            );
+            break;
+        }
+    }
 }
 
 /**
@@ -935,11 +1104,9 @@ midi_jack::api_clock (midipulse tick)
 void
 midi_jack::send_byte (midibyte evbyte)
 {
-    midi_message message;
-    message.push(evbyte);
     if (m_jack_data.valid_buffer())
     {
-        bool ok = send_message(message);
+        bool ok = send_message(&evbyte, 1, m_jack_info.frame_offset());
         if (! ok)
         {
             errprint("JACK send_byte() failed");
@@ -1366,6 +1533,10 @@ midi_in_jack::midi_in_jack (midibus & parentbus, midi_info & masterinfo)
 
 /**
  *  Checks the rtmidi_in_data queue for the number of items in the queue.
+ *  This function no longer sleeps; the waiting for input is done once for
+ *  all of the ports, in midi_jack_info::api_poll_for_midi().  It also
+ *  reports the messages that the JACK callback had to drop, since the
+ *  callback itself must not print.
  *
  * \return
  *      Returns the value of rtindata->queue().count(), unless the caller is
@@ -1376,21 +1547,16 @@ int
 midi_in_jack::api_poll_for_midi ()
 {
     rtmidi_in_data * rtindata = m_jack_data.m_jack_rtmidiin;
-    if (rtindata->using_callback())
-    {
-        (void) microsleep(100);
-        return 0;
-    }
-    else
-    {
-        (void) microsleep(100);
-        return rtindata->queue().count();
-    }
+    unsigned dropped = rtindata->queue().take_dropped();
+    if (dropped > 0)
+        errprintf("JACK input queue full, %u messages dropped", dropped);
+
+    return rtindata->using_callback() ? 0 : rtindata->queue().count() ;
 }
 
 /**
- *  Gets a MIDI event.  This implementation gets a midi_message off the front
- *  of the queue and converts it to a Seq66 event.
+ *  Gets a MIDI event.  This implementation converts the record at the front
+ *  of the queue to a Seq66 event, in place, then pops the record.
  *
  * \change ca 2017-11-04
  *      Issue #4 "Bug with Yamaha PSR in JACK native mode" in the
@@ -1415,11 +1581,16 @@ bool
 midi_in_jack::api_get_midi_event (event * inev)
 {
     rtmidi_in_data * rtindata = m_jack_data.m_jack_rtmidiin;
-    bool result = ! rtindata->queue().empty();
+    midi_queue & mq = rtindata->queue();
+    bool result = ! mq.empty();
     if (result)
     {
-        midi_message mm = rtindata->queue().pop_front();
-        result = inev->set_midi_event(mm.timestamp(), mm.data(), mm.count());
+        const midi_record & mr = mq.front();
+        const midibyte * mm = mq.bytes(mr);
+        result = inev->set_midi_event
+        (
+            midipulse(mr.mr_timestamp), mm, int(mr.mr_count)
+        );
         if (result)
         {
             /*
@@ -1466,6 +1637,7 @@ midi_in_jack::api_get_midi_event (event * inev)
             else
                 inev->set_status(st);
         }
+        mq.pop();                           /* frees the record and spill   */
     }
     return result;
 }
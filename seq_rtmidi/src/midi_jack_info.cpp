@@ -6,7 +6,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2017-01-01
- * \updates       2020-07-06
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big.
  *
  *  This class is meant to collect a whole bunch of JACK information
@@ -34,6 +34,9 @@
  *  GitHub issue #165: enabled a build and run with no JACK support.
  */
 
+#include <cerrno>                       /* errno, EINTR                     */
+#include <ctime>                        /* clock_gettime()                  */
+
 #include "seq66-config.h"
 
 #if defined SEQ66_JACK_SUPPORT
@@ -48,6 +51,13 @@
 #include "util/basic_macros.hpp"        /* C++ version of easy macros       */
 #include "util/calculations.hpp"        /* extract_port_names()             */
 
+/**
+ *  The longest time the input thread waits for JACK input before checking
+ *  if it should exit.
+ */
+
+#define SEQ66_JACK_POLL_WAIT_MS         20
+
 /*
  * Do not document the namespace; it breaks Doxygen.
  */
@@ -87,18 +97,66 @@ jack_process_io (jack_nframes_t nframes, void * arg)
         if (not_nullptr(self))
         {
             /*
-             * Here we want to go through the I/O ports and route the data
-             * appropriately.
+             * In engine mode, the sequencer first renders this period into
+             * the output ringbuffers, which are then emptied into the port
+             * buffers below.  Then we go through the I/O ports and route
+             * the data appropriately.
+             */
+
+            rtmidi_engine_t engine =
+                self->m_engine.load(std::memory_order_acquire);
+
+            if (not_nullptr(engine))
+            {
+                jack_nframes_t rate = jack_get_sample_rate(self->m_jack_client);
+                engine(self->m_engine_arg, unsigned(nframes), unsigned(rate));
+            }
+
+            bool received = false;
+            int incount = self->m_input_count.load(std::memory_order_acquire);
+            for (int i = 0; i < incount; ++i)
+            {
+                midi_jack_data * mjp = self->m_input_table[i];
+                rtmidi_in_data * rtindata = mjp->m_jack_rtmidiin;
+                unsigned added = rtindata->queue().added();
+                (void) jack_process_rtmidi_input(nframes, mjp);
+                if (rtindata->queue().added() != added)
+                    received = true;
+            }
+
+            /*
+             * Only the output ports with queued messages, or with a buffer
+             * written in the last period (which must be cleared), are
+             * visited.  A port with messages left for a later period
+             * stays pending.
              */
 
-            for (auto mj : self->m_jack_ports)      /* midi_jack pointers   */
+            int w = 0;
+            for (auto & pending : self->m_output_pending)
             {
-                midi_jack_data * mjp = &mj->jack_data();
-                if (mj->parent_bus().is_input_port())
-                    (void) jack_process_rtmidi_input(nframes, mjp);
-                else
-                    (void) jack_process_rtmidi_output(nframes, mjp);
+                std::uint64_t bits = pending.exchange(0) |
+                    self->m_output_dirty[w];
+
+                std::uint64_t dirty = 0;
+                for (int bit = 0; bits != 0; ++bit, bits >>= 1)
+                {
+                    if ((bits & 1) != 0)
+                    {
+                        midi_jack_data * mjp = self->m_output_table[w*64+bit];
+                        (void) jack_process_rtmidi_output(nframes, mjp);
+                        std::uint64_t mask = std::uint64_t(1) << bit;
+                        if (mjp->m_jack_written)
+                            dirty |= mask;
+
+                        jack_ringbuffer_t * rb = mjp->m_jack_buffsize;
+                        if (jack_ringbuffer_read_space(rb) > 0)
+                            pending.fetch_or(mask);
+                    }
+                }
+                self->m_output_dirty[w++] = dirty;
             }
+            if (received)
+                self->signal_input();               /* wake input thread    */
         }
     }
     return 0;
@@ -125,9 +183,21 @@ midi_jack_info::midi_jack_info
 ) :
     midi_info               (appname, ppqn, bpm),
     m_jack_ports            (),
+    m_input_table           (),
+    m_output_table          (),
+    m_input_count           (0),
+    m_output_count          (0),
+    m_output_pending        (),
+    m_output_dirty          (),
     m_jack_client           (nullptr),              /* inited for connect() */
-    m_jack_client_2         (nullptr)
+    m_jack_client_2         (nullptr),
+    m_input_signal          (),
+    m_input_signal_ok       (false),
+    m_engine                (nullptr),
+    m_engine_arg            (nullptr),
+    m_frame_offset          (-1)
 {
+    m_input_signal_ok = sem_init(&m_input_signal, 0, 0) == 0;
     silence_jack_info();
     m_jack_client = connect();
     if (not_nullptr(m_jack_client))                 /* created by connect() */
@@ -146,6 +216,11 @@ midi_jack_info::midi_jack_info
 midi_jack_info::~midi_jack_info ()
 {
     disconnect();
+    if (m_input_signal_ok)
+    {
+        m_input_signal_ok = false;
+        (void) sem_destroy(&m_input_signal);
+    }
 }
 
 /**
@@ -405,6 +480,40 @@ midi_jack_info::api_flush ()
     // No code yet
 }
 
+/**
+ *  Installs or removes the engine function called by jack_process_io().
+ *  The engine can only be used with the single JACK client, whose process
+ *  callback services all of the ports.
+ *
+ *  Removing the engine does not wait for a callback in progress; the caller
+ *  must do that (see performer::engine_cycle()).
+ *
+ * \param cb
+ *      The function to call in each period, or null to stop calling it.
+ *
+ * \param arg
+ *      The first parameter to pass to the function.
+ *
+ * \return
+ *      Returns true if the function was installed or removed.
+ */
+
+bool
+midi_jack_info::api_engine (rtmidi_engine_t cb, void * arg)
+{
+    bool result = not_nullptr(m_jack_client);
+    if (is_nullptr(cb))
+    {
+        m_engine.store(nullptr, std::memory_order_release);
+    }
+    else if (result)
+    {
+        m_engine_arg = arg;
+        m_engine.store(cb, std::memory_order_release);
+    }
+    return result;
+}
+
 /**
  *  Sets up all of the ports, represented by midibus objects, that have
  *  been created.
@@ -520,13 +629,129 @@ midi_jack_info::api_port_start
 }
 
 /**
- *  We might be able to eliminate this function.
+ *  Adds a pointer to a JACK port, and puts its data into the input or
+ *  output table used by the process callback.
+ *
+ * \param mj
+ *      The port to add.
+ *
+ * \return
+ *      Returns false if the table for the port is full.  The port is then
+ *      not serviced by the process callback.
+ */
+
+bool
+midi_jack_info::add (midi_jack & mj)
+{
+    bool input = mj.parent_bus().is_input_port();
+    std::atomic<int> & count = input ? m_input_count : m_output_count ;
+    midi_jack_data ** table = input ? m_input_table : m_output_table ;
+    int slot = count.load();
+    bool result = slot < c_jack_ports_max;
+    m_jack_ports.push_back(&mj);
+    if (result)
+    {
+        midi_jack_data * mjp = &mj.jack_data();
+        mjp->m_jack_slot = input ? -1 : slot ;
+        table[slot] = mjp;
+        count.store(slot + 1, std::memory_order_release);
+    }
+    else
+        errprint("too many JACK ports");
+
+    return result;
+}
+
+/**
+ *  Counts the messages waiting in the queues of the enabled input ports.
+ *  Called by the input thread, which is the consumer of these queues.
+ *
+ * \return
+ *      Returns the total number of messages.
+ */
+
+int
+midi_jack_info::input_count ()
+{
+    int result = 0;
+    for (auto mj : m_jack_ports)
+    {
+        midibus & mb = mj->parent_bus();
+        if (mb.is_input_port() && mb.get_input())
+            result += mj->api_poll_for_midi();
+    }
+    return result;
+}
+
+/**
+ *  Blocks until the JACK process callback posts the input signal, or until
+ *  the timeout expires.  Extra posts, left over from cycles during which
+ *  the input thread was busy, are drained afterward, so that they do not
+ *  cause a string of empty wakeups.
+ *
+ * \param ms
+ *      The timeout in milliseconds.
+ *
+ * \return
+ *      Returns true if the signal was posted.
+ */
+
+bool
+midi_jack_info::wait_for_input (int ms)
+{
+    struct timespec deadline;
+    (void) clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += ms / 1000;
+    deadline.tv_nsec += long(ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000)
+    {
+        deadline.tv_nsec -= 1000000000;
+        ++deadline.tv_sec;
+    }
+
+    int rc;
+    do
+    {
+        rc = sem_timedwait(&m_input_signal, &deadline);
+    } while (rc != 0 && errno == EINTR);
+
+    bool result = rc == 0;
+    if (result)
+    {
+        while (sem_trywait(&m_input_signal) == 0)
+            ;                                       /* drain extra posts    */
+    }
+    return result;
+}
+
+/**
+ *  Waits for input on the JACK input ports.  This used to sleep for 100
+ *  microseconds and return 0, leaving the input ports to be polled (and each
+ *  one to sleep again) by the input thread.  Now, if no message is waiting,
+ *  the input thread blocks until the JACK process callback signals that it
+ *  has queued some.  This removes the idle wakeups and the added latency.
+ *  The timeout lets the input thread notice that it has been told to exit.
+ *
+ * \return
+ *      Returns the number of messages waiting in the queues of the enabled
+ *      input ports.  The caller then gets them via the input busses.
  */
+
 int
 midi_jack_info::api_poll_for_midi ()
 {
-    (void) microsleep(100);
-    return 0;
+    int result = input_count();
+    if (result == 0)
+    {
+        if (m_input_signal_ok)
+        {
+            if (wait_for_input(SEQ66_JACK_POLL_WAIT_MS))
+                result = input_count();
+        }
+        else
+            (void) microsleep(100);
+    }
+    return result;
 }
 
 /**
@@ -0,0 +1,506 @@
+/**
+ * \file          midi_loopback.cpp
+ *
+ *    An in-memory MIDI API for testing and benchmarking.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       See the rtexmidi.lic file.  Too big for a header file.
+ *
+ *  See the midi_loopback.hpp module for an overview.  The ports follow the
+ *  ALSA orientation: an input port is one the application reads from, and
+ *  an output port is one it plays to.
+ *
+ *  A typical test starts the application with "-o loopback=1:2", starts
+ *  playback, and then drains loopback_read(0, msg) to compare the timestamps
+ *  against the expected pulse times.  Input is scripted by calling
+ *  loopback_inject() with increasing delays before starting.
+ */
+
+#include "midi/event.hpp"               /* seq66::event and other tokens    */
+#include "midi/midibus.hpp"             /* seq66::midibus for rtmidi        */
+#include "midi_loopback.hpp"            /* seq66::midi_loopback             */
+#include "os/timing.hpp"                /* seq66::microtime()               */
+#include "util/basic_macros.hpp"        /* C++ version of easy macros       */
+
+/*
+ * Do not document the namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/*
+ * loopback_ring
+ */
+
+/**
+ *  Allocates the ring.  No allocation happens after this.
+ *
+ * \param size
+ *      The number of messages, which must be a power of 2.
+ */
+
+loopback_ring::loopback_ring (unsigned size) :
+    m_ring      (size),
+    m_mask      (size - 1),
+    m_head      (0),
+    m_tail      (0),
+    m_dropped   (0)
+{
+    // Empty body
+}
+
+/**
+ *  Adds a message.  Called only by the producer.
+ *
+ * \return
+ *      Returns false if the ring is full, in which case the message is
+ *      dropped and counted.
+ */
+
+bool
+loopback_ring::push (const loopback_message & msg)
+{
+    unsigned head = m_head.load(std::memory_order_relaxed);
+    unsigned tail = m_tail.load(std::memory_order_acquire);
+    bool result = (head - tail) <= m_mask;
+    if (result)
+    {
+        m_ring[head & m_mask] = msg;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+    else
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+
+    return result;
+}
+
+/**
+ *  Copies the oldest message without removing it.  Called only by the
+ *  consumer.
+ */
+
+bool
+loopback_ring::front (loopback_message & msg) const
+{
+    unsigned tail = m_tail.load(std::memory_order_relaxed);
+    unsigned head = m_head.load(std::memory_order_acquire);
+    bool result = tail != head;
+    if (result)
+        msg = m_ring[tail & m_mask];
+
+    return result;
+}
+
+/**
+ *  Removes the oldest message.  Called only by the consumer.
+ */
+
+bool
+loopback_ring::pop (loopback_message & msg)
+{
+    unsigned tail = m_tail.load(std::memory_order_relaxed);
+    unsigned head = m_head.load(std::memory_order_acquire);
+    bool result = tail != head;
+    if (result)
+    {
+        msg = m_ring[tail & m_mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+    }
+    return result;
+}
+
+/*
+ * midi_loopback
+ */
+
+/**
+ *  Principal constructor.  Registers the port with the master information
+ *  object.
+ *
+ * \param parentbus
+ *      Provides the buss object that determines buss-specific parameters of
+ *      this class.
+ *
+ * \param masterinfo
+ *      Provides the midi_loopback_info object.
+ */
+
+midi_loopback::midi_loopback
+(
+    midibus & parentbus,
+    midi_info & masterinfo
+) :
+    midi_api            (parentbus, masterinfo),
+    m_loopback_info     (dynamic_cast<midi_loopback_info &>(masterinfo)),
+    m_ring              ()
+{
+    (void) m_loopback_info.add(*this);
+}
+
+/**
+ *  Unregisters the port.
+ */
+
+midi_loopback::~midi_loopback ()
+{
+    m_loopback_info.remove(*this);
+}
+
+/**
+ *  There is nothing to open, so each of the initialization functions just
+ *  marks the port as open.
+ */
+
+bool
+midi_loopback::api_init_out ()
+{
+    set_port_open();
+    return true;
+}
+
+bool
+midi_loopback::api_init_in ()
+{
+    set_port_open();
+    return true;
+}
+
+bool
+midi_loopback::api_init_out_sub ()
+{
+    master_midi_mode(SEQ66_MIDI_OUTPUT_PORT);
+    set_port_open();
+    return true;
+}
+
+bool
+midi_loopback::api_init_in_sub ()
+{
+    master_midi_mode(SEQ66_MIDI_INPUT_PORT);
+    set_port_open();
+    return true;
+}
+
+bool
+midi_loopback::api_deinit_in ()
+{
+    return true;
+}
+
+/**
+ *  Records a channel event, with the time it was sent.
+ */
+
+void
+midi_loopback::api_play (event * e24, midibyte channel)
+{
+    midibyte d0, d1;
+    e24->get_data(d0, d1);
+
+    loopback_message msg;
+    msg.lm_timestamp = microtime();
+    msg.lm_bytes[0] = e24->get_status() + (channel & 0x0F);
+    msg.lm_bytes[1] = d0;
+    msg.lm_bytes[2] = d1;
+    msg.lm_count = e24->is_two_bytes() ? 3 : 2 ;
+    (void) m_ring.push(msg);
+}
+
+/**
+ *  SysEx is not recorded.
+ */
+
+void
+midi_loopback::api_sysex (event * /* e24 */)
+{
+    // No code needed
+}
+
+/**
+ *  Messages are recorded as they are sent.
+ */
+
+void
+midi_loopback::api_flush ()
+{
+    // No code needed
+}
+
+/**
+ *  Records Continue and Song Position, as the ALSA version sends them.
+ *
+ * \param beats
+ *      The song position in MIDI beats (sixteenth notes).
+ */
+
+void
+midi_loopback::api_continue_from (midipulse /*tick*/, midipulse beats)
+{
+    send_byte(EVENT_MIDI_CONTINUE);
+
+    loopback_message msg;
+    msg.lm_timestamp = microtime();
+    msg.lm_bytes[0] = EVENT_MIDI_SONG_POS;
+    msg.lm_bytes[1] = midibyte(beats & 0x7F);
+    msg.lm_bytes[2] = midibyte((beats >> 7) & 0x7F);
+    msg.lm_count = 3;
+    (void) m_ring.push(msg);
+}
+
+void
+midi_loopback::api_start ()
+{
+    send_byte(EVENT_MIDI_START);
+}
+
+void
+midi_loopback::api_stop ()
+{
+    send_byte(EVENT_MIDI_STOP);
+}
+
+void
+midi_loopback::api_clock (midipulse /*tick*/)
+{
+    send_byte(EVENT_MIDI_CLOCK);
+}
+
+void
+midi_loopback::api_set_ppqn (int /*ppqn*/)
+{
+    // No code needed
+}
+
+void
+midi_loopback::api_set_beats_per_minute (midibpm /*bpm*/)
+{
+    // No code needed
+}
+
+/**
+ *  Records a one-byte realtime message.
+ */
+
+void
+midi_loopback::send_byte (midibyte evbyte)
+{
+    loopback_message msg;
+    msg.lm_timestamp = microtime();
+    msg.lm_bytes[0] = evbyte;
+    msg.lm_bytes[1] = msg.lm_bytes[2] = 0;
+    msg.lm_count = 1;
+    (void) m_ring.push(msg);
+}
+
+/*
+ * midi_in_loopback
+ */
+
+midi_in_loopback::midi_in_loopback
+(
+    midibus & parentbus,
+    midi_info & masterinfo
+) :
+    midi_loopback   (parentbus, masterinfo)
+{
+    // Empty body
+}
+
+midi_in_loopback::~midi_in_loopback ()
+{
+    // Empty body
+}
+
+/**
+ *  The mastermidibus sleeps between polls, so this function does not.
+ *
+ * \return
+ *      Returns 1 if the oldest injected message is due, and 0 otherwise.
+ */
+
+int
+midi_in_loopback::api_poll_for_midi ()
+{
+    loopback_message msg;
+    bool due = m_ring.front(msg) && msg.lm_timestamp <= microtime();
+    return due ? 1 : 0 ;
+}
+
+/**
+ *  Gets the oldest injected message, if it is due.  As in the JACK version,
+ *  Active Sensing and Reset are dropped.
+ *
+ * \param inev
+ *      Provides the destination for the MIDI event.
+ *
+ * \return
+ *      Returns true if an event was obtained.
+ */
+
+bool
+midi_in_loopback::api_get_midi_event (event * inev)
+{
+    loopback_message msg;
+    bool result = m_ring.front(msg) && msg.lm_timestamp <= microtime();
+    if (result)
+    {
+        (void) m_ring.pop(msg);
+        result = inev->set_midi_event
+        (
+            msg.lm_timestamp, msg.lm_bytes, msg.lm_count
+        );
+        if (result)
+        {
+            midibyte st = msg.lm_bytes[0];
+            if (event::is_sense_or_reset(st))
+                result = false;
+            else
+                inev->set_status(st);
+        }
+    }
+    return result;
+}
+
+/*
+ * midi_out_loopback
+ */
+
+midi_out_loopback::midi_out_loopback
+(
+    midibus & parentbus,
+    midi_info & masterinfo
+) :
+    midi_loopback   (parentbus, masterinfo)
+{
+    // Empty body
+}
+
+midi_out_loopback::~midi_out_loopback ()
+{
+    // Empty body
+}
+
+/*
+ * Free functions
+ */
+
+/**
+ *  Reads the oldest message recorded by an output port.  Must be called from
+ *  one thread only.
+ *
+ * \param port
+ *      The buss index of the output port.
+ *
+ * \param [out] msg
+ *      Receives the message and its timestamp.
+ *
+ * \return
+ *      Returns false if there is no such port or no message.
+ */
+
+bool
+loopback_read (int port, loopback_message & msg)
+{
+    midi_loopback_info * mli = midi_loopback_info::instance();
+    midi_loopback * mlp = not_nullptr(mli) ?
+        mli->find_port(SEQ66_MIDI_OUTPUT_PORT, port) : nullptr ;
+
+    return not_nullptr(mlp) ? mlp->ring().pop(msg) : false ;
+}
+
+/**
+ * \return
+ *      Returns the number of messages waiting in an output port, or -1 if
+ *      there is no such port.
+ */
+
+int
+loopback_pending (int port)
+{
+    midi_loopback_info * mli = midi_loopback_info::instance();
+    midi_loopback * mlp = not_nullptr(mli) ?
+        mli->find_port(SEQ66_MIDI_OUTPUT_PORT, port) : nullptr ;
+
+    return not_nullptr(mlp) ? mlp->ring().count() : (-1) ;
+}
+
+/**
+ * \return
+ *      Returns the number of messages an output port dropped because the
+ *      reader did not keep up.
+ */
+
+unsigned
+loopback_dropped (int port)
+{
+    midi_loopback_info * mli = midi_loopback_info::instance();
+    midi_loopback * mlp = not_nullptr(mli) ?
+        mli->find_port(SEQ66_MIDI_OUTPUT_PORT, port) : nullptr ;
+
+    return not_nullptr(mlp) ? mlp->ring().dropped() : 0 ;
+}
+
+/**
+ *  Queues a message on an input port, for the input thread to read.  Must
+ *  be called from one thread only, in time order.
+ *
+ * \param port
+ *      The buss index of the input port.
+ *
+ * \param bytes
+ *      The status byte and data bytes.
+ *
+ * \param count
+ *      The number of bytes, 1 to 3.
+ *
+ * \param delay_us
+ *      The number of microseconds from now at which the message is due.
+ *
+ * \return
+ *      Returns false if there is no such port, the message is bad, or the
+ *      port is full.
+ */
+
+bool
+loopback_inject
+(
+    int port,
+    const midibyte * bytes,
+    int count,
+    long delay_us
+)
+{
+    bool result = not_nullptr(bytes) && count > 0 && count <= 3;
+    if (result)
+    {
+        midi_loopback_info * mli = midi_loopback_info::instance();
+        midi_loopback * mlp = not_nullptr(mli) ?
+            mli->find_port(SEQ66_MIDI_INPUT_PORT, port) : nullptr ;
+
+        result = not_nullptr(mlp);
+        if (result)
+        {
+            loopback_message msg;
+            msg.lm_timestamp = microtime() + delay_us;
+            msg.lm_count = count;
+            msg.lm_bytes[1] = msg.lm_bytes[2] = 0;
+            for (int i = 0; i < count; ++i)
+                msg.lm_bytes[i] = bytes[i];
+
+            result = mlp->ring().push(msg);
+        }
+    }
+    return result;
+}
+
+}           // namespace seq66
+
+/*
+ * midi_loopback.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,217 @@
+/**
+ * \file          midi_loopback_info.cpp
+ *
+ *    A class for enumerating the ports of the in-memory loopback MIDI API.
+ *
+ * \library       seq66 application
+ * \author        Chris Ahlstrom
+ * \date          2020-11-24
+ * \updates       2020-11-24
+ * \license       See the rtexmidi.lic file.  Too big.
+ *
+ *  The loopback "system" has one client, named "loopback", with the number
+ *  of input and output ports given by rc().loopback_inputs() and
+ *  rc().loopback_outputs().  The ports are listed as normal (not virtual)
+ *  ports, so that the mastermidibus creates a buss for each one, just as it
+ *  does for the ports found by ALSA.  With the --manual-ports option, the
+ *  usual virtual ports are created instead, and these are loopback ports,
+ *  too.
+ */
+
+#include "cfg/settings.hpp"             /* seq66::rc() configuration object */
+#include "midi/midibus_common.hpp"      /* from the libseq66 sub-project    */
+#include "midi_loopback.hpp"            /* seq66::midi_loopback             */
+#include "midi_loopback_info.hpp"       /* seq66::midi_loopback_info        */
+#include "util/basic_macros.hpp"        /* C++ version of easy macros       */
+
+/*
+ * Do not document the namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  The one loopback information object, for the free functions declared in
+ *  midi_loopback.hpp.  Only one mastermidibus exists at a time.
+ */
+
+static midi_loopback_info * s_loopback_info = nullptr;
+
+/**
+ *  Principal constructor.
+ *
+ * \param appname
+ *      Provides the name of the application.
+ *
+ * \param ppqn
+ *      Provides the desired value of the PPQN (pulses per quarter note).
+ *
+ * \param bpm
+ *      Provides the desired value of the BPM (beats per minute).
+ */
+
+midi_loopback_info::midi_loopback_info
+(
+    const std::string & appname,
+    int ppqn,
+    midibpm bpm
+) :
+    midi_info               (appname, ppqn, bpm),
+    m_loopback_ports        ()
+{
+    midi_handle(this);                  /* rtmidi_info requires a handle    */
+    s_loopback_info = this;
+}
+
+/**
+ *  Destructor.
+ */
+
+midi_loopback_info::~midi_loopback_info ()
+{
+    if (s_loopback_info == this)
+        s_loopback_info = nullptr;
+}
+
+/**
+ * \return
+ *      Returns the loopback information object, or a null pointer if the
+ *      loopback API is not in use.
+ */
+
+midi_loopback_info *
+midi_loopback_info::instance ()
+{
+    return s_loopback_info;
+}
+
+/**
+ *  Lists the configured loopback ports.
+ *
+ * \return
+ *      Returns the total number of input and output ports.
+ */
+
+int
+midi_loopback_info::get_all_port_info ()
+{
+    int client = 0;
+    std::string clientname = "loopback";
+    int inputs = rc().loopback_inputs();
+    int outputs = rc().loopback_outputs();
+    input_ports().clear();
+    output_ports().clear();
+    for (int i = 0; i < inputs; ++i)
+    {
+        std::string portname = "loopback in " + std::to_string(i);
+        input_ports().add
+        (
+            client, clientname, i, portname,
+            SEQ66_MIDI_NORMAL_PORT, SEQ66_MIDI_NORMAL_PORT,
+            SEQ66_MIDI_INPUT_PORT
+        );
+    }
+    for (int o = 0; o < outputs; ++o)
+    {
+        std::string portname = "loopback out " + std::to_string(o);
+        output_ports().add
+        (
+            client, clientname, o, portname,
+            SEQ66_MIDI_NORMAL_PORT, SEQ66_MIDI_NORMAL_PORT,
+            SEQ66_MIDI_OUTPUT_PORT
+        );
+    }
+    return inputs + outputs;
+}
+
+/**
+ *  Input is polled port by port, via midi_in_loopback.
+ */
+
+int
+midi_loopback_info::api_poll_for_midi ()
+{
+    return 0;
+}
+
+/**
+ *  Input is read port by port, via midi_in_loopback.
+ */
+
+bool
+midi_loopback_info::api_get_midi_event (event * /*inev*/)
+{
+    return false;
+}
+
+/**
+ *  Nothing to flush; messages are recorded as they are sent.
+ */
+
+void
+midi_loopback_info::api_flush ()
+{
+    // No code needed
+}
+
+/**
+ *  Registers a port.  Ports are added while the mastermidibus is set up,
+ *  before the input and output threads start.
+ */
+
+bool
+midi_loopback_info::add (midi_loopback & ml)
+{
+    m_loopback_ports.push_back(&ml);
+    return true;
+}
+
+/**
+ *  Unregisters a port that is being destroyed.
+ */
+
+void
+midi_loopback_info::remove (midi_loopback & ml)
+{
+    for (auto it = m_loopback_ports.begin(); it != m_loopback_ports.end(); ++it)
+    {
+        if (*it == &ml)
+        {
+            (void) m_loopback_ports.erase(it);
+            break;
+        }
+    }
+}
+
+/**
+ *  Looks up a port.
+ *
+ * \param input
+ *      True to look for an input port, false for an output port.
+ *
+ * \param index
+ *      The buss index of the port.
+ *
+ * \return
+ *      Returns the port, or a null pointer if there is no such port.
+ */
+
+midi_loopback *
+midi_loopback_info::find_port (bool input, int index)
+{
+    for (auto mlp : m_loopback_ports)
+    {
+        if (mlp->is_input_port() == input && mlp->bus_index() == index)
+            return mlp;
+    }
+    return nullptr;
+}
+
+}           // namespace seq66
+
+/*
+ * midi_loopback_info.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -7,7 +7,7 @@
  * \library       seq66 application
  * \author        Gary P. Scavone, 2003-2012; refactoring by Chris Ahlstrom
  * \date          2016-11-19
- * \updates       2020-07-06
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *  We include this test code in our library, rather than in a separate
@@ -53,6 +53,7 @@ midi_api_name (int i)
         s_api_map[RTMIDI_API_UNSPECIFIED] = "Unspecified";
         s_api_map[RTMIDI_API_LINUX_ALSA]  = "Linux ALSA";
         s_api_map[RTMIDI_API_UNIX_JACK]   = "Jack Client";
+        s_api_map[RTMIDI_API_LOOPBACK]    = "Loopback";
 
 #if defined USE_RTMIDI_API_ALL
 
@@ -6,7 +6,7 @@
  * \library       seq66 application
  * \author        Gary P. Scavone; refactoring by Chris Ahlstrom
  * \date          2016-11-14
- * \updates       2020-04-08
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *  An abstract base class for realtime MIDI input/output.
@@ -26,6 +26,8 @@
 #include "rtmidi_info.hpp"              /* seq66::rtmidi_info, etc.         */
 #include "util/basic_macros.hpp"        /* C++ version of easy macros       */
 
+#include "midi_loopback.hpp"            /* seq66::midi_loopback, etc.       */
+
 #if defined SEQ66_BUILD_UNIX_JACK
 #include "midi_jack.hpp"
 #endif
@@ -235,6 +237,15 @@ rtmidi_in::openmidi_api (rtmidi_api api, rtmidi_info & info)
                 set_api(miap);
 #endif
         }
+        else if (api == RTMIDI_API_LOOPBACK)
+        {
+            midi_in_loopback * milp = new (std::nothrow) midi_in_loopback
+            (
+                parent_bus(), midiinfo
+            );
+            if (not_nullptr(milp))
+                set_api(milp);
+        }
     }
 }
 
@@ -409,6 +420,18 @@ rtmidi_out::openmidi_api (rtmidi_api api, rtmidi_info & info)
             }
 #endif
         }
+        else if (api == RTMIDI_API_LOOPBACK)
+        {
+            midi_out_loopback * molp = new (std::nothrow) midi_out_loopback
+            (
+                parent_bus(), midiinfo
+            );
+            if (not_nullptr(molp))
+            {
+                set_api(molp);
+                got_an_api = true;
+            }
+        }
     }
     if (! got_an_api)
     {
@@ -6,7 +6,7 @@
  * \library       seq66 application
  * \author        Chris Ahlstrom
  * \date          2016-12-08
- * \updates       2020-04-08
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *  An abstract base class for realtime MIDI input/output.  This class
@@ -20,6 +20,8 @@
 #include "seq66_rtmidi_features.h"      /* selects the usable APIs          */
 #include "util/basic_macros.hpp"        /* C++ version of easy macros       */
 
+#include "midi_loopback_info.hpp"       /* seq66::midi_loopback_info        */
+
 #if defined SEQ66_BUILD_LINUX_ALSA
 #include "midi_alsa_info.hpp"
 #endif
@@ -67,6 +69,11 @@ void
 rtmidi_info::get_compiled_api (std::vector<rtmidi_api> & apis)
 {
     apis.clear();
+    if (rc().with_loopback_midi())
+    {
+        apis.push_back(RTMIDI_API_LOOPBACK);    /* no system API needed     */
+        return;
+    }
 
     /*
      * The order here will control the order of rtmidi's API search in the
@@ -239,6 +246,17 @@ rtmidi_info::openmidi_api
     }
 #endif
 
+    if (api == RTMIDI_API_LOOPBACK)
+    {
+        midi_loopback_info * mlip = new (std::nothrow) midi_loopback_info
+        (
+            appname, ppqn, bpm
+        );
+        result = not_nullptr(mlip);
+        if (result)
+            result = set_api_info(mlip);
+    }
+
 #if defined SEQ66_BUILD_LINUX_ALSA
     if (api == RTMIDI_API_LINUX_ALSA)
     {
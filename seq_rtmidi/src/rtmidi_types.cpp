@@ -6,13 +6,15 @@
  * \library       seq66 application
  * \author        Gary P. Scavone; severe refactoring by Chris Ahlstrom
  * \date          2016-12-01
- * \updates       2019-02-10
+ * \updates       2020-11-24
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *  Provides some basic types for the (heavily-factored) rtmidi library, very
  *  loosely based on Gary Scavone's RtMidi library.
  */
 
+#include <cstring>                      /* std::memcpy()                    */
+
 #include "rtmidi_types.hpp"             /* seq66::rtmidi, etc.              */
 #include "util/basic_macros.hpp"        /* errprintfunc() macro, etc.       */
 
@@ -67,17 +69,35 @@ midi_message::show () const
  * class midi_queue
  */
 
+/**
+ *  Rounds a size up to the next power of 2.  A size of 0 stays 0.
+ */
+
+static unsigned
+power_of_2 (unsigned n)
+{
+    unsigned result = n > 0 ? 1 : 0 ;
+    while (result > 0 && result < n)
+        result <<= 1;
+
+    return result;
+}
+
 /**
  *  Default constructor.
  */
 
 midi_queue::midi_queue ()
  :
-    m_front     (0),
-    m_back      (0),
-    m_size      (0),
-    m_ring_size (0),
-    m_ring      (nullptr)
+    m_front         (0),
+    m_back          (0),
+    m_ring_size     (0),
+    m_ring          (nullptr),
+    m_spill_front   (0),
+    m_spill_back    (0),
+    m_spill_size    (0),
+    m_spill         (nullptr),
+    m_dropped       (0)
 {
     allocate();
 }
@@ -92,25 +112,44 @@ midi_queue::~midi_queue ()
 }
 
 /**
+ *  Allocates the records and the spill area.  This is the only allocation
+ *  done by the queue.
  *
  *  This would be better off as a constructor operation.  But one step at a
  *  time.
+ *
+ *  Both sizes are rounded up to a power of 2, so that the counters, which
+ *  wrap around at 2^32, always map to the same place in the rings.
+ *
+ * \param queuesize
+ *      The number of records in the ring.
+ *
+ * \param spillsize
+ *      The number of bytes in the spill area.  It limits the size of a SysEx
+ *      message.
  */
 
 void
-midi_queue::allocate (unsigned queuesize)
+midi_queue::allocate (unsigned queuesize, unsigned spillsize)
 {
     deallocate();
-    if (queuesize > 0 && is_nullptr(m_ring))
+    queuesize = power_of_2(queuesize);
+    spillsize = power_of_2(spillsize);
+    if (queuesize > 0)
     {
-        m_ring = new(std::nothrow) midi_message[queuesize];
+        m_ring = new(std::nothrow) midi_record[queuesize];
         if (not_nullptr(m_ring))
             m_ring_size = queuesize;
     }
+    if (spillsize > 0)
+    {
+        m_spill = new(std::nothrow) midibyte[spillsize];
+        if (not_nullptr(m_spill))
+            m_spill_size = spillsize;
+    }
 }
 
 /**
- *
  *  This would be better off as a destructor operation.  But one step at a
  *  time.
  */
@@ -123,38 +162,109 @@ midi_queue::deallocate ()
         delete [] m_ring;
         m_ring = nullptr;
     }
+    if (not_nullptr(m_spill))
+    {
+        delete [] m_spill;
+        m_spill = nullptr;
+    }
+    m_front = m_back = 0;
+    m_spill_front = m_spill_back = 0;
+    m_ring_size = m_spill_size = 0;
 }
 
 /**
+ *  As long as we haven't reached our queue size limit, copy the message into
+ *  the next record.  A message too long for the record goes into the spill
+ *  area.  It must be contiguous there, so if it does not fit before the end
+ *  of the area, the end is skipped and the message starts at offset 0.  No
+ *  allocation or locking is done, so this function can be called from a
+ *  real-time callback.
+ *
+ * \param mbytes
+ *      The bytes of the message.
  *
- *  As long as we haven't reached our queue size limit, push the message.
+ * \param count
+ *      The number of bytes.  Must be greater than 0.
+ *
+ * \param timestamp
+ *      The timestamp to store with the message.
+ *
+ * \return
+ *      Returns false if the queue or the spill area is full, in which case
+ *      the message is dropped and counted; see take_dropped().
  */
 
 bool
-midi_queue::add (const midi_message & mmsg)
+midi_queue::add (const midibyte * mbytes, int count, double timestamp)
 {
-    bool result = ! full();
-    if (result)
-    {
-        m_ring[m_back++] = mmsg;
-        if (m_back == m_ring_size)
-            m_back = 0;
+    unsigned back = m_back.load(std::memory_order_relaxed);
+    bool result = count > 0 && m_ring_size > 0 &&
+        back - m_front.load(std::memory_order_acquire) < m_ring_size;
 
-        ++m_size;
-    }
-    else
+    if (result)
     {
-        errprintfunc("message queue limit reached");
+        midi_record & mr = m_ring[back % m_ring_size];
+        unsigned ucount = unsigned(count);
+        mr.mr_timestamp = timestamp;
+        mr.mr_count = ucount;
+        if (ucount > SEQ66_MIDI_RECORD_BYTES)
+        {
+            unsigned start = m_spill_back;
+            unsigned offset = m_spill_size > 0 ? start % m_spill_size : 0 ;
+            if (offset + ucount > m_spill_size)
+            {
+                start += m_spill_size - offset;     /* skip end of area     */
+                offset = 0;
+            }
+            unsigned front = m_spill_front.load(std::memory_order_acquire);
+            result = (start + ucount) - front <= m_spill_size;
+            if (result)
+            {
+                std::memcpy(&m_spill[offset], mbytes, ucount);
+                mr.mr_spill = offset;
+                m_spill_back = mr.mr_spill_end = start + ucount;
+            }
+        }
+        else
+        {
+            std::memcpy(&mr.mr_bytes[0], mbytes, ucount);
+            mr.mr_spill = 0;
+            mr.mr_spill_end = m_spill_back;
+        }
+        if (result)
+            m_back.store(back + 1, std::memory_order_release);  /* publish */
     }
+    if (! result)
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+
     return result;
 }
 
+/**
+ *  Adds a copy of the bytes and timestamp of a midi_message.
+ *
+ * \param mmsg
+ *      The message to add.
+ *
+ * \return
+ *      Returns false if the message could not be added.
+ */
+
+bool
+midi_queue::add (const midi_message & mmsg)
+{
+    return add(mmsg.data(), mmsg.count(), mmsg.timestamp());
+}
+
 /**
  *  Pops, so to speak, the front message out of the queue, effectively
- *  throwing it away.  One useful call sequence is:
+ *  throwing it away, and frees its part of the spill area.  One useful call
+ *  sequence is:
  *
 \verbatim
-    midi_message latest = queue.front();
+    const midi_record & mr = queue.front();
+    const midibyte * mbytes = queue.bytes(mr);
+    ...                             // use mbytes[0] to mbytes[mr.mr_count-1]
     queue.pop();
 \endverbatim
  *
@@ -164,17 +274,18 @@ midi_queue::add (const midi_message & mmsg)
 void
 midi_queue::pop ()
 {
-    --m_size;
-    ++m_front;
-    if (m_front == m_ring_size)
-        m_front = 0;
+    unsigned front = m_front.load(std::memory_order_relaxed);
+    if (front != m_back.load(std::memory_order_acquire))
+    {
+        const midi_record & mr = m_ring[front % m_ring_size];
+        m_spill_front.store(mr.mr_spill_end, std::memory_order_release);
+        m_front.store(front + 1, std::memory_order_release);
+    }
 }
 
 /**
- *  Pops a copy of the front message.   Could be a little inefficient, since a
- *  couple of copies are made, and we cannot use return-code optimization.
- *
- *  Perhaps at some point we could use move semantics?
+ *  Pops a copy of the front message.   This allocates, so it should not be
+ *  used in a real-time thread.
  *
  * \return
  *      Returns a copy of the message that was in front before the popping.
@@ -186,9 +297,14 @@ midi_message
 midi_queue::pop_front ()
 {
     midi_message result;
-    if (m_size != 0)
+    if (! empty())
     {
-        result = m_ring[m_front];
+        const midi_record & mr = front();
+        const midibyte * mbytes = bytes(mr);
+        for (unsigned i = 0; i < mr.mr_count; ++i)
+            result.push(mbytes[i]);
+
+        result.timestamp(mr.mr_timestamp);
         pop();
     }
     return result;